@@ -363,12 +363,13 @@ private:
 class VulkanCommandBuffer
 {
 public:
-	VulkanCommandBuffer(VulkanCommandPool *pool);
+	VulkanCommandBuffer(VulkanCommandPool *pool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 	~VulkanCommandBuffer();
 
 	void SetDebugName(const char *name);
 
 	void begin();
+	void begin(const VkCommandBufferInheritanceInfo* inheritanceInfo, VkCommandBufferUsageFlags flags);
 	void end();
 
 	void bindPipeline(VkPipelineBindPoint pipelineBindPoint, VulkanPipeline *pipeline);
@@ -449,7 +450,7 @@ public:
 
 	void SetDebugName(const char *name) { device->SetObjectName(name, (uint64_t)pool, VK_OBJECT_TYPE_COMMAND_POOL); }
 
-	std::unique_ptr<VulkanCommandBuffer> createBuffer();
+	std::unique_ptr<VulkanCommandBuffer> createBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
 	VkCommandPool pool = VK_NULL_HANDLE;
 
@@ -533,9 +534,9 @@ inline VulkanCommandPool::~VulkanCommandPool()
 	vkDestroyCommandPool(device->device, pool, nullptr);
 }
 
-inline std::unique_ptr<VulkanCommandBuffer> VulkanCommandPool::createBuffer()
+inline std::unique_ptr<VulkanCommandBuffer> VulkanCommandPool::createBuffer(VkCommandBufferLevel level)
 {
-	return std::make_unique<VulkanCommandBuffer>(this);
+	return std::make_unique<VulkanCommandBuffer>(this, level);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -618,11 +619,11 @@ inline void RenderPassBegin::Execute(VulkanCommandBuffer* cmdbuffer, VkSubpassCo
 
 /////////////////////////////////////////////////////////////////////////////
 
-inline VulkanCommandBuffer::VulkanCommandBuffer(VulkanCommandPool *pool) : pool(pool)
+inline VulkanCommandBuffer::VulkanCommandBuffer(VulkanCommandPool *pool, VkCommandBufferLevel level) : pool(pool)
 {
 	VkCommandBufferAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.level = level;
 	allocInfo.commandPool = pool->pool;
 	allocInfo.commandBufferCount = 1;
 
@@ -646,6 +647,17 @@ inline void VulkanCommandBuffer::begin()
 	CheckVulkanError(result, "Could not begin recording command buffer");
 }
 
+inline void VulkanCommandBuffer::begin(const VkCommandBufferInheritanceInfo* inheritanceInfo, VkCommandBufferUsageFlags flags)
+{
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = flags;
+	beginInfo.pInheritanceInfo = inheritanceInfo;
+
+	VkResult result = vkBeginCommandBuffer(buffer, &beginInfo);
+	CheckVulkanError(result, "Could not begin recording command buffer");
+}
+
 inline void VulkanCommandBuffer::end()
 {
 	VkResult result = vkEndCommandBuffer(buffer);
@@ -222,6 +222,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(DShape2D, PushTriangle, Shape2D_PushTriangle)
 int F2DDrawer::AddCommand(RenderCommand *data) 
 {
 	data->mScreenFade = screenFade;
+	mRequestedCount++;
 	if (mData.Size() > 0 && data->isCompatible(mData.Last()))
 	{
 		// Merge with the last command.
@@ -1069,6 +1070,52 @@ void F2DDrawer::AddLine(const DVector2& v1, const DVector2& v2, const IntRect* c
 	AddCommand(&dg);
 }
 
+//==========================================================================
+//
+// Draws indexed lines from a vertex buffer that persists across frames.
+// The data only gets uploaded when the owner sets needsVertexUpload,
+// all positioning is done by the transform.
+//
+//==========================================================================
+
+void F2DDrawer::AddLineBuffer(RefCountedPtr<DShape2DBufferInfo>& bufinfo, TArray<TwoDVertex>& vertices, TArray<int>& indices, const DMatrix3x3& transform, const IntRect* clip)
+{
+	if (indices.Size() == 0) return;
+
+	RenderCommand dg;
+
+	if (clip != nullptr)
+	{
+		dg.mScissor[0] = clip->Left() + int(offset.X);
+		dg.mScissor[1] = clip->Top() + int(offset.Y);
+		dg.mScissor[2] = clip->Right() + int(offset.X);
+		dg.mScissor[3] = clip->Bottom() + int(offset.Y);
+		dg.mFlags |= DTF_Scissor;
+	}
+
+	dg.mType = DrawTypeLines;
+	dg.mRenderStyle = LegacyRenderStyles[STYLE_Translucent];
+	dg.mVertCount = vertices.Size();
+	dg.useTransform = true;
+	dg.transform = this->transform * transform;
+	dg.transform.Cells[0][2] += offset.X;
+	dg.transform.Cells[1][2] += offset.Y;
+	dg.shape2DBufInfo = bufinfo;
+	dg.shape2DIndexCount = indices.Size();
+	if (bufinfo->needsVertexUpload)
+	{
+		bufinfo->bufIndex += 1;
+		bufinfo->buffers.Reserve(1);
+		bufinfo->buffers[bufinfo->bufIndex].UploadData(vertices.Data(), vertices.Size(), indices.Data(), indices.Size());
+		bufinfo->needsVertexUpload = false;
+		bufinfo->uploadedOnce = true;
+	}
+	dg.shape2DBufIndex = bufinfo->bufIndex;
+	bufinfo->lastCommand += 1;
+	dg.shape2DCommandCounter = bufinfo->lastCommand;
+	AddCommand(&dg);
+}
+
 //==========================================================================
 //
 //
@@ -1198,6 +1245,7 @@ void F2DDrawer::Clear()
 		mVertices.Clear();
 		mIndices.Clear();
 		mData.Clear();
+		mRequestedCount = 0;
 		mIsFirstPass = true;
 	}
 	screenFade = 1.f;
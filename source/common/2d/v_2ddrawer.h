@@ -191,6 +191,7 @@ public:
 	TArray<int> mIndices;
 	TArray<TwoDVertex> mVertices;
 	TArray<RenderCommand> mData;
+	int mRequestedCount = 0;	// number of commands before merging, for the draw2d stat
 	int Width, Height;
 	bool isIn2D;
 	bool locked = false;	// prevents clearing of the data so it can be reused multiple times (useful for screen fades)
@@ -229,6 +230,7 @@ public:
 
 	void AddLine(const DVector2& v1, const DVector2& v2, const IntRect* clip, uint32_t color, uint8_t alpha = 255);
 	void AddThickLine(const DVector2& v1, const DVector2& v2, double thickness, uint32_t color, uint8_t alpha = 255);
+	void AddLineBuffer(RefCountedPtr<DShape2DBufferInfo>& bufinfo, TArray<TwoDVertex>& vertices, TArray<int>& indices, const DMatrix3x3& transform, const IntRect* clip);
 	void AddPixel(int x1, int y1, uint32_t color);
 
 	void AddEnableStencil(bool on);
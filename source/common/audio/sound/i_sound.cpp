@@ -36,6 +36,7 @@
 #include <stdlib.h>
 
 #include "oalsound.h"
+#include "softsound.h"
 
 #include "i_module.h"
 #include "cmdlib.h"
@@ -265,6 +266,10 @@ void I_InitSound ()
 	{
 		GSnd = new NullSoundRenderer;
 	}
+	else if (stricmp(snd_backend, "software") == 0)
+	{
+		GSnd = new SoftSoundRenderer;
+	}
 	else
 	{
 		#ifndef NO_OPENAL
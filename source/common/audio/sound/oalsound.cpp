@@ -43,6 +43,7 @@
 #include "i_module.h"
 #include "cmdlib.h"
 #include "m_fixed.h"
+#include "tracing.h"
 
 
 const char *GetSampleTypeName(SampleType type);
@@ -918,6 +919,7 @@ OpenALSoundRenderer::~OpenALSoundRenderer()
 
 void OpenALSoundRenderer::BackgroundProc()
 {
+	Trace::SetThreadName("Sound stream thread");
 	std::unique_lock<std::mutex> lock(StreamLock);
 	while(!QuitThread.load())
 	{
@@ -929,6 +931,7 @@ void OpenALSoundRenderer::BackgroundProc()
 		else
 		{
 			// Else, process all active streams and sleep for 100ms
+			TRACE_ZONE("StreamProcess");
 			for(size_t i = 0;i < Streams.Size();i++)
 				Streams[i]->Process();
 			StreamWake.wait_for(lock, std::chrono::milliseconds(100));
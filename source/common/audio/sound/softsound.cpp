@@ -0,0 +1,1100 @@
+/*
+** softsound.cpp
+**
+** Software mixing sound renderer for headless operation.
+** Output goes to a WAV or raw PCM file instead of a sound device.
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** All sample data is converted to float on load. Playback positions are
+** kept in 32.32 fixed point so that resampling does not depend on the
+** floating point state, and with snd_swmixsamples set the mixer advances
+** by a fixed amount per update, making the output fully deterministic.
+**
+*/
+
+#include <chrono>
+
+#include "softsound.h"
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "v_text.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "i_time.h"
+#include "m_fixed.h"
+#include "printf.h"
+#include "tracing.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__i386__) || defined(__amd64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <emmintrin.h>
+#define SOFTSOUND_SSE2
+#endif
+
+const char *GetSampleTypeName(SampleType type);
+const char *GetChannelConfigName(ChannelConfig chan);
+
+EXTERN_CVAR(Int, snd_channels)
+EXTERN_CVAR(Int, snd_samplerate)
+
+CVAR(String, snd_swoutput, "", CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// file name for the mixed output. Empty means discard.
+CUSTOM_CVAR(Int, snd_swmixsamples, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// if > 0, mix exactly this many samples per update instead of following the wall clock.
+{
+	if (self < 0) self = 0;
+}
+
+enum
+{
+	MAX_MIX_FRAMES = 1024,	// mix in chunks of this size.
+	FRACBITS_SND = 32,
+};
+
+static const float HEAD_RELATIVE_DIST = 0.0004f;
+
+//==========================================================================
+//
+// Sample data, always float, 1 or 2 channels, interleaved.
+//
+//==========================================================================
+
+struct SoftSoundBuffer
+{
+	TArray<float> Samples;
+	int Channels;
+	int Frames;
+	int SampleRate;
+	int LoopStart;
+	int LoopEnd;
+};
+
+//==========================================================================
+//
+// A playing sound effect
+//
+//==========================================================================
+
+struct SoftVoice
+{
+	SoftSoundBuffer *Buffer;
+	FISoundChannel *Chan;	// may be null for the benchmark.
+	uint64_t Pos;			// 32.32 fixed point in source frames
+	uint64_t Step;
+	float Volume;
+	float Pitch;
+	float GainL, GainR;
+	int ChanFlags;
+	bool Is3D;
+	bool AreaSound;
+	bool Finished;
+	FVector3 Position;
+	FRolloffInfo Rolloff;
+	float DistanceScale;
+};
+
+//==========================================================================
+//
+// Sample conversion helpers
+//
+//==========================================================================
+
+static void ConvertSamples(float *dest, const uint8_t *src, int count, int bits)
+{
+	if (bits == 8)
+	{
+		for (int i = 0; i < count; i++) dest[i] = (src[i] - 128) * (1.f / 128.f);
+	}
+	else if (bits == -8)
+	{
+		for (int i = 0; i < count; i++) dest[i] = int8_t(src[i]) * (1.f / 128.f);
+	}
+	else
+	{
+		auto src16 = (const int16_t*)src;
+		for (int i = 0; i < count; i++) dest[i] = src16[i] * (1.f / 32768.f);
+	}
+}
+
+static inline float GetRolloff(const FRolloffInfo *rolloff, float distance)
+{
+	return soundEngine ? soundEngine->GetRolloff(rolloff, distance) : 1.f;
+}
+
+//==========================================================================
+//
+// Resamplers. Linear interpolation, mixing into an interleaved stereo
+// float buffer. The caller guarantees that 'frame + 1' stays inside
+// the sample data for all 'count' output frames.
+//
+//==========================================================================
+
+static void ResampleMono(float *out, const float *src, uint64_t &pos, uint64_t step, int count, float gl, float gr)
+{
+	int i = 0;
+#ifdef SOFTSOUND_SSE2
+	const __m128 vgl = _mm_set1_ps(gl);
+	const __m128 vgr = _mm_set1_ps(gr);
+	const __m128 fracscale = _mm_set1_ps(1.f / 4294967296.f);
+	for (; i + 4 <= count; i += 4)
+	{
+		uint64_t p0 = pos, p1 = p0 + step, p2 = p1 + step, p3 = p2 + step;
+		pos = p3 + step;
+		const float *s0 = src + (p0 >> FRACBITS_SND), *s1 = src + (p1 >> FRACBITS_SND);
+		const float *s2 = src + (p2 >> FRACBITS_SND), *s3 = src + (p3 >> FRACBITS_SND);
+		__m128 a = _mm_set_ps(s3[0], s2[0], s1[0], s0[0]);
+		__m128 b = _mm_set_ps(s3[1], s2[1], s1[1], s0[1]);
+		// the fractions are reduced to 31 bits so that they survive the signed conversion.
+		__m128i fi = _mm_set_epi32(int((p3 >> 1) & 0x7fffffff), int((p2 >> 1) & 0x7fffffff), int((p1 >> 1) & 0x7fffffff), int((p0 >> 1) & 0x7fffffff));
+		__m128 frac = _mm_mul_ps(_mm_cvtepi32_ps(fi), _mm_add_ps(fracscale, fracscale));
+		__m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac));
+		__m128 l = _mm_mul_ps(s, vgl);
+		__m128 r = _mm_mul_ps(s, vgr);
+		_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_unpacklo_ps(l, r)));
+		_mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(out + i * 2 + 4), _mm_unpackhi_ps(l, r)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const float *s = src + (pos >> FRACBITS_SND);
+		float frac = float(int((pos >> 1) & 0x7fffffff)) * (2.f / 4294967296.f);
+		float v = s[0] + (s[1] - s[0]) * frac;
+		out[i * 2] += v * gl;
+		out[i * 2 + 1] += v * gr;
+		pos += step;
+	}
+}
+
+static void ResampleStereo(float *out, const float *src, uint64_t &pos, uint64_t step, int count, float gl, float gr)
+{
+	int i = 0;
+#ifdef SOFTSOUND_SSE2
+	const __m128 gains = _mm_set_ps(gr, gl, gr, gl);
+	for (; i + 2 <= count; i += 2)
+	{
+		uint64_t p0 = pos, p1 = p0 + step;
+		pos = p1 + step;
+		const float *s0 = src + (p0 >> FRACBITS_SND) * 2, *s1 = src + (p1 >> FRACBITS_SND) * 2;
+		float f0 = float(int((p0 >> 1) & 0x7fffffff)) * (2.f / 4294967296.f);
+		float f1 = float(int((p1 >> 1) & 0x7fffffff)) * (2.f / 4294967296.f);
+		__m128 a = _mm_set_ps(s1[1], s1[0], s0[1], s0[0]);
+		__m128 b = _mm_set_ps(s1[3], s1[2], s0[3], s0[2]);
+		__m128 frac = _mm_set_ps(f1, f1, f0, f0);
+		__m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac));
+		_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_mul_ps(s, gains)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const float *s = src + (pos >> FRACBITS_SND) * 2;
+		float frac = float(int((pos >> 1) & 0x7fffffff)) * (2.f / 4294967296.f);
+		out[i * 2] += (s[0] + (s[2] - s[0]) * frac) * gl;
+		out[i * 2 + 1] += (s[1] + (s[3] - s[1]) * frac) * gr;
+		pos += step;
+	}
+}
+
+//==========================================================================
+//
+// Mixes one voice. Handles looping and the end of the sample data.
+//
+//==========================================================================
+
+static void MixVoice(float *out, SoftVoice *voice, int frames)
+{
+	auto buffer = voice->Buffer;
+	const bool looping = (voice->ChanFlags & SNDF_LOOP) && buffer->LoopEnd > buffer->LoopStart;
+	const int end = looping ? buffer->LoopEnd : buffer->Frames;
+	const int chans = buffer->Channels;
+	const float *src = buffer->Samples.Data();
+
+	while (frames > 0)
+	{
+		int frame = int(voice->Pos >> FRACBITS_SND);
+		if (frame >= end)
+		{
+			if (!looping)
+			{
+				voice->Finished = true;
+				return;
+			}
+			voice->Pos -= uint64_t(end - buffer->LoopStart) << FRACBITS_SND;
+			continue;
+		}
+
+		// Number of output frames that can be interpolated without touching the last frame of the segment.
+		int safe = 0;
+		uint64_t last = uint64_t(end - 1) << FRACBITS_SND;
+		if (voice->Pos < last)
+		{
+			uint64_t n = (last - voice->Pos - 1) / voice->Step + 1;
+			safe = n > (uint64_t)frames ? frames : (int)n;
+		}
+
+		if (safe > 0)
+		{
+			if (chans == 1) ResampleMono(out, src, voice->Pos, voice->Step, safe, voice->GainL, voice->GainR);
+			else ResampleStereo(out, src, voice->Pos, voice->Step, safe, voice->GainL, voice->GainR);
+			out += safe * 2;
+			frames -= safe;
+		}
+		else
+		{
+			// The last frame interpolates towards the loop start or silence.
+			int next = looping ? buffer->LoopStart : -1;
+			float frac = float(int((voice->Pos >> 1) & 0x7fffffff)) * (2.f / 4294967296.f);
+			for (int c = 0; c < 2; c++)
+			{
+				int sc = chans == 1 ? 0 : c;
+				float a = src[frame * chans + sc];
+				float b = next >= 0 ? src[next * chans + sc] : 0.f;
+				out[c] += (a + (b - a) * frac) * (c == 0 ? voice->GainL : voice->GainR);
+			}
+			voice->Pos += voice->Step;
+			out += 2;
+			frames--;
+		}
+	}
+}
+
+//==========================================================================
+//
+// Streams are pulled from their callback while mixing.
+//
+//==========================================================================
+
+class SoftSoundStream : public SoundStream
+{
+	SoftSoundRenderer *Renderer;
+	SoundStreamCallback Callback;
+	void *UserData;
+	int Flags;
+	int SampleRate;
+	int FrameSize;
+	bool Playing = false;
+	bool Paused = false;
+	bool Ended = false;
+	float Volume = 1.f;
+	uint64_t Pos = 0;	// 32.32 fixed point into Source
+	uint64_t Step;
+	uint64_t SamplesPlayed = 0;
+	TArray<float> Source;	// stereo
+	TArray<uint8_t> ReadBuffer;
+
+public:
+	SoftSoundStream(SoftSoundRenderer *renderer, SoundStreamCallback callback, int flags, int samplerate, void *userdata)
+		: Renderer(renderer), Callback(callback), UserData(userdata), Flags(flags), SampleRate(samplerate)
+	{
+		FrameSize = ((flags & Bits8) ? 1 : (flags & Float) ? 4 : 2) * ((flags & Mono) ? 1 : 2);
+		Step = (uint64_t)((double)samplerate / renderer->OutputRate * 4294967296.);
+		Renderer->Streams.Push(this);
+	}
+
+	~SoftSoundStream()
+	{
+		Renderer->Streams.Delete(Renderer->Streams.Find(this));
+	}
+
+	bool Play(bool looping, float volume) override
+	{
+		Volume = volume;
+		Playing = true;
+		Ended = false;
+		return true;
+	}
+
+	void Stop() override
+	{
+		Playing = false;
+		Source.Clear();
+		Pos = 0;
+	}
+
+	void SetVolume(float volume) override
+	{
+		Volume = volume;
+	}
+
+	bool SetPaused(bool paused) override
+	{
+		Paused = paused;
+		return true;
+	}
+
+	bool IsEnded() override
+	{
+		return Ended;
+	}
+
+	Position GetPlayPosition() override
+	{
+		return { SamplesPlayed, std::chrono::nanoseconds(0) };
+	}
+
+	FString GetStats() override
+	{
+		FString stats;
+		stats.Format("Software stream, %d Hz, %s%s", SampleRate, Ended ? "ended" : Playing ? "playing" : "stopped", Paused ? ", paused" : "");
+		return stats;
+	}
+
+	// Reads more data from the callback, converted to stereo float.
+	bool Fill(int needed)
+	{
+		int have = Source.Size() / 2;
+		if (have >= needed) return true;
+		int count = needed - have;
+		ReadBuffer.Resize(count * FrameSize);
+		if (Ended || !Callback(this, ReadBuffer.Data(), count * FrameSize, UserData))
+		{
+			Ended = true;
+			memset(ReadBuffer.Data(), (Flags & Bits8) ? 0x80 : 0, count * FrameSize);
+		}
+		int chans = (Flags & Mono) ? 1 : 2;
+		TArray<float> conv(count * chans, true);
+		if (Flags & Float) memcpy(conv.Data(), ReadBuffer.Data(), count * chans * sizeof(float));
+		else ConvertSamples(conv.Data(), ReadBuffer.Data(), count * chans, (Flags & Bits8) ? 8 : 16);
+		Source.Resize((have + count) * 2);
+		float *dest = &Source[have * 2];
+		for (int i = 0; i < count; i++)
+		{
+			dest[i * 2] = conv[i * chans];
+			dest[i * 2 + 1] = conv[i * chans + chans - 1];
+		}
+		return !Ended;
+	}
+
+	void Mix(float *out, int frames, float mastervolume)
+	{
+		if (!Playing || Paused || Ended) return;
+		int needed = int((Pos + Step * frames) >> FRACBITS_SND) + 2;
+		Fill(needed);
+		float gain = Volume * mastervolume;
+		ResampleStereo(out, Source.Data(), Pos, Step, frames, gain, gain);
+		int consumed = int(Pos >> FRACBITS_SND);
+		if (consumed > 0)
+		{
+			Source.Delete(0, consumed * 2);
+			Pos -= uint64_t(consumed) << FRACBITS_SND;
+			SamplesPlayed += consumed;
+		}
+	}
+};
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+SoftSoundRenderer::SoftSoundRenderer(bool benchmark)
+{
+	Benchmark = benchmark;
+	OutputRate = snd_samplerate > 0 ? *snd_samplerate : 44100;
+	MixBuffer.Resize(MAX_MIX_FRAMES * 2);
+	OutBuffer.Resize(MAX_MIX_FRAMES * 2);
+	StartTimeNS = I_nsTime();
+	if (!Benchmark) OpenOutput();
+}
+
+SoftSoundRenderer::~SoftSoundRenderer()
+{
+	// By now all sounds have been unloaded through the sound engine, so anything left is a benchmark voice.
+	for (auto voice : Voices) delete voice;
+	for (auto voice : FreeVoices) delete voice;
+	// Streams are owned by the music code which must have deleted them by now.
+	CloseOutput();
+}
+
+//==========================================================================
+//
+// Output file handling
+//
+//==========================================================================
+
+static void WriteWavHeader(FileWriter *fw, uint32_t datasize, int rate)
+{
+	uint8_t header[44];
+	memcpy(header, "RIFF", 4);
+	uint32_t riffsize = datasize + 36;
+	header[4] = riffsize & 255; header[5] = (riffsize >> 8) & 255; header[6] = (riffsize >> 16) & 255; header[7] = riffsize >> 24;
+	memcpy(header + 8, "WAVEfmt ", 8);
+	header[16] = 16; header[17] = header[18] = header[19] = 0;
+	header[20] = 1; header[21] = 0;		// PCM
+	header[22] = 2; header[23] = 0;		// channels
+	header[24] = rate & 255; header[25] = (rate >> 8) & 255; header[26] = (rate >> 16) & 255; header[27] = rate >> 24;
+	uint32_t byterate = rate * 4;
+	header[28] = byterate & 255; header[29] = (byterate >> 8) & 255; header[30] = (byterate >> 16) & 255; header[31] = byterate >> 24;
+	header[32] = 4; header[33] = 0;		// block align
+	header[34] = 16; header[35] = 0;	// bits
+	memcpy(header + 36, "data", 4);
+	header[40] = datasize & 255; header[41] = (datasize >> 8) & 255; header[42] = (datasize >> 16) & 255; header[43] = datasize >> 24;
+	fw->Write(header, 44);
+}
+
+void SoftSoundRenderer::OpenOutput()
+{
+	const char *filename = snd_swoutput;
+	if (*filename == 0) return;
+	Output = FileWriter::Open(filename);
+	if (Output == nullptr)
+	{
+		Printf(TEXTCOLOR_RED "Unable to open sound output file %s\n", filename);
+		return;
+	}
+	FString name = filename;
+	OutputIsWav = name.Len() > 4 && !name.Right(4).CompareNoCase(".wav");
+	if (OutputIsWav) WriteWavHeader(Output, 0, OutputRate);
+}
+
+void SoftSoundRenderer::CloseOutput()
+{
+	if (Output == nullptr) return;
+	if (OutputIsWav)
+	{
+		Output->Seek(0, SEEK_SET);
+		WriteWavHeader(Output, uint32_t(OutputFrames * 4), OutputRate);
+	}
+	delete Output;
+	Output = nullptr;
+}
+
+void SoftSoundRenderer::WriteOutput(const float *mixbuffer, int frames)
+{
+	int count = frames * 2;
+	int i = 0;
+#ifdef SOFTSOUND_SSE2
+	const __m128 scale = _mm_set1_ps(32767.f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mixbuffer + i), scale));
+		__m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(mixbuffer + i + 4), scale));
+		_mm_storeu_si128((__m128i*)&OutBuffer[i], _mm_packs_epi32(a, b));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		OutBuffer[i] = (int16_t)clamp<long>(lrintf(mixbuffer[i] * 32767.f), -32768, 32767);
+	}
+	Output->Write(OutBuffer.Data(), count * sizeof(int16_t));
+	OutputFrames += frames;
+}
+
+//==========================================================================
+//
+// Mixer
+//
+//==========================================================================
+
+void SoftSoundRenderer::Mix(int frames)
+{
+	TRACE_ZONE("SoftMix");
+	MixTime.Reset();
+	MixTime.Clock();
+	LastMixFrames = frames;
+	LastMixVoiceFrames = 0;
+	while (frames > 0)
+	{
+		int count = min<int>(frames, MAX_MIX_FRAMES);
+		float *out = MixBuffer.Data();
+		memset(out, 0, count * 2 * sizeof(float));
+
+		if (Inactive == INACTIVE_Active)
+		{
+			for (auto voice : Voices)
+			{
+				if (voice->Finished) continue;
+				if (SyncPaused || (SFXPaused && !(voice->ChanFlags & SNDF_NOPAUSE))) continue;
+				MixVoice(out, voice, count);
+				LastMixVoiceFrames += count;
+			}
+			for (auto stream : Streams)
+			{
+				stream->Mix(out, count, MusicVolume);
+			}
+		}
+		if (Output) WriteOutput(out, count);
+		frames -= count;
+	}
+	MixTime.Unclock();
+	LastMixMS = MixTime.TimeMS();
+}
+
+void SoftSoundRenderer::UpdateSounds()
+{
+	if (Inactive == INACTIVE_Complete)
+	{
+		// Keep the clock in sync so that no burst of audio is mixed when becoming active again.
+		StartTimeNS = I_nsTime();
+		MixedFrames = 0;
+		return;
+	}
+
+	int frames;
+	if (snd_swmixsamples > 0)
+	{
+		frames = snd_swmixsamples;
+	}
+	else
+	{
+		uint64_t expected = (I_nsTime() - StartTimeNS) * OutputRate / 1000000000;
+		frames = int(min<uint64_t>(expected - MixedFrames, OutputRate));
+		MixedFrames = expected;
+	}
+	if (frames > 0) Mix(frames);
+	PurgeFinishedVoices();
+}
+
+//==========================================================================
+//
+// Voice management
+//
+//==========================================================================
+
+void SoftSoundRenderer::UpdateVoiceGain(SoftVoice *voice)
+{
+	float gain = voice->Volume * SfxVolume;
+	float pan = 0;
+
+	if (voice->Is3D)
+	{
+		FVector3 dir = voice->Position - Listener.position;
+		float dist = dir.Length();
+		gain *= GetRolloff(&voice->Rolloff, dist * voice->DistanceScale);
+		if (!voice->AreaSound && dist >= HEAD_RELATIVE_DIST && Listener.valid)
+		{
+			// The listener's right vector, in the sound system's coordinate space (Y is up).
+			float angle = Listener.angle;
+			pan = clamp((dir.X * sinf(angle) - dir.Z * cosf(angle)) / dist, -1.f, 1.f);
+		}
+	}
+	// constant power panning
+	voice->GainL = gain * sqrtf(0.5f * (1.f - pan));
+	voice->GainR = gain * sqrtf(0.5f * (1.f + pan));
+}
+
+SoftVoice *SoftSoundRenderer::StartVoice(SoftSoundBuffer *buffer, float vol, float pitch, int chanflags, float startTime)
+{
+	if (buffer == nullptr) return nullptr;
+
+	SoftVoice *voice;
+	if (FreeVoices.Pop(voice)) memset(voice, 0, sizeof(*voice));
+	else voice = new SoftVoice{};
+
+	voice->Buffer = buffer;
+	voice->ChanFlags = chanflags;
+	voice->Volume = vol;
+	voice->Pitch = max(pitch, 0.0001f);
+	voice->Step = (uint64_t)((double)buffer->SampleRate * voice->Pitch / OutputRate * 4294967296.);
+	if (voice->Step == 0) voice->Step = 1;
+
+	float length = (float)buffer->Frames / buffer->SampleRate;
+	float st = (chanflags & SNDF_LOOP) ? (length > 0 ? fmod(startTime, length) : 0) : clamp<float>(startTime, 0.f, length);
+	voice->Pos = uint64_t(st * buffer->SampleRate) << FRACBITS_SND;
+
+	UpdateVoiceGain(voice);
+	Voices.Push(voice);
+	return voice;
+}
+
+void SoftSoundRenderer::SetVoicePosition(SoftVoice *voice, const FRolloffInfo *rolloff, float distscale, const FVector3 &pos, bool areasound)
+{
+	voice->Is3D = true;
+	voice->Rolloff = *rolloff;
+	voice->DistanceScale = distscale;
+	voice->Position = pos;
+	voice->AreaSound = areasound;
+	UpdateVoiceGain(voice);
+}
+
+void SoftSoundRenderer::FreeVoice(SoftVoice *voice)
+{
+	unsigned i = Voices.Find(voice);
+	if (i < Voices.Size()) Voices.Delete(i);
+	FreeVoices.Push(voice);
+}
+
+SoftVoice *SoftSoundRenderer::FindVoice(FISoundChannel *chan)
+{
+	if (chan == nullptr || chan->SysChannel == nullptr) return nullptr;
+	return (SoftVoice*)chan->SysChannel;
+}
+
+void SoftSoundRenderer::PurgeFinishedVoices()
+{
+	for (int i = Voices.Size() - 1; i >= 0; i--)
+	{
+		// StopChannel may remove more than one entry through the sound engine's callbacks.
+		if (i >= (int)Voices.Size()) continue;
+		auto voice = Voices[i];
+		if (!voice->Finished) continue;
+		if (voice->Chan) StopChannel(voice->Chan);
+		else FreeVoice(voice);
+	}
+}
+
+FSoundChan *SoftSoundRenderer::FindLowestChannel()
+{
+	FSoundChan *schan = soundEngine->GetChannels();
+	FSoundChan *lowest = NULL;
+	while (schan)
+	{
+		if (schan->SysChannel != NULL)
+		{
+			if (!lowest || schan->Priority < lowest->Priority ||
+				(schan->Priority == lowest->Priority &&
+					schan->DistanceSqr > lowest->DistanceSqr))
+				lowest = schan;
+		}
+		schan = schan->NextChan;
+	}
+	return lowest;
+}
+
+//==========================================================================
+//
+// Sound loading
+//
+//==========================================================================
+
+SoundHandle SoftSoundRenderer::LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend)
+{
+	SoundHandle retval = { NULL };
+
+	if (length == 0) return retval;
+	if ((bits != 8 && bits != -8 && bits != 16) || (channels != 1 && channels != 2) || frequency <= 0)
+	{
+		Printf("Unhandled format: %d bit, %d channel, %d hz\n", bits, channels, frequency);
+		return retval;
+	}
+	int framesize = channels * abs(bits) / 8;
+	int frames = length / framesize;
+
+	auto buffer = new SoftSoundBuffer;
+	buffer->Samples.Resize(frames * channels);
+	ConvertSamples(buffer->Samples.Data(), sfxdata, frames * channels, bits);
+	buffer->Channels = channels;
+	buffer->Frames = frames;
+	buffer->SampleRate = frequency;
+	if (loopstart < 0) loopstart = 0;
+	if (loopend < loopstart || loopend > frames) loopend = frames;
+	buffer->LoopStart = loopstart;
+	buffer->LoopEnd = loopend;
+
+	retval.data = buffer;
+	return retval;
+}
+
+SoundHandle SoftSoundRenderer::LoadSound(uint8_t *sfxdata, int length, int def_loop_start, int def_loop_end)
+{
+	SoundHandle retval = { NULL };
+	ChannelConfig chans;
+	SampleType type;
+	int srate;
+	uint32_t loop_start = 0, loop_end = ~0u;
+	zmusic_bool startass = false, endass = false;
+
+	if (def_loop_start < 0)
+	{
+		FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
+	}
+	else
+	{
+		loop_start = def_loop_start;
+		loop_end = def_loop_end;
+		startass = endass = true;
+	}
+	auto decoder = CreateDecoder(sfxdata, length, true);
+	if (!decoder)
+		return retval;
+
+	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
+	int channels = chans == ChannelConfig_Mono ? 1 : chans == ChannelConfig_Stereo ? 2 : 0;
+	int bits = type == SampleType_UInt8 ? 8 : type == SampleType_Int16 ? 16 : 0;
+	if (channels == 0 || bits == 0)
+	{
+		SoundDecoder_Close(decoder);
+		Printf("Unsupported audio format: %s, %s\n", GetChannelConfigName(chans),
+			GetSampleTypeName(type));
+		return retval;
+	}
+
+	std::vector<uint8_t> data;
+	unsigned total = 0;
+	unsigned got;
+
+	data.resize(total + 32768);
+	while ((got = (unsigned)SoundDecoder_Read(decoder, (char*)&data[total], data.size() - total)) > 0)
+	{
+		total += got;
+		data.resize(total * 2);
+	}
+	data.resize(total);
+	SoundDecoder_Close(decoder);
+	if (total == 0)
+	{
+		return retval;
+	}
+
+	const uint32_t samples = total / (channels * bits / 8);
+	if (!startass) loop_start = Scale(loop_start, srate, 1000);
+	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
+	if (loop_start > samples) loop_start = 0;
+	if (loop_end > samples) loop_end = samples;
+
+	return LoadSoundRaw(data.data(), total, srate, channels, bits, loop_start, loop_end);
+}
+
+void SoftSoundRenderer::UnloadSound(SoundHandle sfx)
+{
+	if (!sfx.data)
+		return;
+
+	auto buffer = (SoftSoundBuffer*)sfx.data;
+	for (int i = Voices.Size() - 1; i >= 0; i--)
+	{
+		if (i >= (int)Voices.Size() || Voices[i]->Buffer != buffer) continue;
+		if (Voices[i]->Chan) StopChannel(Voices[i]->Chan);
+		else FreeVoice(Voices[i]);
+	}
+	delete buffer;
+}
+
+unsigned int SoftSoundRenderer::GetMSLength(SoundHandle sfx)
+{
+	if (!sfx.data) return 0;
+	auto buffer = (SoftSoundBuffer*)sfx.data;
+	return unsigned(uint64_t(buffer->Frames) * 1000 / buffer->SampleRate);
+}
+
+unsigned int SoftSoundRenderer::GetSampleLength(SoundHandle sfx)
+{
+	if (!sfx.data) return 0;
+	return ((SoftSoundBuffer*)sfx.data)->Frames;
+}
+
+float SoftSoundRenderer::GetOutputRate()
+{
+	return (float)OutputRate;
+}
+
+void SoftSoundRenderer::SetSfxVolume(float volume)
+{
+	SfxVolume = volume;
+	for (auto voice : Voices) UpdateVoiceGain(voice);
+}
+
+void SoftSoundRenderer::SetMusicVolume(float volume)
+{
+	MusicVolume = volume;
+}
+
+SoundStream *SoftSoundRenderer::CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata)
+{
+	if ((flags & SoundStream::Bits32) || samplerate <= 0)
+	{
+		Printf("Unsupported format: 0x%x\n", flags);
+		return nullptr;
+	}
+	return new SoftSoundStream(this, callback, flags, samplerate, userdata);
+}
+
+//==========================================================================
+//
+// Channels
+//
+//==========================================================================
+
+static void SetStartTime(SoftVoice *voice, FISoundChannel *reuse_chan, int chanflags)
+{
+	if (reuse_chan == nullptr || reuse_chan->StartTime == 0) return;
+	auto buffer = voice->Buffer;
+	if (chanflags & SNDF_ABSTIME)
+	{
+		voice->Pos = uint64_t(min<uint64_t>(reuse_chan->StartTime, buffer->Frames)) << FRACBITS_SND;
+	}
+	else
+	{
+		float offset = std::chrono::duration_cast<std::chrono::duration<float>>(
+			std::chrono::steady_clock::now().time_since_epoch() -
+			std::chrono::steady_clock::time_point::duration(reuse_chan->StartTime)
+			).count();
+		if (offset > 0.f) voice->Pos = uint64_t(min<double>(offset * buffer->SampleRate, buffer->Frames)) << FRACBITS_SND;
+	}
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound(SoundHandle sfx, float vol, float pitch, int chanflags, FISoundChannel *reuse_chan, float startTime)
+{
+	if ((int)Voices.Size() >= snd_channels)
+	{
+		FSoundChan *lowest = FindLowestChannel();
+		if (lowest) StopChannel(lowest);
+		if ((int)Voices.Size() >= snd_channels)
+			return nullptr;
+	}
+
+	auto voice = StartVoice((SoftSoundBuffer*)sfx.data, vol, pitch, chanflags, startTime);
+	if (voice == nullptr) return nullptr;
+	SetStartTime(voice, reuse_chan, chanflags);
+
+	FISoundChannel *chan = reuse_chan;
+	if (!chan) chan = soundEngine->GetChannel(voice);
+	else chan->SysChannel = voice;
+	voice->Chan = chan;
+
+	chan->Rolloff.RolloffType = ROLLOFF_Log;
+	chan->Rolloff.RolloffFactor = 0.f;
+	chan->Rolloff.MinDistance = 1.f;
+	chan->DistanceSqr = 0.f;
+	chan->ManualRolloff = false;
+
+	return chan;
+}
+
+FISoundChannel *SoftSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener *listener, float vol,
+	FRolloffInfo *rolloff, float distscale, float pitch, int priority, const FVector3 &pos, const FVector3 &vel,
+	int channum, int chanflags, FISoundChannel *reuse_chan, float startTime)
+{
+	float dist_sqr = (float)(pos - listener->position).LengthSquared();
+
+	if ((int)Voices.Size() >= snd_channels)
+	{
+		FSoundChan *lowest = FindLowestChannel();
+		if (lowest)
+		{
+			if (lowest->Priority < priority || (lowest->Priority == priority &&
+				lowest->DistanceSqr > dist_sqr))
+				StopChannel(lowest);
+		}
+		if ((int)Voices.Size() >= snd_channels)
+			return nullptr;
+	}
+
+	auto voice = StartVoice((SoftSoundBuffer*)sfx.data, vol, pitch, chanflags, startTime);
+	if (voice == nullptr) return nullptr;
+	SetStartTime(voice, reuse_chan, chanflags);
+	SetVoicePosition(voice, rolloff, distscale, pos, !!(chanflags & SNDF_AREA));
+
+	FISoundChannel *chan = reuse_chan;
+	if (!chan) chan = soundEngine->GetChannel(voice);
+	else chan->SysChannel = voice;
+	voice->Chan = chan;
+
+	chan->Rolloff = *rolloff;
+	chan->DistanceSqr = dist_sqr;
+	chan->ManualRolloff = true;
+
+	return chan;
+}
+
+void SoftSoundRenderer::StopChannel(FISoundChannel *chan)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return;
+
+	// Release first, so it can be properly marked as evicted if it's being killed
+	soundEngine->ChannelEnded(chan);
+	FreeVoice(voice);
+	if (!(chan->ChanFlags & CHANF_EVICTED))
+		soundEngine->SoundDone(chan);
+}
+
+void SoftSoundRenderer::ChannelVolume(FISoundChannel *chan, float volume)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return;
+	voice->Volume = volume;
+	UpdateVoiceGain(voice);
+}
+
+void SoftSoundRenderer::ChannelPitch(FISoundChannel *chan, float pitch)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return;
+	voice->Pitch = max(pitch, 0.0001f);
+	voice->Step = max<uint64_t>(1, (uint64_t)((double)voice->Buffer->SampleRate * voice->Pitch / OutputRate * 4294967296.));
+}
+
+void SoftSoundRenderer::MarkStartTime(FISoundChannel *chan, float startTime)
+{
+	using namespace std::chrono;
+	auto startTimeDuration = duration<double>(startTime);
+	auto diff = steady_clock::now().time_since_epoch() - startTimeDuration;
+	chan->StartTime = static_cast<uint64_t>(duration_cast<nanoseconds>(diff).count());
+}
+
+unsigned int SoftSoundRenderer::GetPosition(FISoundChannel *chan)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return 0;
+	return unsigned(voice->Pos >> FRACBITS_SND);
+}
+
+float SoftSoundRenderer::GetAudibility(FISoundChannel *chan)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return 0.f;
+	float volume = voice->Volume * SfxVolume;
+	if (voice->Is3D) volume *= GetRolloff(&voice->Rolloff, (voice->Position - Listener.position).Length() * voice->DistanceScale);
+	return volume;
+}
+
+void SoftSoundRenderer::Sync(bool sync)
+{
+	SyncPaused = sync;
+}
+
+void SoftSoundRenderer::SetSfxPaused(bool paused, int slot)
+{
+	if (paused) SFXPaused |= 1 << slot;
+	else SFXPaused &= ~(1 << slot);
+}
+
+void SoftSoundRenderer::SetInactive(EInactiveState inactive)
+{
+	Inactive = inactive;
+}
+
+void SoftSoundRenderer::UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel)
+{
+	auto voice = FindVoice(chan);
+	if (voice == nullptr)
+		return;
+
+	chan->DistanceSqr = (float)(pos - listener->position).LengthSquared();
+	voice->Position = pos;
+	voice->AreaSound = areasound;
+	UpdateVoiceGain(voice);
+}
+
+void SoftSoundRenderer::UpdateListener(SoundListener *listener)
+{
+	if (!listener->valid)
+		return;
+	Listener = *listener;
+	for (auto voice : Voices)
+	{
+		if (voice->Is3D) UpdateVoiceGain(voice);
+	}
+}
+
+//==========================================================================
+//
+// Status
+//
+//==========================================================================
+
+bool SoftSoundRenderer::IsValid()
+{
+	return true;
+}
+
+void SoftSoundRenderer::PrintStatus()
+{
+	Printf("Software mixer active.\n");
+	Printf("Output rate: " TEXTCOLOR_BLUE "%d" TEXTCOLOR_NORMAL "hz\n", OutputRate);
+	if (Output) Printf("Writing to: " TEXTCOLOR_ORANGE "%s" TEXTCOLOR_NORMAL " (%s, %.1f seconds so far)\n", *snd_swoutput, OutputIsWav ? "WAV" : "raw", double(OutputFrames) / OutputRate);
+	else Printf("Output is discarded.\n");
+	if (snd_swmixsamples > 0) Printf("Fixed mixing step: " TEXTCOLOR_BLUE "%d" TEXTCOLOR_NORMAL " samples per update\n", *snd_swmixsamples);
+}
+
+void SoftSoundRenderer::PrintDriversList()
+{
+	Printf("Software mixer uses no drivers.\n");
+}
+
+FString SoftSoundRenderer::GatherStats()
+{
+	FString out;
+	out.Format("%u voices, " TEXTCOLOR_YELLOW "%u" TEXTCOLOR_NORMAL " streams, mixed " TEXTCOLOR_YELLOW "%d" TEXTCOLOR_NORMAL " samples in " TEXTCOLOR_YELLOW "%2.3f" TEXTCOLOR_NORMAL " ms",
+		Voices.Size(), Streams.Size(), LastMixFrames, LastMixMS);
+	if (LastMixVoiceFrames > 0)
+	{
+		// cost of mixing one second of output for a single channel.
+		out.AppendFormat(", " TEXTCOLOR_YELLOW "%2.3f" TEXTCOLOR_NORMAL " ms/s per channel", LastMixMS * OutputRate / LastMixVoiceFrames);
+	}
+	return out;
+}
+
+//==========================================================================
+//
+// CCMD snd_swbench [channels] [seconds]
+//
+// Mixes synthetic channels at various pitches and distances into a
+// discarded output and reports the cost per active channel.
+//
+//==========================================================================
+
+CCMD(snd_swbench)
+{
+	int channels = argv.argc() > 1 ? max(1, (int)strtol(argv[1], nullptr, 10)) : 64;
+	int seconds = argv.argc() > 2 ? max(1, (int)strtol(argv[2], nullptr, 10)) : 10;
+
+	SoftSoundRenderer mixer(true);
+	int rate = (int)mixer.GetOutputRate();
+
+	// A one second mono and stereo tone with a little noise on top.
+	TArray<int16_t> data(22050 * 2, true);
+	for (int i = 0; i < 22050 * 2; i++)
+	{
+		data[i] = int16_t(sin(i * 0.0628) * 16000 + (((i * 1103515245u + 12345u) >> 16) & 1023) - 512);
+	}
+	auto mono = mixer.LoadSoundRaw((uint8_t*)data.Data(), 22050 * 2, 22050, 1, 16, 0, -1);
+	auto stereo = mixer.LoadSoundRaw((uint8_t*)data.Data(), 22050 * 4, 11025, 2, 16, 0, -1);
+
+	FRolloffInfo rolloff = { ROLLOFF_Linear, 200.f, { 1200.f } };
+	for (int i = 0; i < channels; i++)
+	{
+		bool is3d = (i % 4) != 3;
+		auto voice = mixer.StartVoice((SoftSoundBuffer*)(is3d ? mono.data : stereo.data), 1.f / channels, 0.75f + (i % 7) * 0.1f, SNDF_LOOP, i * 0.01f);
+		if (is3d) mixer.SetVoicePosition(voice, &rolloff, 1.f, FVector3(float(i * 13 % 1000), 0.f, float(i * 29 % 1000) - 500.f), false);
+	}
+
+	cycle_t total;
+	total.Reset();
+	int frames = rate * seconds;
+	for (int done = 0; done < frames; done += MAX_MIX_FRAMES)
+	{
+		total.Clock();
+		mixer.Mix(min<int>(MAX_MIX_FRAMES, frames - done));
+		total.Unclock();
+	}
+
+	double ms = total.TimeMS();
+	Printf("Mixed %d channels for %d seconds at %d Hz in %.2f ms (%.1fx realtime)\n", channels, seconds, rate, ms, seconds * 1000. / ms);
+	Printf("Cost per active channel: %.3f ms per second of output, %.2f ns per sample\n", ms / seconds / channels, ms * 1e6 / frames / channels);
+	mixer.UnloadSound(mono);
+	mixer.UnloadSound(stereo);
+}
@@ -0,0 +1,111 @@
+#ifndef SOFTSOUND_H
+#define SOFTSOUND_H
+
+#include "i_sound.h"
+#include "s_soundinternal.h"
+#include "stats.h"
+
+class FileWriter;
+class SoftSoundStream;
+struct SoftSoundBuffer;
+struct SoftVoice;
+
+//==========================================================================
+//
+// Software mixing sound renderer.
+//
+// Mixes all channels on the CPU into a 16 bit stereo stream that is either
+// written to a WAV/raw file or discarded. Needs no audio device so it can
+// be used on headless machines and - with a fixed mixing step - produces
+// bit-identical output for identical input.
+//
+//==========================================================================
+
+class SoftSoundRenderer : public SoundRenderer
+{
+public:
+	SoftSoundRenderer(bool benchmark = false);
+	virtual ~SoftSoundRenderer();
+
+	void SetSfxVolume(float volume) override;
+	void SetMusicVolume(float volume) override;
+	SoundHandle LoadSound(uint8_t *sfxdata, int length, int def_loop_start, int def_loop_end) override;
+	SoundHandle LoadSoundRaw(uint8_t *sfxdata, int length, int frequency, int channels, int bits, int loopstart, int loopend = -1) override;
+	void UnloadSound(SoundHandle sfx) override;
+	unsigned int GetMSLength(SoundHandle sfx) override;
+	unsigned int GetSampleLength(SoundHandle sfx) override;
+	float GetOutputRate() override;
+
+	// Streaming sounds.
+	SoundStream *CreateStream(SoundStreamCallback callback, int buffbytes, int flags, int samplerate, void *userdata) override;
+
+	// Starts a sound.
+	FISoundChannel *StartSound(SoundHandle sfx, float vol, float pitch, int chanflags, FISoundChannel *reuse_chan, float startTime) override;
+	FISoundChannel *StartSound3D(SoundHandle sfx, SoundListener *listener, float vol, FRolloffInfo *rolloff, float distscale, float pitch, int priority, const FVector3 &pos, const FVector3 &vel, int channum, int chanflags, FISoundChannel *reuse_chan, float startTime) override;
+
+	void StopChannel(FISoundChannel *chan) override;
+	void ChannelVolume(FISoundChannel *chan, float volume) override;
+	void ChannelPitch(FISoundChannel *chan, float pitch) override;
+	void MarkStartTime(FISoundChannel *chan, float startTime) override;
+	unsigned int GetPosition(FISoundChannel *chan) override;
+	float GetAudibility(FISoundChannel *chan) override;
+	void Sync(bool sync) override;
+	void SetSfxPaused(bool paused, int slot) override;
+	void SetInactive(EInactiveState inactive) override;
+	void UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel) override;
+	void UpdateListener(SoundListener *) override;
+	void UpdateSounds() override;
+
+	bool IsValid() override;
+	void PrintStatus() override;
+	void PrintDriversList() override;
+	FString GatherStats() override;
+
+	// Mixes the given number of frames into the output. Public so that the benchmark can drive it directly.
+	void Mix(int frames);
+	SoftVoice *StartVoice(SoftSoundBuffer *buffer, float vol, float pitch, int chanflags, float startTime);
+	void SetVoicePosition(SoftVoice *voice, const FRolloffInfo *rolloff, float distscale, const FVector3 &pos, bool areasound);
+
+private:
+	friend class SoftSoundStream;
+
+	void OpenOutput();
+	void CloseOutput();
+	void WriteOutput(const float *mixbuffer, int frames);
+	void UpdateVoiceGain(SoftVoice *voice);
+	void FreeVoice(SoftVoice *voice);
+	void PurgeFinishedVoices();
+	SoftVoice *FindVoice(FISoundChannel *chan);
+	static FSoundChan *FindLowestChannel();
+
+	bool Benchmark;
+	int OutputRate;
+	float SfxVolume = 1.f;
+	float MusicVolume = 1.f;
+	int SFXPaused = 0;
+	bool SyncPaused = false;
+	EInactiveState Inactive = INACTIVE_Active;
+
+	SoundListener Listener = {};
+	TArray<SoftVoice*> Voices;
+	TArray<SoftVoice*> FreeVoices;
+	TArray<SoftSoundStream*> Streams;
+	TArray<float> MixBuffer;
+	TArray<int16_t> OutBuffer;
+
+	FileWriter *Output = nullptr;
+	bool OutputIsWav = false;
+	uint64_t OutputFrames = 0;
+
+	// Timing for real time mixing mode.
+	uint64_t StartTimeNS = 0;
+	uint64_t MixedFrames = 0;
+
+	// Statistics
+	cycle_t MixTime;
+	double LastMixMS = 0;
+	int LastMixFrames = 0;
+	int64_t LastMixVoiceFrames = 0;
+};
+
+#endif
@@ -0,0 +1,303 @@
+/*
+** tracing.cpp
+** Scoped-zone tracing with Chrome trace export
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Each thread only ever writes to its own buffer, and publishes a new
+** event by advancing the buffer's write position, so recording needs no
+** locks. The mutex only guards the list of buffers, which changes when a
+** thread records its first zone or exits.
+**
+** A buffer that is full drops all further events of the capture instead
+** of overwriting the oldest ones, so that a capture always starts at the
+** beginning, and the number of dropped events gets reported.
+**
+** Before the capture is written, recording is stopped and every thread
+** that is still in the middle of adding an event is waited for.
+**
+*/
+
+#include <mutex>
+#include <thread>
+#include "tracing.h"
+#include "tarray.h"
+#include "zstring.h"
+#include "files.h"
+#include "c_dispatch.h"
+#include "printf.h"
+#include "v_text.h"
+
+namespace Trace
+{
+
+struct FEvent
+{
+	const char *Name;
+	uint64_t Start;
+	uint64_t End;
+};
+
+struct FBuffer
+{
+	enum { Size = 32768 };
+
+	FString ThreadName;
+	int ThreadId;
+	bool Exited = false;	// the thread is gone, the buffer only stays until the capture has been written.
+	std::atomic<bool> Busy{ false };
+	std::atomic<uint32_t> WritePos{ 0 };
+	std::atomic<uint32_t> Dropped{ 0 };
+	FEvent Events[Size];
+};
+
+std::atomic<bool> Active;
+
+static std::mutex BufferMutex;
+static TArray<FBuffer *> Buffers;
+static int NextThreadId = 1;
+static thread_local FString CurrentThreadName;
+
+// Frees the thread's buffer when the thread exits.
+struct FBufferOwner
+{
+	FBuffer *Buffer = nullptr;
+
+	~FBufferOwner()
+	{
+		if (Buffer == nullptr) return;
+		std::unique_lock<std::mutex> lock(BufferMutex);
+		if (Active.load())
+		{
+			Buffer->Exited = true;
+		}
+		else
+		{
+			Buffers.Delete(Buffers.Find(Buffer));
+			delete Buffer;
+		}
+	}
+};
+
+static thread_local FBufferOwner CurrentBuffer;
+
+static const char FrameMarker[] = "Frame";
+static uint64_t CaptureStart;
+static int FramesLeft;
+static FString CaptureFile;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static FBuffer *GetBuffer()
+{
+	if (CurrentBuffer.Buffer == nullptr)
+	{
+		auto buffer = new FBuffer;
+		std::unique_lock<std::mutex> lock(BufferMutex);
+		buffer->ThreadId = NextThreadId++;
+		if (CurrentThreadName.IsNotEmpty()) buffer->ThreadName = CurrentThreadName;
+		else buffer->ThreadName.Format("Thread %d", buffer->ThreadId);
+		Buffers.Push(buffer);
+		CurrentBuffer.Buffer = buffer;
+	}
+	return CurrentBuffer.Buffer;
+}
+
+void AddZone(const char *name, uint64_t start, uint64_t end)
+{
+	auto buffer = GetBuffer();
+
+	// The capture may have been stopped since the zone started. Busy must be set before
+	// checking so that WriteCapture either sees it set or this sees the capture stopped.
+	buffer->Busy.store(true);
+	if (Active.load())
+	{
+		uint32_t pos = buffer->WritePos.load(std::memory_order_relaxed);
+		if (pos < FBuffer::Size)
+		{
+			buffer->Events[pos] = { name, start, end };
+			buffer->WritePos.store(pos + 1, std::memory_order_release);
+		}
+		else buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+	buffer->Busy.store(false, std::memory_order_release);
+}
+
+// The buffer itself is only created once the thread records something.
+void SetThreadName(const char *name)
+{
+	CurrentThreadName = name;
+	if (CurrentBuffer.Buffer != nullptr)
+	{
+		std::unique_lock<std::mutex> lock(BufferMutex);
+		CurrentBuffer.Buffer->ThreadName = name;
+	}
+}
+
+// Clears all buffers for a new capture. No thread may be recording at this point.
+static void ResetBuffers()
+{
+	std::unique_lock<std::mutex> lock(BufferMutex);
+	for (auto buffer : Buffers)
+	{
+		buffer->WritePos.store(0, std::memory_order_relaxed);
+		buffer->Dropped.store(0, std::memory_order_relaxed);
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static void WriteString(FileWriter *fw, const char *str)
+{
+	fw->Write("\"", 1);
+	for (; *str; str++)
+	{
+		if (*str == '"' || *str == '\\') fw->Write("\\", 1);
+		if ((uint8_t)*str >= 32) fw->Write(str, 1);
+	}
+	fw->Write("\"", 1);
+}
+
+static void WriteCapture()
+{
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(CaptureFile.GetChars()));
+	if (fw == nullptr)
+	{
+		Printf("Could not open %s\n", CaptureFile.GetChars());
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(BufferMutex);
+	// Wait for the threads that were adding an event when the capture got stopped.
+	for (auto buffer : Buffers)
+	{
+		while (buffer->Busy.load(std::memory_order_acquire)) std::this_thread::yield();
+	}
+
+	int numevents = 0;
+	unsigned dropped = 0;
+	bool first = true;
+	fw->Printf("{\"traceEvents\":[\n");
+	for (auto buffer : Buffers)
+	{
+		fw->Printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n", buffer->ThreadId);
+		WriteString(fw.get(), buffer->ThreadName.GetChars());
+		fw->Printf("}}");
+		first = false;
+
+		uint32_t end = buffer->WritePos.load(std::memory_order_acquire);
+		dropped += buffer->Dropped.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < end; i++)
+		{
+			const FEvent &ev = buffer->Events[i];
+			if (ev.Start < CaptureStart) continue;
+
+			fw->Printf(",\n{\"name\":");
+			WriteString(fw.get(), ev.Name);
+			if (ev.Name == FrameMarker)
+			{
+				fw->Printf(",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", (ev.Start - CaptureStart) / 1000., buffer->ThreadId);
+			}
+			else
+			{
+				fw->Printf(",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}", (ev.Start - CaptureStart) / 1000., (ev.End - ev.Start) / 1000., buffer->ThreadId);
+			}
+			numevents++;
+		}
+	}
+	fw->Printf("\n]}\n");
+	Printf("%d trace events written to %s\n", numevents, CaptureFile.GetChars());
+	if (dropped > 0)
+	{
+		Printf(TEXTCOLOR_RED "%u trace events were dropped because a thread's buffer was full. Capture fewer frames to get all of them.\n", dropped);
+	}
+
+	// The buffers of threads that exited during the capture are no longer needed.
+	for (int i = Buffers.Size() - 1; i >= 0; i--)
+	{
+		if (Buffers[i]->Exited)
+		{
+			delete Buffers[i];
+			Buffers.Delete(i);
+		}
+	}
+}
+
+//==========================================================================
+//
+// Must be called by the main thread once per frame.
+//
+//==========================================================================
+
+void EndFrame()
+{
+	if (!Active.load(std::memory_order_relaxed)) return;
+
+	uint64_t now = I_nsTime();
+	AddZone(FrameMarker, now, now);
+	if (--FramesLeft <= 0)
+	{
+		Active.store(false);
+		WriteCapture();
+	}
+}
+
+}
+
+//==========================================================================
+//
+// CCMD trace
+//
+// Records the given number of frames and writes them to a file in the
+// Chrome trace event format.
+//
+//==========================================================================
+
+CCMD(trace)
+{
+	if (Trace::Active)
+	{
+		Printf("A trace is already being captured\n");
+		return;
+	}
+	Trace::FramesLeft = argv.argc() > 1 ? max(1, atoi(argv[1])) : 60;
+	Trace::CaptureFile = argv.argc() > 2 ? argv[2] : "trace.json";
+	Trace::ResetBuffers();
+	Trace::CaptureStart = I_nsTime();
+	Trace::Active.store(true);
+	Printf("Capturing %d frames\n", Trace::FramesLeft);
+}
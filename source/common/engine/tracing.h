@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "i_time.h"
+
+// Scoped-zone tracing. While a capture is running, every zone records its
+// start and end time into a buffer owned by the current thread. The result
+// can be loaded into chrome://tracing or ui.perfetto.dev.
+//
+// Zone names are stored as pointers and must stay valid until the capture
+// has been written, so only string literals or similarly long-lived names
+// may be used.
+
+namespace Trace
+{
+	extern std::atomic<bool> Active;
+
+	void AddZone(const char *name, uint64_t start, uint64_t end);
+	void SetThreadName(const char *name);
+	void EndFrame();
+}
+
+class FTraceZone
+{
+	const char *Name;
+	uint64_t Start;
+
+public:
+	FTraceZone(const char *name)
+	{
+		if (Trace::Active.load(std::memory_order_relaxed))
+		{
+			Name = name;
+			Start = I_nsTime();
+		}
+		else Name = nullptr;
+	}
+
+	~FTraceZone()
+	{
+		if (Name != nullptr) Trace::AddZone(Name, Start, I_nsTime());
+	}
+
+	FTraceZone(const FTraceZone &) = delete;
+	FTraceZone &operator=(const FTraceZone &) = delete;
+};
+
+#define TRACE_ZONE_CONCAT2(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT2(a, b)
+#define TRACE_ZONE(name) FTraceZone TRACE_ZONE_CONCAT(tracezone_, __LINE__)(name)
@@ -40,6 +40,8 @@
 #include "resourcefile.h"
 #include "cmdlib.h"
 #include "printf.h"
+#include "stats.h"
+#include <mutex>
 
 
 
@@ -103,15 +105,48 @@ struct CZDFileInStream
 	}
 };
 
+//-----------------------------------------------------------------------
+//
+// Solid archives store many files in one compressed block, which can only
+// be decoded as a whole. The most recently used decoded blocks are therefore
+// kept around, so that reading files from different blocks in alternation
+// does not decode the same blocks over and over again.
+//
+// All archives share one memory budget. If it gets exceeded, the least
+// recently used blocks of all archives are freed, except for the one that
+// was just used, no matter how large it is.
+//
+//-----------------------------------------------------------------------
+
+static const size_t MaxCachedBlockMemory = 128 << 20;
+
+struct C7zArchive;
+
+struct C7zBlock
+{
+	UInt32 Index;
+	Byte *Buffer;
+	size_t Size;
+	uint64_t LastUse;
+};
+
+// Extracting needs exclusive access to the archive's stream and the blocks
+// of all archives, because extracting a block may free those of another one.
+static std::mutex BlockMutex;
+static TArray<C7zArchive*> BlockArchives;
+static size_t BlockMemory;
+static uint64_t BlockUseCounter;
+static uint64_t BlockBytesDecoded;
+static uint64_t BlockBytesRequested;
+static unsigned BlocksDecoded;
+
 struct C7zArchive
 {
 	CSzArEx DB;
 	CZDFileInStream ArchiveStream;
 	CLookToRead2 LookStream;
 	Byte StreamBuffer[1<<14];
-	UInt32 BlockIndex;
-	Byte *OutBuffer;
-	size_t OutBufferSize;
+	TArray<C7zBlock> Blocks;
 
 	C7zArchive(FileReader &file) : ArchiveStream(file)
 	{
@@ -126,17 +161,19 @@ struct C7zArchive
 		LookStream.bufSize = sizeof(StreamBuffer);
 		LookStream.buf = StreamBuffer;
 		SzArEx_Init(&DB);
-		BlockIndex = 0xFFFFFFFF;
-		OutBuffer = NULL;
-		OutBufferSize = 0;
+
+		std::lock_guard<std::mutex> lock(BlockMutex);
+		BlockArchives.Push(this);
 	}
 
 	~C7zArchive()
 	{
-		if (OutBuffer != NULL)
+		std::lock_guard<std::mutex> lock(BlockMutex);
+		while (Blocks.Size() > 0)
 		{
-			IAlloc_Free(&g_Alloc, OutBuffer);
+			FreeBlock(Blocks.Size() - 1);
 		}
+		BlockArchives.Delete(BlockArchives.Find(this));
 		SzArEx_Free(&DB, &g_Alloc);
 	}
 
@@ -145,20 +182,95 @@ struct C7zArchive
 		return SzArEx_Open(&DB, &LookStream.vt, &g_Alloc, &g_Alloc);
 	}
 
+	void FreeBlock(unsigned index)
+	{
+		BlockMemory -= Blocks[index].Size;
+		IAlloc_Free(&g_Alloc, Blocks[index].Buffer);
+		Blocks.Delete(index);
+	}
+
+	// Throws out the least recently used blocks of all archives until everything fits again.
+	static void TrimBlocks()
+	{
+		while (BlockMemory > MaxCachedBlockMemory)
+		{
+			C7zArchive *oldarc = nullptr;
+			unsigned oldest = 0;
+			for (auto arc : BlockArchives)
+			{
+				for (unsigned i = 0; i < arc->Blocks.Size(); i++)
+				{
+					if (arc->Blocks[i].LastUse == BlockUseCounter) continue;
+					if (oldarc == nullptr || arc->Blocks[i].LastUse < oldarc->Blocks[oldest].LastUse)
+					{
+						oldarc = arc;
+						oldest = i;
+					}
+				}
+			}
+			if (oldarc == nullptr) break;
+			oldarc->FreeBlock(oldest);
+		}
+	}
+
 	SRes Extract(UInt32 file_index, char *buffer)
 	{
+		UInt32 folder = DB.FileToFolder[file_index];
+		if (folder == (UInt32)-1)
+		{
+			return SZ_OK;	// empty file, there's nothing to decode.
+		}
+
+		std::lock_guard<std::mutex> lock(BlockMutex);
+		unsigned index = 0;
+		while (index < Blocks.Size() && Blocks[index].Index != folder) index++;
+		if (index == Blocks.Size())
+		{
+			Blocks.Push({ 0xFFFFFFFF, NULL, 0, 0 });
+		}
+
+		auto &block = Blocks[index];
+		bool decode = block.Buffer == NULL;
 		size_t offset, out_size_processed;
 		SRes res = SzArEx_Extract(&DB, &LookStream.vt, file_index,
-			&BlockIndex, &OutBuffer, &OutBufferSize,
+			&block.Index, &block.Buffer, &block.Size,
 			&offset, &out_size_processed,
 			&g_Alloc, &g_Alloc);
+		if (decode)
+		{
+			BlockMemory += block.Size;
+			BlockBytesDecoded += block.Size;
+			BlocksDecoded++;
+		}
+		block.LastUse = ++BlockUseCounter;
+
 		if (res == SZ_OK)
 		{
-			memcpy(buffer, OutBuffer + offset, out_size_processed);
+			memcpy(buffer, block.Buffer + offset, out_size_processed);
+			BlockBytesRequested += out_size_processed;
+		}
+		else
+		{
+			// Do not keep anything around that failed to decode.
+			FreeBlock(index);
 		}
+		TrimBlocks();
 		return res;
 	}
 };
+
+ADD_STAT(sevenzip)
+{
+	std::lock_guard<std::mutex> lock(BlockMutex);
+	unsigned cached = 0;
+	for (auto arc : BlockArchives) cached += arc->Blocks.Size();
+	FString out;
+	out.Format("7z blocks decoded: %u, %llu KB decoded for %llu KB requested, %u blocks cached in %zu of %zu KB", BlocksDecoded,
+		(unsigned long long)(BlockBytesDecoded >> 10), (unsigned long long)(BlockBytesRequested >> 10),
+		cached, BlockMemory >> 10, MaxCachedBlockMemory >> 10);
+	return out;
+}
+
 //==========================================================================
 //
 // Zip Lump
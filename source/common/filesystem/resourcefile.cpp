@@ -38,6 +38,8 @@
 #include "resourcefile.h"
 #include "cmdlib.h"
 #include "md5.h"
+#include "c_cvars.h"
+#include "stats.h"
 
 
 //==========================================================================
@@ -65,6 +67,82 @@ public:
 };
 
 
+//==========================================================================
+//
+// Cache of unlocked lumps
+//
+// Compressed lumps would otherwise have to be decompressed again each time
+// they get read. Instead, their data stays in a list ordered by when the
+// last lock was released, and the oldest entries get freed once the total
+// exceeds the budget. A retained lump has a cache and a RefCount of 0.
+//
+//==========================================================================
+
+static FResourceLump *RetainedHead;	// most recently released
+static FResourceLump *RetainedTail;
+static size_t RetainedBytes;
+static size_t RetainedBudget = 32 << 20;
+static unsigned RetainedCount;
+static uint64_t RetainedHits, RetainedMisses, RetainedEvictions;
+
+static bool IsRetained(const FResourceLump *lump)
+{
+	return lump->RetainedPrev != NULL || RetainedHead == lump;
+}
+
+static void UnlinkRetained(FResourceLump *lump)
+{
+	if (lump->RetainedPrev) lump->RetainedPrev->RetainedNext = lump->RetainedNext;
+	else RetainedHead = lump->RetainedNext;
+	if (lump->RetainedNext) lump->RetainedNext->RetainedPrev = lump->RetainedPrev;
+	else RetainedTail = lump->RetainedPrev;
+	lump->RetainedPrev = lump->RetainedNext = NULL;
+	RetainedBytes -= lump->LumpSize;
+	RetainedCount--;
+}
+
+static void TrimRetained(size_t budget)
+{
+	while (RetainedBytes > budget && RetainedTail != NULL)
+	{
+		auto lump = RetainedTail;
+		UnlinkRetained(lump);
+		delete [] lump->Cache;
+		lump->Cache = NULL;
+		RetainedEvictions++;
+	}
+}
+
+static void Retain(FResourceLump *lump)
+{
+	lump->RetainedPrev = NULL;
+	lump->RetainedNext = RetainedHead;
+	if (RetainedHead) RetainedHead->RetainedPrev = lump;
+	else RetainedTail = lump;
+	RetainedHead = lump;
+	RetainedBytes += lump->LumpSize;
+	RetainedCount++;
+	TrimRetained(RetainedBudget);
+}
+
+CUSTOM_CVAR(Int, fs_lumpcache, 32, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0) self = 0;
+	else
+	{
+		RetainedBudget = (size_t)self << 20;
+		TrimRetained(RetainedBudget);
+	}
+}
+
+ADD_STAT(lumpcache)
+{
+	FString out;
+	out.Format("Lump cache: %u lumps, %zu of %zu KB, %llu hits, %llu misses, %llu evicted", RetainedCount, RetainedBytes >> 10, RetainedBudget >> 10,
+		(unsigned long long)RetainedHits, (unsigned long long)RetainedMisses, (unsigned long long)RetainedEvictions);
+	return out;
+}
+
 //==========================================================================
 //
 // Base class for resource lumps
@@ -73,6 +151,10 @@ public:
 
 FResourceLump::~FResourceLump()
 {
+	if (IsRetained(this))
+	{
+		UnlinkRetained(this);
+	}
 	if (Cache != NULL && RefCount >= 0)
 	{
 		delete [] Cache;
@@ -190,9 +272,16 @@ void *FResourceLump::Lock()
 	if (Cache != NULL)
 	{
 		if (RefCount > 0) RefCount++;
+		else if (RefCount == 0 && IsRetained(this))
+		{
+			UnlinkRetained(this);
+			RefCount = 1;
+			RetainedHits++;
+		}
 	}
 	else if (LumpSize > 0)
 	{
+		if (Flags & LUMPF_COMPRESSED) RetainedMisses++;
 		FillCache();
 	}
 	return Cache;
@@ -210,8 +299,15 @@ int FResourceLump::Unlock()
 	{
 		if (--RefCount == 0)
 		{
-			delete [] Cache;
-			Cache = NULL;
+			if ((Flags & LUMPF_COMPRESSED) && (size_t)LumpSize <= RetainedBudget)
+			{
+				Retain(this);
+			}
+			else
+			{
+				delete [] Cache;
+				Cache = NULL;
+			}
 		}
 	}
 	return RefCount;
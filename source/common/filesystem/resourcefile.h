@@ -97,6 +97,8 @@ public:
 	uint8_t			Flags;
 	char *			Cache;
 	FResourceFile *	Owner;
+	FResourceLump *	RetainedPrev;	// links in the list of unlocked caches that are kept around.
+	FResourceLump *	RetainedNext;
 
 	FResourceLump()
 	{
@@ -104,6 +106,7 @@ public:
 		Owner = NULL;
 		Flags = 0;
 		RefCount = 0;
+		RetainedPrev = RetainedNext = NULL;
 	}
 
 	virtual ~FResourceLump();
@@ -62,6 +62,7 @@
 #include "menu.h"
 #include "stats.h"
 #include "printf.h"
+#include "tracing.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -500,6 +501,7 @@ static size_t SingleStep()
 
 void Step()
 {
+	TRACE_ZONE("GC::Step");
 	GCTime.ResetAndClock();
 
 	auto enter_state = State;
@@ -0,0 +1,282 @@
+/*
+** dobjpool.cpp
+** Size-class pools for DObject memory
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The GC's allocation accounting is done per block, not per slab, so that
+** creating and destroying objects still drives the collector's pacing.
+**
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "dobjpool.h"
+#include "dobjgc.h"
+#include "engineerrors.h"
+#include "c_dispatch.h"
+#include "printf.h"
+#include "stats.h"
+
+namespace ObjectPool
+{
+
+struct FPool;
+
+struct alignas(16) FBlockHeader
+{
+	FPool *Pool;		// nullptr for blocks that are too large for pooling.
+	size_t Size;		// 0 for free blocks.
+};
+
+struct FFreeBlock
+{
+	FBlockHeader Header;
+	FFreeBlock *Next;
+};
+
+struct FPool
+{
+	size_t BlockSize;
+	size_t BlocksPerSlab;
+	TArray<uint8_t *> Slabs;
+	FFreeBlock *FreeList;
+	unsigned NumUsed;
+};
+
+enum
+{
+	Granularity = 16,
+	MaxPooledSize = 2048,
+	MinSlabSize = 65536,
+	NumPools = MaxPooledSize / Granularity,
+};
+
+static FPool *Pools[NumPools];
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static FPool *GetPool(size_t size)
+{
+	unsigned index = unsigned((size + Granularity - 1) / Granularity) - 1;
+	if (Pools[index] == nullptr)
+	{
+		auto pool = new FPool;
+		pool->BlockSize = sizeof(FBlockHeader) + (index + 1) * Granularity;
+		pool->BlocksPerSlab = std::max<size_t>(16, MinSlabSize / pool->BlockSize);
+		pool->FreeList = nullptr;
+		pool->NumUsed = 0;
+		Pools[index] = pool;
+	}
+	return Pools[index];
+}
+
+//==========================================================================
+//
+// Adds a new slab, with its blocks on the free list in address order.
+//
+//==========================================================================
+
+static void AddSlab(FPool *pool)
+{
+	auto slab = (uint8_t *)malloc(pool->BlockSize * pool->BlocksPerSlab);
+	if (slab == nullptr)
+	{
+		I_FatalError("Could not allocate %zu bytes in ObjectPool::AddSlab", pool->BlockSize * pool->BlocksPerSlab);
+	}
+	pool->Slabs.Push(slab);
+	for (size_t i = pool->BlocksPerSlab; i-- > 0; )
+	{
+		auto block = (FFreeBlock *)(slab + i * pool->BlockSize);
+		block->Header.Pool = pool;
+		block->Header.Size = 0;
+		block->Next = pool->FreeList;
+		pool->FreeList = block;
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void *Alloc(size_t size)
+{
+	if (size == 0 || size > MaxPooledSize)
+	{
+		auto header = (FBlockHeader *)M_Malloc(sizeof(FBlockHeader) + size);
+		header->Pool = nullptr;
+		header->Size = size;
+		return header + 1;
+	}
+
+	auto pool = GetPool(size);
+	if (pool->FreeList == nullptr) AddSlab(pool);
+	auto block = pool->FreeList;
+	pool->FreeList = block->Next;
+	pool->NumUsed++;
+	block->Header.Size = size;
+	GC::ReportAlloc(pool->BlockSize);
+	return &block->Header + 1;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void Free(void *mem)
+{
+	if (mem == nullptr) return;
+	auto header = (FBlockHeader *)mem - 1;
+	auto pool = header->Pool;
+	if (pool == nullptr)
+	{
+		M_Free(header);
+		return;
+	}
+	assert(header->Size != 0);
+	auto block = (FFreeBlock *)header;
+	block->Header.Size = 0;
+	block->Next = pool->FreeList;
+	pool->FreeList = block;
+	pool->NumUsed--;
+	GC::ReportDealloc(pool->BlockSize);
+}
+
+//==========================================================================
+//
+// Meant to be called between levels, after the old level's objects have
+// been collected, so that the new level's actors get allocated contiguously.
+//
+//==========================================================================
+
+void Compact()
+{
+	for (auto pool : Pools)
+	{
+		if (pool == nullptr) continue;
+
+		// Sorting the slabs makes the resulting free list ascend in address.
+		std::sort(pool->Slabs.begin(), pool->Slabs.end());
+		pool->FreeList = nullptr;
+		FFreeBlock **tail = &pool->FreeList;
+		unsigned keep = 0;
+		for (unsigned s = 0; s < pool->Slabs.Size(); s++)
+		{
+			uint8_t *slab = pool->Slabs[s];
+			bool used = false;
+			for (size_t i = 0; i < pool->BlocksPerSlab && !used; i++)
+			{
+				used = ((FBlockHeader *)(slab + i * pool->BlockSize))->Size != 0;
+			}
+			if (!used)
+			{
+				free(slab);
+				continue;
+			}
+			for (size_t i = 0; i < pool->BlocksPerSlab; i++)
+			{
+				auto block = (FFreeBlock *)(slab + i * pool->BlockSize);
+				if (block->Header.Size == 0)
+				{
+					*tail = block;
+					tail = &block->Next;
+				}
+			}
+			pool->Slabs[keep++] = slab;
+		}
+		*tail = nullptr;
+		pool->Slabs.Clamp(keep);
+	}
+}
+
+}
+
+//==========================================================================
+//
+// CCMD objpoolstats
+//
+//==========================================================================
+
+CCMD(objpoolstats)
+{
+	size_t total = 0, used = 0;
+	for (auto pool : ObjectPool::Pools)
+	{
+		if (pool == nullptr || pool->Slabs.Size() == 0) continue;
+		size_t blocks = pool->Slabs.Size() * pool->BlocksPerSlab;
+		Printf("%5zu bytes: %u/%zu blocks used in %u slabs\n", pool->BlockSize, pool->NumUsed, blocks, pool->Slabs.Size());
+		total += blocks * pool->BlockSize;
+		used += pool->NumUsed * pool->BlockSize;
+	}
+	Printf("%zuK of %zuK in use\n", (used + 1023) >> 10, (total + 1023) >> 10);
+}
+
+//==========================================================================
+//
+// CCMD objpoolbench
+//
+// Allocates and frees blocks in the pattern of a fight with lots of
+// short-lived actors, once from the pools and once straight from the heap.
+//
+//==========================================================================
+
+CCMD(objpoolbench)
+{
+	int count = argv.argc() > 1 ? max(1, atoi(argv[1])) : 20000;
+	size_t size = argv.argc() > 2 ? max(1, atoi(argv[2])) : 1024;
+	TArray<void *> blocks(count, true);
+
+	auto run = [&](auto alloc, auto release)
+	{
+		cycle_t clock;
+		clock.ResetAndClock();
+		for (int pass = 0; pass < 8; pass++)
+		{
+			for (int i = 0; i < count; i++) blocks[i] = alloc(size);
+			for (int i = 0; i < count; i += 2) release(blocks[i]);
+			for (int i = 0; i < count; i += 2) blocks[i] = alloc(size);
+			for (int i = 0; i < count; i++) release(blocks[i]);
+		}
+		clock.Unclock();
+		return clock.TimeMS();
+	};
+
+	double pooled = run(ObjectPool::Alloc, ObjectPool::Free);
+	double heap = run(M_Malloc, M_Free);
+	Printf("%d blocks of %zu bytes: pooled %.2fms, heap %.2fms\n", count, size, pooled, heap);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+
+// Size-class pools for DObject memory.
+//
+// Objects are put into slabs shared by all classes of the same size, so
+// that actors of one game end up close together in memory and memory
+// freed by the GC gets reused right away without a trip through malloc.
+// Every block carries a small header so that Free can tell pooled and
+// oversized allocations apart.
+
+namespace ObjectPool
+{
+	// Allocates memory for an object. The memory is not cleared.
+	void *Alloc(size_t size);
+
+	// Returns the memory of an object.
+	void Free(void *mem);
+
+	// Rebuilds the free lists in address order and returns empty slabs.
+	// Objects allocated afterward will be laid out in allocation order.
+	void Compact();
+}
@@ -52,6 +52,7 @@
 #include "version.h"
 #include "printf.h"
 #include "gl_framebuffer.h"
+#include "poly_framebuffer.h"
 #ifdef HAVE_GLES2
 #include "gles_framebuffer.h"
 #endif
@@ -805,6 +806,12 @@ void I_ShutdownGraphics()
 
 void I_InitGraphics()
 {
+	// The software rasterizer needs no window at all.
+	if (V_GetBackend() == 4)
+	{
+		Video = Poly_CreateVideo();
+		return;
+	}
 	Video = new CocoaVideo;
 }
 
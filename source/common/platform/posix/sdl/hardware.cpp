@@ -42,6 +42,7 @@
 #include "m_argv.h"
 #include "c_console.h"
 #include "printf.h"
+#include "poly_framebuffer.h"
 
 IVideo *Video;
 
@@ -59,11 +60,19 @@ void I_ShutdownGraphics ()
 	if (Video)
 		delete Video, Video = NULL;
 
-	SDL_QuitSubSystem (SDL_INIT_VIDEO);
+	if (SDL_WasInit(SDL_INIT_VIDEO))
+		SDL_QuitSubSystem (SDL_INIT_VIDEO);
 }
 
 void I_InitGraphics ()
 {
+	// The software rasterizer needs no window at all, so it must also work without a display.
+	if (V_GetBackend() == 4)
+	{
+		Video = Poly_CreateVideo();
+		return;
+	}
+
 #ifdef __APPLE__
 	SDL_SetHint(SDL_HINT_VIDEO_MAC_FULLSCREEN_SPACES, "0");
 #endif // __APPLE__
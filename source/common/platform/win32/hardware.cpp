@@ -44,6 +44,7 @@
 #include "version.h"
 #include "printf.h"
 #include "win32glvideo.h"
+#include "poly_framebuffer.h"
 #ifdef HAVE_VULKAN
 #include "win32vulkanvideo.h"
 #endif
@@ -90,6 +91,12 @@ void I_InitGraphics ()
 		// are the active app. Huh?
 	}
 
+	// The software rasterizer does not render into the window.
+	if (V_GetBackend() == 4)
+	{
+		Video = Poly_CreateVideo();
+	}
+	else
 #ifdef HAVE_VULKAN
 	if (V_GetBackend() == 1)
 	{
@@ -37,6 +37,7 @@
 
 #include "c_cvars.h"
 #include "hw_material.h"
+#include "hw_texcompress.h"
 
 #include "gl_interface.h"
 #include "hw_cvars.h"
@@ -161,11 +162,14 @@ unsigned int FHardwareTexture::CreateTexture(unsigned char * buffer, int w, int
 		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	}
 
+	size_t size = size_t(rw) * rh * (glTextureBytes > 0 ? glTextureBytes : 4);
 	if (mipmap && TexFilter[gl_texture_filter].mipmapping)
 	{
 		glGenerateMipmap(GL_TEXTURE_2D);
 		mipmapped = true;
+		size += size / 3;
 	}
+	SetAllocatedSize(size);
 
 	if (texunit > 0) glActiveTexture(GL_TEXTURE0);
 	else if (texunit == -1) glBindTexture(GL_TEXTURE_2D, textureBinding);
@@ -173,6 +177,42 @@ unsigned int FHardwareTexture::CreateTexture(unsigned char * buffer, int w, int
 }
 
 
+//===========================================================================
+// 
+//	Uploads a block compressed texture. These always come with the full
+//	mip chain because glGenerateMipmap cannot be used on them.
+//
+//===========================================================================
+
+unsigned int FHardwareTexture::CreateCompressedTexture(const FCompressedTexture &tex, int texunit, const char *name)
+{
+	if (glTexID == 0)
+	{
+		glGenTextures(1, &glTexID);
+	}
+
+	int textureBinding = UINT_MAX;
+	if (texunit == -1)	glGetIntegerv(GL_TEXTURE_BINDING_2D, &textureBinding);
+	if (texunit > 0) glActiveTexture(GL_TEXTURE0+texunit);
+	if (texunit >= 0) lastbound[texunit] = glTexID;
+	glBindTexture(GL_TEXTURE_2D, glTexID);
+
+	FGLDebug::LabelObject(GL_TEXTURE, glTexID, name);
+
+	int texformat = tex.Format == TEXCOMP_BC3 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	for (int i = 0; i < tex.NumLevels(); i++)
+	{
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, texformat, tex.LevelWidth(i), tex.LevelHeight(i), 0, tex.LevelSize(i), tex.LevelData(i));
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, tex.NumLevels() - 1);
+	mipmapped = true;
+	SetAllocatedSize(tex.Data.Size());
+
+	if (texunit > 0) glActiveTexture(GL_TEXTURE0);
+	else if (texunit == -1) glBindTexture(GL_TEXTURE_2D, textureBinding);
+	return glTexID;
+}
+
 //===========================================================================
 // 
 //
@@ -329,7 +369,16 @@ bool FHardwareTexture::BindOrCreate(FTexture *tex, int texunit, int clampmode, i
 			w = tex->GetWidth();
 			h = tex->GetHeight();
 		}
-		if (!CreateTexture(texbuffer.mBuffer, w, h, texunit, needmipmap, "FHardwareTexture.BindOrCreate"))
+		FCompressedTexture compressed;
+		if ((gl.flags & RFL_TEXTURE_COMPRESSION_S3TC) && GetTexDimension(w) == w && GetTexDimension(h) == h && ShouldCompressTexture(w, h, flags) &&
+			CompressTexture(texbuffer.mBuffer, w, h, true, compressed))
+		{
+			if (!CreateCompressedTexture(compressed, texunit, "FHardwareTexture.BindOrCreate"))
+			{
+				return false;
+			}
+		}
+		else if (!CreateTexture(texbuffer.mBuffer, w, h, texunit, needmipmap, "FHardwareTexture.BindOrCreate"))
 		{
 			// could not create texture
 			return false;
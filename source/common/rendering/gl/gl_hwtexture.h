@@ -18,6 +18,7 @@ class FTexture;
 #include "hw_ihwtexture.h"
 
 class FCanvasTexture;
+struct FCompressedTexture;
 
 namespace OpenGLRenderer
 {
@@ -69,6 +70,7 @@ public:
 	uint8_t* MapBuffer();
 
 	unsigned int CreateTexture(unsigned char* buffer, int w, int h, int texunit, bool mipmap, const char* name);
+	unsigned int CreateCompressedTexture(const FCompressedTexture &tex, int texunit, const char* name);
 	unsigned int GetTextureHandle()
 	{
 		return glTexID;
@@ -174,11 +174,14 @@ unsigned int FHardwareTexture::CreateTexture(unsigned char * buffer, int w, int
 
 	if (deletebuffer && buffer) free(buffer);
 
+	size_t size = size_t(rw) * rh * (glTextureBytes > 0 ? glTextureBytes : 4);
 	if (mipmap && TexFilter[gl_texture_filter].mipmapping)
 	{
 		glGenerateMipmap(GL_TEXTURE_2D);
 		mipmapped = true;
+		size += size / 3;
 	}
+	SetAllocatedSize(size);
 
 	if (texunit > 0) glActiveTexture(GL_TEXTURE0);
 	else if (texunit == -1) glBindTexture(GL_TEXTURE_2D, textureBinding);
@@ -533,6 +533,11 @@ public:
 			mStreamData.uTextureBlendColor = texfx->BlendColor;
 		}
 	}
+
+	bool HasTextureManipulation() const
+	{
+		return mStreamData.uTextureAddColor.a != 0;
+	}
 	void SetTextureColors(float* modColor, float* addColor, float* blendColor)
 	{
 		mStreamData.uTextureAddColor.SetFlt(addColor[0], addColor[1], addColor[2], addColor[3]);
@@ -612,6 +617,7 @@ public:
 private:
 	void SetMaterial(FMaterial *mat, int clampmode, int translation, int overrideshader)
 	{
+		mat->MarkUsed();
 		mMaterial.mMaterial = mat;
 		mMaterial.mClampMode = clampmode;
 		mMaterial.mTranslation = translation;
@@ -630,6 +636,12 @@ public:
 		{
 			if (shouldUpscale(tex, upscalemask)) scaleflags |= CTF_Upscale;
 		}
+		if (scaleflags & CTF_Indexed)
+		{
+			// Indexed textures get their color from a palette lookup in the shader, so the index texels must never be filtered.
+			if (clampmode <= CLAMP_XY) clampmode += CLAMP_NOFILTER;
+			else if (clampmode == CLAMP_XY_NOMIP) clampmode = CLAMP_NOFILTER_XY;
+		}
 		auto mat = FMaterial::ValidateTexture(tex, scaleflags);
 		assert(mat);
 		SetMaterial(mat, clampmode, translation, overrideshader);
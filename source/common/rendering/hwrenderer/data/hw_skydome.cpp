@@ -456,12 +456,12 @@ void FSkyVertexBuffer::RenderRow(FRenderState& state, EDrawType prim, int row, T
 //
 //-----------------------------------------------------------------------------
 
-void FSkyVertexBuffer::DoRenderDome(FRenderState& state, FGameTexture* tex, int mode, bool which, PalEntry color)
+void FSkyVertexBuffer::DoRenderDome(FRenderState& state, FGameTexture* tex, int mode, bool which, PalEntry color, int translation)
 {
 	auto& primStart = which ? mPrimStartBuild : mPrimStartDoom;
 	if (tex && tex->isValid())
 	{
-		state.SetMaterial(tex, UF_Texture, 0, CLAMP_NONE, 0, -1);
+		state.SetMaterial(tex, UF_Texture, 0, CLAMP_NONE, translation, -1);
 		state.EnableModelMatrix(true);
 		state.EnableTextureMatrix(true);
 	}
@@ -506,13 +506,13 @@ void FSkyVertexBuffer::DoRenderDome(FRenderState& state, FGameTexture* tex, int
 //
 //-----------------------------------------------------------------------------
 
-void FSkyVertexBuffer::RenderDome(FRenderState& state, FGameTexture* tex, float x_offset, float y_offset, bool mirror, int mode, bool tiled, float xscale, float yscale, PalEntry color)
+void FSkyVertexBuffer::RenderDome(FRenderState& state, FGameTexture* tex, float x_offset, float y_offset, bool mirror, int mode, bool tiled, float xscale, float yscale, PalEntry color, int translation)
 {
 	if (tex)
 	{
 		SetupMatrices(tex, x_offset, y_offset, mirror, mode, state.mModelMatrix, state.mTextureMatrix, tiled, xscale, yscale);
 	}
-	DoRenderDome(state, tex, mode, false, color);
+	DoRenderDome(state, tex, mode, false, color, translation);
 }
 
 
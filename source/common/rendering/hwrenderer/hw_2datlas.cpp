@@ -0,0 +1,268 @@
+/*
+** hw_2datlas.cpp
+** Runtime texture atlas for small 2D graphics
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The pages store the exact buffer the backend would have uploaded for the
+** texture/translation/scale flags combination, so drawing from the atlas
+** yields the same result as drawing the texture itself. Each entry gets a
+** one pixel border of replicated edge texels so that linear filtering
+** behaves like the clamped sampler used for 2D.
+**
+*/
+
+#include "hw_2datlas.h"
+#include "gametexture.h"
+#include "texturemanager.h"
+#include "bitmap.h"
+
+F2DAtlas TwoDAtlas;
+
+//==========================================================================
+//
+// The page texture. Its contents are created from system memory each
+// time the page is changed, just like the burn wipe's texture.
+//
+//==========================================================================
+
+class F2DAtlasPage : public FTexture
+{
+public:
+	TArray<uint8_t> Pixels;
+
+	F2DAtlasPage()
+		: Pixels(F2DAtlas::PageSize * F2DAtlas::PageSize * 4, true)
+	{
+		Width = F2DAtlas::PageSize;
+		Height = F2DAtlas::PageSize;
+		Masked = true;
+		bTranslucent = true;
+		memset(Pixels.Data(), 0, Pixels.Size());
+	}
+
+	FBitmap GetBgraBitmap(const PalEntry*, int *trans) override
+	{
+		FBitmap bmp;
+		bmp.Create(Width, Height);
+		bmp.CopyPixelDataRGB(0, 0, Pixels.Data(), Width, Height, 4, Width * 4, 0, CF_BGRA, nullptr);
+		if (trans) *trans = 0;
+		return bmp;
+	}
+};
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+FGameTexture *F2DAtlas::GetTexture(FTexture *tex, int translation, int scaleflags, FVector4 &rect)
+{
+	if (Excluded.CheckKey(tex)) return nullptr;
+	auto &list = Entries[tex];
+	for (auto &entry : list)
+	{
+		if (entry.Translation == translation && entry.ScaleFlags == scaleflags)
+		{
+			if (entry.Page < 0) return nullptr;
+			rect = entry.Rect;
+			return Pages[entry.Page].GameTexture;
+		}
+	}
+
+	Entry entry = { translation, scaleflags, -1, {} };
+	if (tex->GetWidth() <= MaxTextureSize && tex->GetHeight() <= MaxTextureSize)
+	{
+		auto texbuffer = tex->CreateTexBuffer(translation, scaleflags | CTF_ProcessData);
+		if (texbuffer.mBuffer != nullptr && texbuffer.mWidth <= MaxTextureSize && texbuffer.mHeight <= MaxTextureSize)
+		{
+			Insert(texbuffer, entry);
+		}
+	}
+	list.Push(entry);
+
+	if (entry.Page < 0) return nullptr;
+	rect = entry.Rect;
+	return Pages[entry.Page].GameTexture;
+}
+
+//==========================================================================
+//
+// Copies the texture buffer into the first page with enough room.
+//
+//==========================================================================
+
+bool F2DAtlas::Insert(FTextureBuffer &texbuffer, Entry &entry)
+{
+	int w = texbuffer.mWidth;
+	int h = texbuffer.mHeight;
+	int x = 0, y = 0;
+	unsigned pagenum;
+
+	for (pagenum = 0; pagenum < Pages.Size(); pagenum++)
+	{
+		if (Allocate(Pages[pagenum], w + 2, h + 2, x, y)) break;
+	}
+	if (pagenum == Pages.Size())
+	{
+		if (Pages.Size() >= MaxPages) return false;
+
+		auto pagetex = new F2DAtlasPage;
+		auto gametex = MakeGameTexture(pagetex, nullptr, ETextureType::Special);
+		TexMan.AddGameTexture(gametex, false);
+		Pages.Push({ pagetex, gametex, {}, 0, false });
+		if (!Allocate(Pages[pagenum], w + 2, h + 2, x, y)) return false;
+	}
+
+	auto &page = Pages[pagenum];
+	const uint8_t *src = texbuffer.mBuffer;
+	for (int yy = -1; yy <= h; yy++)
+	{
+		const uint8_t *srcline = src + clamp(yy, 0, h - 1) * w * 4;
+		uint8_t *dest = &page.Texture->Pixels[((y + 1 + yy) * PageSize + x) * 4];
+		for (int xx = -1; xx <= w; xx++)
+		{
+			memcpy(dest, srcline + clamp(xx, 0, w - 1) * 4, 4);
+			dest += 4;
+		}
+	}
+	page.Dirty = true;
+
+	entry.Page = pagenum;
+	entry.Rect = { float(x + 1) / PageSize, float(y + 1) / PageSize, float(x + 1 + w) / PageSize, float(y + 1 + h) / PageSize };
+	return true;
+}
+
+//==========================================================================
+//
+// Simple shelf packer. Heights are rounded up so that similar sized
+// graphics, like the glyphs of a font, end up on the same shelf.
+//
+//==========================================================================
+
+bool F2DAtlas::Allocate(Page &page, int w, int h, int &x, int &y)
+{
+	int height = (h + 3) & ~3;
+	for (auto &shelf : page.Shelves)
+	{
+		if (shelf.Height == height && shelf.X + w <= PageSize)
+		{
+			x = shelf.X;
+			y = shelf.Y;
+			shelf.X += w;
+			return true;
+		}
+	}
+	if (page.NextY + height > PageSize) return false;
+
+	page.Shelves.Push({ page.NextY, height, w });
+	x = 0;
+	y = page.NextY;
+	page.NextY += height;
+	return true;
+}
+
+//==========================================================================
+//
+// Called when a texture's contents change, e.g. a writable tile. Its atlas
+// copies are stale now. Such textures tend to change again, so instead of
+// filling the pages with new copies they get drawn by themselves from now on.
+//
+//==========================================================================
+
+void F2DAtlas::Invalidate(FTexture *tex)
+{
+	auto list = Entries.CheckKey(tex);
+	if (list == nullptr) return;
+	for (auto &entry : *list)
+	{
+		if (entry.Page >= 0)
+		{
+			Excluded.Insert(tex, true);
+			break;
+		}
+	}
+	Entries.Remove(tex);
+}
+
+//==========================================================================
+//
+// If the texture manager flushed all hardware textures, the translations
+// or the texture processing settings may have changed, so all entries
+// must be recreated. A page merely losing its hardware texture, e.g. to
+// gl_texture_budget, does not matter because it gets recreated from the
+// page's pixels.
+//
+//==========================================================================
+
+void F2DAtlas::CheckFlushed()
+{
+	if (FlushCount != TexMan.GetFlushCount())
+	{
+		FlushCount = TexMan.GetFlushCount();
+		Clear();
+	}
+}
+
+//==========================================================================
+//
+// Changed pages have to be recreated by the backend.
+//
+//==========================================================================
+
+void F2DAtlas::UpdatePages()
+{
+	for (auto &page : Pages)
+	{
+		if (page.Dirty)
+		{
+			page.GameTexture->CleanHardwareData();
+			page.Dirty = false;
+		}
+	}
+}
+
+//==========================================================================
+//
+// The old pages are not reused, because a locked 2D drawer, e.g. during a
+// wipe or a screen fade, may still reference them and would show different
+// graphics if they got overwritten. They are owned by the texture manager
+// and keep their contents, new pages get created as needed. This only
+// happens when all textures get flushed, so the amount of memory held by
+// discarded pages stays small.
+//
+//==========================================================================
+
+void F2DAtlas::Clear()
+{
+	Entries.Clear();
+	Excluded.Clear();
+	Pages.Clear();
+}
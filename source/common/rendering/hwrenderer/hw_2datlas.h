@@ -0,0 +1,75 @@
+#pragma once
+
+#include "tarray.h"
+#include "vectors.h"
+#include "textures.h"
+
+class FGameTexture;
+class F2DAtlasPage;
+
+//==========================================================================
+//
+// Runtime texture atlas for small 2D graphics.
+//
+// HUD pieces, status bar tiles and font glyphs are mostly tiny and drawn in
+// long runs that constantly change textures, which prevents F2DDrawer from
+// merging them. The atlas copies the fully processed texel data of such
+// textures into a few large pages, so that these runs can be drawn from a
+// single texture.
+//
+//==========================================================================
+
+class F2DAtlas
+{
+public:
+	enum
+	{
+		PageSize = 1024,
+		MaxTextureSize = 128,
+		MaxPages = 4,
+	};
+
+	// Returns the page holding the texture and its texture coordinates on it,
+	// or nullptr if the texture could not be placed.
+	FGameTexture *GetTexture(FTexture *tex, int translation, int scaleflags, FVector4 &rect);
+
+	void Invalidate(FTexture *tex);
+	void CheckFlushed();
+	void UpdatePages();
+	void Clear();
+
+	int NumPages() const { return Pages.Size(); }
+
+private:
+	struct Entry
+	{
+		int Translation;
+		int ScaleFlags;
+		int Page;	// -1 if the texture cannot be placed.
+		FVector4 Rect;
+	};
+
+	struct Shelf
+	{
+		int Y, Height, X;
+	};
+
+	struct Page
+	{
+		F2DAtlasPage *Texture;
+		FGameTexture *GameTexture;
+		TArray<Shelf> Shelves;
+		int NextY;
+		bool Dirty;
+	};
+
+	bool Insert(FTextureBuffer &texbuffer, Entry &entry);
+	bool Allocate(Page &page, int w, int h, int &x, int &y);
+
+	TArray<Page> Pages;
+	TMap<FTexture *, TArray<Entry>> Entries;
+	TMap<FTexture *, bool> Excluded;
+	int FlushCount = 0;
+};
+
+extern F2DAtlas TwoDAtlas;
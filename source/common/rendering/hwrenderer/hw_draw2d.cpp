@@ -42,6 +42,8 @@
 #include "hw_renderstate.h"
 #include "r_videoscale.h"
 #include "v_draw.h"
+#include "i_interface.h"
+#include "hw_2datlas.h"
 
 //===========================================================================
 // 
@@ -50,6 +52,111 @@
 //===========================================================================
 
 CVAR(Bool, gl_aalines, false, CVAR_ARCHIVE) 
+CVAR(Bool, gl_2datlas, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+static int twoDRequested, twoDCommands, twoDDrawCalls;
+static int lastRequested, lastCommands, lastDrawCalls;
+
+//===========================================================================
+// 
+// Moves small textures into the atlas and merges the runs of commands
+// that can share an atlas page afterwards. This changes the vertices, so
+// it may only be done on the first pass over a drawer's data.
+//
+//===========================================================================
+
+static void EndStats(F2DDrawer* drawer)
+{
+	// The screen's drawer is always the last one of a frame.
+	if (drawer == twod)
+	{
+		lastRequested = twoDRequested;
+		lastCommands = twoDCommands;
+		lastDrawCalls = twoDDrawCalls;
+		twoDRequested = twoDCommands = twoDDrawCalls = 0;
+	}
+}
+
+static bool MapToAtlas(F2DDrawer* drawer, F2DDrawer::RenderCommand& cmd, FRenderState& state)
+{
+	if (cmd.isSpecial != SpecialDrawCommand::NotSpecial || cmd.shape2DBufInfo != nullptr || cmd.mType != F2DDrawer::DrawTypeTriangles) return false;
+	if (cmd.mFlags & (F2DDrawer::DTF_Wrap | F2DDrawer::DTF_Indexed | F2DDrawer::DTF_Burn)) return false;
+
+	auto tex = cmd.mTexture;
+	if (tex == nullptr || !tex->isValid() || tex->GetUseType() >= ETextureType::Special || tex->isHardwareCanvas()) return false;
+
+	auto vertices = &drawer->mVertices[cmd.mVertIndex];
+	for (int i = 0; i < cmd.mVertCount; i++)
+	{
+		if (vertices[i].u < 0 || vertices[i].u > 1 || vertices[i].v < 0 || vertices[i].v > 1) return false;
+	}
+
+	// Resolve the texture the same way SetMaterial does. Anything that needs more than the plain texel data cannot be moved to the atlas.
+	EUpscaleFlags flags = tex->GetUseType() == ETextureType::FontChar ? UF_Font : UF_Texture;
+	int scaleflags = 0, clampmode = CLAMP_XY_NOMIP, translation = cmd.mTranslationId, overrideshader = -1;
+	state.SetFog(cmd.mColor1, 0);
+	if (!sysCallbacks.PreBindTexture || !sysCallbacks.PreBindTexture(&state, tex, flags, scaleflags, clampmode, translation, overrideshader))
+	{
+		if (shouldUpscale(tex, flags)) scaleflags |= CTF_Upscale;
+	}
+	if ((scaleflags & CTF_Indexed) || state.HasTextureManipulation()) return false;
+	if (tex->isWarped() || tex->isHardwareCanvas() || tex->GetShaderIndex() != SHADER_Default) return false;
+
+	TArray<FTexture*> layers;
+	tex->CreateDefaultBrightmap();
+	tex->GetLayers(layers);
+	if (layers.Size() != 1) return false;
+
+	FVector4 rect;
+	auto page = TwoDAtlas.GetTexture(tex->GetTexture(), translation, scaleflags, rect);
+	if (page == nullptr) return false;
+
+	for (int i = 0; i < cmd.mVertCount; i++)
+	{
+		vertices[i].u = rect.X + vertices[i].u * (rect.Z - rect.X);
+		vertices[i].v = rect.Y + vertices[i].v * (rect.W - rect.Y);
+	}
+	// The atlas bypasses SetMaterial for the texture itself.
+	tex->setSeen();
+	tex->MarkUsed();
+	cmd.mTexture = page;
+	cmd.mTranslationId = 0;
+	return true;
+}
+
+static void Batch2DCommands(F2DDrawer* drawer, FRenderState& state)
+{
+	auto &commands = drawer->mData;
+	bool mapped = false;
+
+	TwoDAtlas.CheckFlushed();
+	for (auto &cmd : commands)
+	{
+		mapped |= MapToAtlas(drawer, cmd, state);
+	}
+	TwoDAtlas.UpdatePages();
+	state.ApplyTextureManipulation(nullptr);
+	state.SetFog(0, 0);
+	if (!mapped) return;
+
+	unsigned count = 1;
+	for (unsigned i = 1; i < commands.Size(); i++)
+	{
+		auto &last = commands[count - 1];
+		auto &cmd = commands[i];
+		if (last.isCompatible(cmd) && last.mIndexIndex + last.mIndexCount == cmd.mIndexIndex && last.mVertIndex + last.mVertCount == cmd.mVertIndex)
+		{
+			last.mIndexCount += cmd.mIndexCount;
+			last.mVertCount += cmd.mVertCount;
+		}
+		else
+		{
+			if (count != i) commands[count] = cmd;
+			count++;
+		}
+	}
+	commands.Clamp(count);
+}
 
 void Draw2D(F2DDrawer* drawer, FRenderState& state)
 {
@@ -77,6 +184,7 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 
 	if (commands.Size() == 0)
 	{
+		EndStats(drawer);
 		twoD.Unclock();
 		return;
 	}
@@ -88,7 +196,11 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 			// Change from BGRA to RGBA
 			std::swap(v.color0.r, v.color0.b);
 		}
+		twoDRequested += drawer->mRequestedCount;
+		twoDCommands += commands.Size();
+		if (gl_2datlas) Batch2DCommands(drawer, state);
 	}
+	twoDDrawCalls += commands.Size();
 	F2DVertexBuffer vb;
 	vb.UploadData(&vertices[0], vertices.Size(), &indices[0], indices.Size());
 	state.SetVertexBuffer(&vb);
@@ -204,7 +316,7 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 		if (cmd.shape2DBufInfo != nullptr)
 		{
 			state.SetVertexBuffer(&cmd.shape2DBufInfo->buffers[cmd.shape2DBufIndex]);
-			state.DrawIndexed(DT_Triangles, 0, cmd.shape2DIndexCount);
+			state.DrawIndexed(cmd.mType == F2DDrawer::DrawTypeLines ? DT_Lines : DT_Triangles, 0, cmd.shape2DIndexCount);
 			state.SetVertexBuffer(&vb);
 			if (cmd.shape2DCommandCounter == cmd.shape2DBufInfo->lastCommand)
 			{
@@ -259,5 +371,14 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 	state.SetSoftLightLevel(255);
 	state.ResetColor();
 	drawer->mIsFirstPass = false;
+
+	EndStats(drawer);
 	twoD.Unclock();
 }
+
+ADD_STAT(draw2d)
+{
+	FString out;
+	out.Format("2D draws: %d requested, %d after merging, %d draw calls, %d atlas pages", lastRequested, lastCommands, lastDrawCalls, TwoDAtlas.NumPages());
+	return out;
+}
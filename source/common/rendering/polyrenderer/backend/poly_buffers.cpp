@@ -0,0 +1,118 @@
+/*
+** poly_buffers.cpp
+** System memory buffers for the software rasterizer backend
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include <string.h>
+
+#include "poly_buffers.h"
+#include "poly_renderstate.h"
+#include "shaderuniforms.h"
+
+//==========================================================================
+//
+// Since nothing is ever uploaded anywhere the memory can stay mapped
+// permanently. Lock/Unlock therefore only need to make sure the size fits.
+//
+//==========================================================================
+
+void PolyBuffer::SetData(size_t size, const void *data, BufferUsageType usage)
+{
+	mData.Resize((unsigned)size);
+	if (data != nullptr && size > 0) memcpy(mData.Data(), data, size);
+	else if (size > 0) memset(mData.Data(), 0, size);
+	buffersize = size;
+	map = mData.Data();
+}
+
+void PolyBuffer::SetSubData(size_t offset, size_t size, const void *data)
+{
+	assert(offset + size <= buffersize);
+	memcpy(mData.Data() + offset, data, size);
+}
+
+void PolyBuffer::Resize(size_t newsize)
+{
+	if (newsize > buffersize)
+	{
+		size_t oldsize = buffersize;
+		mData.Resize((unsigned)newsize);
+		memset(mData.Data() + oldsize, 0, newsize - oldsize);
+		buffersize = newsize;
+		map = mData.Data();
+	}
+}
+
+void *PolyBuffer::Lock(unsigned int size)
+{
+	if (size > buffersize) SetData(size, nullptr, BufferUsageType::Mappable);
+	return map;
+}
+
+void PolyBuffer::Unlock()
+{
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void PolyVertexBuffer::SetFormat(int numBindingPoints, int numAttributes, size_t stride, const FVertexBufferAttribute *attrs)
+{
+	for (auto &attr : mAttributes) attr.enabled = false;
+	for (int i = 0; i < numAttributes; i++)
+	{
+		auto &attr = mAttributes[attrs[i].location];
+		attr.enabled = true;
+		attr.binding = attrs[i].binding;
+		attr.format = attrs[i].format;
+		attr.offset = attrs[i].offset;
+	}
+	mStride = stride;
+}
+
+//==========================================================================
+//
+// Only the viewpoint uniforms are of interest here. Lights and bones
+// are not supported by the software backend.
+//
+//==========================================================================
+
+void PolyDataBuffer::BindRange(FRenderState *state, size_t start, size_t length)
+{
+	if (mBindingPoint == VIEWPOINT_BINDINGPOINT)
+	{
+		static_cast<PolyRenderState*>(state)->SetViewpointUniforms(this, start);
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "buffers.h"
+#include "tarray.h"
+
+class PolyRenderState;
+
+//==========================================================================
+//
+// Buffers for the software backend are plain system memory that stays
+// mapped for its entire lifetime. Vertex processing reads them directly.
+//
+//==========================================================================
+
+class PolyBuffer : virtual public IBuffer
+{
+public:
+	void SetData(size_t size, const void *data, BufferUsageType usage) override;
+	void SetSubData(size_t offset, size_t size, const void *data) override;
+	void Resize(size_t newsize) override;
+	void *Lock(unsigned int size) override;
+	void Unlock() override;
+
+	const uint8_t *Data() const { return mData.Data(); }
+
+protected:
+	TArray<uint8_t> mData;
+};
+
+class PolyVertexBuffer : public IVertexBuffer, public PolyBuffer
+{
+public:
+	struct PolyVertexAttribute
+	{
+		bool enabled;
+		int binding;
+		int format;
+		int offset;
+	};
+
+	void SetFormat(int numBindingPoints, int numAttributes, size_t stride, const FVertexBufferAttribute *attrs) override;
+
+	const PolyVertexAttribute &Attribute(int location) const { return mAttributes[location]; }
+	size_t Stride() const { return mStride; }
+
+private:
+	PolyVertexAttribute mAttributes[VATTR_MAX] = {};
+	size_t mStride = 0;
+};
+
+class PolyIndexBuffer : public IIndexBuffer, public PolyBuffer
+{
+};
+
+class PolyDataBuffer : public IDataBuffer, public PolyBuffer
+{
+public:
+	PolyDataBuffer(int bindingpoint) : mBindingPoint(bindingpoint) {}
+	void BindRange(FRenderState *state, size_t start, size_t length) override;
+
+private:
+	int mBindingPoint;
+};
@@ -0,0 +1,381 @@
+/*
+** poly_framebuffer.cpp
+** Headless frame buffer using the software rasterizer backend
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Not supported: post processing, fog, dynamic lights, camera textures,
+** palette emulation shaders and texture filtering. Everything that is
+** supported produces the same output regardless of r_multithreaded.
+**
+*/
+
+#include "poly_framebuffer.h"
+#include "poly_renderstate.h"
+#include "poly_buffers.h"
+#include "poly_hwtexture.h"
+#include "v_draw.h"
+#include "hw_clock.h"
+#include "hw_skydome.h"
+#include "hw_viewpointbuffer.h"
+#include "hw_lightbuffer.h"
+#include "hw_bonebuffer.h"
+#include "flatvertices.h"
+#include "printf.h"
+#include "i_video.h"
+#include "c_cvars.h"
+
+EXTERN_CVAR(Int, vid_defwidth)
+EXTERN_CVAR(Int, vid_defheight)
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void PolyFrameBuffer::Target::Resize(int w, int h)
+{
+	if (w != Width || h != Height)
+	{
+		Width = w;
+		Height = h;
+		Color.Resize(w * h);
+		Depth.Resize(w * h);
+		Stencil.Resize(w * h);
+	}
+}
+
+void PolyFrameBuffer::Target::ClearAll()
+{
+	memset(Color.Data(), 0, Color.Size() * sizeof(uint32_t));
+	for (auto &d : Depth) d = 1.0f;
+	memset(Stencil.Data(), 0, Stencil.Size());
+}
+
+PolyRenderTarget PolyFrameBuffer::Target::Get()
+{
+	PolyRenderTarget target;
+	target.Color = Color.Data();
+	target.Depth = Depth.Data();
+	target.Stencil = Stencil.Data();
+	target.Width = Width;
+	target.Height = Height;
+	return target;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+class PolyVideo : public IVideo
+{
+public:
+	DFrameBuffer *CreateFrameBuffer() override
+	{
+		return new PolyFrameBuffer(vid_defwidth, vid_defheight);
+	}
+};
+
+IVideo *Poly_CreateVideo()
+{
+	return new PolyVideo;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+PolyFrameBuffer::PolyFrameBuffer(int width, int height)
+	: Super(width, height)
+{
+	ClientWidth = width;
+	ClientHeight = height;
+}
+
+PolyFrameBuffer::~PolyFrameBuffer()
+{
+	if (mRenderState) mRenderState->Flush();
+
+	if (mVertexData != nullptr) delete mVertexData;
+	if (mSkyData != nullptr) delete mSkyData;
+	if (mViewpoints != nullptr) delete mViewpoints;
+	if (mLights != nullptr) delete mLights;
+	if (mBones != nullptr) delete mBones;
+	mShadowMap.Reset();
+}
+
+void PolyFrameBuffer::InitializeState()
+{
+	// All buffers live in system memory and are always mapped.
+	hwcaps = RFL_BUFFER_STORAGE | RFL_NO_CLIP_PLANES | RFL_NO_INDEXED_TEXTURES;
+	glslversion = 4.50f;
+	uniformblockalignment = 16;
+	maxuniformblock = 0x7fffffff;
+	vendorstring = "Raze";
+
+	mRenderState.reset(new PolyRenderState);
+
+	SetViewportRects(nullptr);
+	mScreenTarget.Resize(GetWidth(), GetHeight());
+	mScreenTarget.ClearAll();
+	mRenderState->SetRenderTarget(mScreenTarget.Get());
+
+	mVertexData = new FFlatVertexBuffer(GetWidth(), GetHeight(), screen->mPipelineNbr);
+	mSkyData = new FSkyVertexBuffer;
+	mViewpoints = new HWViewpointBuffer(screen->mPipelineNbr);
+	mLights = new FLightBuffer(screen->mPipelineNbr);
+	mBones = new BoneBuffer(screen->mPipelineNbr);
+
+	Printf("Using the software rasterizer, %d x %d\n", GetWidth(), GetHeight());
+}
+
+void PolyFrameBuffer::SetWindowSize(int w, int h)
+{
+	ClientWidth = max(w, VID_MIN_WIDTH);
+	ClientHeight = max(h, VID_MIN_HEIGHT);
+}
+
+//==========================================================================
+//
+// There is nothing to present so this only has to finish the frame.
+//
+//==========================================================================
+
+void PolyFrameBuffer::Update()
+{
+	twoD.Reset();
+	Flush3D.Reset();
+
+	Flush3D.Clock();
+	mRenderState->EndFrame();
+	Flush3D.Unclock();
+
+	FPSLimit();
+	Super::Update();
+}
+
+void PolyFrameBuffer::BeginFrame()
+{
+	SetViewportRects(nullptr);
+	mViewpoints->Clear();
+
+	mRenderState->Flush();
+	int width = max(GetWidth(), mScreenViewport.left + mScreenViewport.width);
+	int height = max(GetHeight(), mScreenViewport.top + mScreenViewport.height);
+	mScreenTarget.Resize(width, height);
+	mScreenTarget.ClearAll();
+	mRenderState->SetRenderTarget(mScreenTarget.Get());
+
+	mRenderState->DrawCalls = 0;
+	mRenderState->TrianglesSubmitted = 0;
+	mRenderState->TrianglesRasterized = 0;
+}
+
+void PolyFrameBuffer::WaitForCommands(bool finish)
+{
+	mRenderState->Flush();
+}
+
+//==========================================================================
+//
+// Save pictures get rendered into a separate target so that they do not
+// destroy the frame currently being drawn.
+//
+//==========================================================================
+
+void PolyFrameBuffer::SetSaveBuffers(bool yes)
+{
+	if (!mRenderState) return;
+	mUseSaveTarget = yes;
+	if (yes)
+	{
+		mSaveTarget.Resize(mScreenTarget.Width, mScreenTarget.Height);
+		mSaveTarget.ClearAll();
+		mRenderState->SetRenderTarget(mSaveTarget.Get());
+	}
+	else
+	{
+		mRenderState->SetRenderTarget(mScreenTarget.Get());
+	}
+}
+
+void PolyFrameBuffer::CopyScreenToBuffer(int width, int height, uint8_t* scr)
+{
+	mRenderState->Flush();
+
+	// Rows are bottom up, just like glReadPixels returns them.
+	Target &target = mUseSaveTarget ? mSaveTarget : mScreenTarget;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			uint32_t c = (x < target.Width && y < target.Height) ? target.Color[x + y * target.Width] : 0;
+			*scr++ = (c >> 16) & 0xff;
+			*scr++ = (c >> 8) & 0xff;
+			*scr++ = c & 0xff;
+		}
+	}
+}
+
+//===========================================================================
+//
+//
+//
+//===========================================================================
+
+FRenderState* PolyFrameBuffer::RenderState()
+{
+	return mRenderState.get();
+}
+
+IHardwareTexture *PolyFrameBuffer::CreateHardwareTexture(int numchannels)
+{
+	return new PolyHardwareTexture(numchannels);
+}
+
+IVertexBuffer *PolyFrameBuffer::CreateVertexBuffer()
+{
+	return new PolyVertexBuffer;
+}
+
+IIndexBuffer *PolyFrameBuffer::CreateIndexBuffer()
+{
+	return new PolyIndexBuffer;
+}
+
+IDataBuffer *PolyFrameBuffer::CreateDataBuffer(int bindingpoint, bool ssbo, bool needsresize)
+{
+	return new PolyDataBuffer(bindingpoint);
+}
+
+//===========================================================================
+//
+//	Takes a screenshot
+//
+//===========================================================================
+
+TArray<uint8_t> PolyFrameBuffer::GetScreenshotBuffer(int &pitch, ESSType &color_type, float &gamma)
+{
+	mRenderState->Flush();
+
+	int w = SCREENWIDTH;
+	int h = SCREENHEIGHT;
+	TArray<uint8_t> ScreenshotBuffer(w * h * 3, true);
+
+	for (int y = 0; y < h; y++)
+	{
+		uint8_t *dest = &ScreenshotBuffer[y * w * 3];
+		int sy = h - y - 1;
+		for (int x = 0; x < w; x++)
+		{
+			uint32_t c = (x < mScreenTarget.Width && sy < mScreenTarget.Height) ? mScreenTarget.Color[x + sy * mScreenTarget.Width] : 0;
+			*dest++ = (c >> 16) & 0xff;
+			*dest++ = (c >> 8) & 0xff;
+			*dest++ = c & 0xff;
+		}
+	}
+
+	pitch = w * 3;
+	color_type = SS_RGB;
+	gamma = 1;
+	return ScreenshotBuffer;
+}
+
+//===========================================================================
+//
+// 2D drawing
+//
+//===========================================================================
+
+void PolyFrameBuffer::Draw2D()
+{
+	::Draw2D(twod, *mRenderState);
+}
+
+//==========================================================================
+//
+// Wipe textures are stored top down, unlike OpenGL's, so RenderTextureIsFlipped
+// returns false.
+//
+//==========================================================================
+
+FTexture *PolyFrameBuffer::CopyScreenToTexture()
+{
+	mRenderState->Flush();
+
+	const auto &viewport = mScreenViewport;
+	auto tex = new FWrapperTexture(viewport.width, viewport.height, 1);
+	auto systex = tex->GetSystemTexture();
+	systex->CreateTexture(nullptr, viewport.width, viewport.height, 0, false, "WipeScreen");
+	uint32_t *dest = (uint32_t*)systex->MapBuffer();
+	for (int y = 0; y < viewport.height; y++)
+	{
+		int sy = viewport.top + viewport.height - y - 1;
+		for (int x = 0; x < viewport.width; x++)
+		{
+			int sx = viewport.left + x;
+			bool inside = sx < mScreenTarget.Width && sy >= 0 && sy < mScreenTarget.Height;
+			*dest++ = inside ? mScreenTarget.Color[sx + sy * mScreenTarget.Width] | 0xff000000 : 0xff000000;
+		}
+	}
+	return tex;
+}
+
+FTexture *PolyFrameBuffer::WipeStartScreen()
+{
+	return CopyScreenToTexture();
+}
+
+FTexture *PolyFrameBuffer::WipeEndScreen()
+{
+	return CopyScreenToTexture();
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+ADD_STAT(polystats)
+{
+	FString out;
+	auto state = screen != nullptr && screen->IsPoly() ? static_cast<PolyRenderState*>(screen->RenderState()) : nullptr;
+	if (state != nullptr)
+	{
+		out.Format("Draw calls: %d, Triangles: %d submitted, %d rasterized, Finish: %2.3f ms",
+			state->DrawCalls, state->TrianglesSubmitted, state->TrianglesRasterized, Flush3D.TimeMS());
+	}
+	return out;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "v_video.h"
+#include "poly_triangle.h"
+
+#include <memory>
+
+class PolyRenderState;
+class IVideo;
+
+// Creates the video interface for the software rasterizer. The platform code
+// uses it instead of its own one so that no window system gets initialized.
+IVideo *Poly_CreateVideo();
+
+//==========================================================================
+//
+// Frame buffer that renders everything on the CPU into system memory.
+//
+// It has no window and no presentation, so it works on machines without
+// any GPU or display. The output can only be observed through screenshots,
+// which makes it suited for automated regression comparisons.
+//
+//==========================================================================
+
+class PolyFrameBuffer : public DFrameBuffer
+{
+	typedef DFrameBuffer Super;
+
+public:
+	PolyFrameBuffer(int width, int height);
+	~PolyFrameBuffer();
+
+	bool IsPoly() override { return true; }
+	const char* DeviceName() const override { return "Software rasterizer"; }
+	void InitializeState() override;
+	void Update() override;
+
+	bool IsFullscreen() override { return false; }
+	int GetClientWidth() override { return ClientWidth; }
+	int GetClientHeight() override { return ClientHeight; }
+	void SetWindowSize(int w, int h) override;
+
+	FRenderState* RenderState() override;
+	IHardwareTexture *CreateHardwareTexture(int numchannels) override;
+	IVertexBuffer *CreateVertexBuffer() override;
+	IIndexBuffer *CreateIndexBuffer() override;
+	IDataBuffer *CreateDataBuffer(int bindingpoint, bool ssbo, bool needsresize) override;
+
+	void BeginFrame() override;
+	void WaitForCommands(bool finish) override;
+	void SetSaveBuffers(bool yes) override;
+	void CopyScreenToBuffer(int width, int height, uint8_t* buffer) override;
+	bool FlipSavePic() const override { return true; }
+	bool RenderTextureIsFlipped() const override { return false; }
+
+	TArray<uint8_t> GetScreenshotBuffer(int &pitch, ESSType &color_type, float &gamma) override;
+
+	void Draw2D() override;
+
+	FTexture *WipeStartScreen() override;
+	FTexture *WipeEndScreen() override;
+
+private:
+	struct Target
+	{
+		TArray<uint32_t> Color;
+		TArray<float> Depth;
+		TArray<uint8_t> Stencil;
+		int Width = 0;
+		int Height = 0;
+
+		void Resize(int w, int h);
+		void ClearAll();
+		PolyRenderTarget Get();
+	};
+
+	FTexture *CopyScreenToTexture();
+
+	std::unique_ptr<PolyRenderState> mRenderState;
+	Target mScreenTarget;
+	Target mSaveTarget;
+	bool mUseSaveTarget = false;
+
+	int ClientWidth;
+	int ClientHeight;
+};
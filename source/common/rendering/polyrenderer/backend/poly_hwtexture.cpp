@@ -0,0 +1,137 @@
+/*
+** poly_hwtexture.cpp
+** System memory textures for the software rasterizer backend
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include <string.h>
+
+#include "poly_hwtexture.h"
+#include "poly_renderstate.h"
+#include "textures.h"
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+PolyHardwareTexture::PolyHardwareTexture(int numchannels)
+{
+	mIndexed = numchannels == 1;
+}
+
+PolyHardwareTexture::~PolyHardwareTexture()
+{
+	// Queued draw commands may still reference the pixels.
+	PolyRenderState::FlushAll();
+
+	TMap<int, PolyTextureImage*>::Iterator it(mTranslated);
+	TMap<int, PolyTextureImage*>::Pair *pair;
+	while (it.NextPair(pair)) delete pair->Value;
+}
+
+//==========================================================================
+//
+// Direct uploads are used by wrapper textures (wipes, save pictures)
+// which always come as BGRA data.
+//
+//==========================================================================
+
+void PolyHardwareTexture::AllocateBuffer(int w, int h, int texelsize)
+{
+	if (mImage.Width != w || mImage.Height != h)
+	{
+		PolyRenderState::FlushAll();
+		mImage.Pixels.Resize(w * h);
+		mImage.Width = w;
+		mImage.Height = h;
+	}
+	bufferpitch = w;
+}
+
+uint8_t *PolyHardwareTexture::MapBuffer()
+{
+	return (uint8_t*)mImage.Pixels.Data();
+}
+
+unsigned int PolyHardwareTexture::CreateTexture(unsigned char *buffer, int w, int h, int texunit, bool mipmap, const char *name)
+{
+	AllocateBuffer(w, h, 4);
+	if (buffer != nullptr) memcpy(mImage.Pixels.Data(), buffer, w * h * 4);
+	else memset(mImage.Pixels.Data(), 0, w * h * 4);
+	return 1;
+}
+
+//==========================================================================
+//
+// Creates the image on first use, like BindOrCreate does for OpenGL.
+//
+//==========================================================================
+
+const PolyTextureImage *PolyHardwareTexture::GetImage(FTexture *tex, int translation, int flags)
+{
+	PolyTextureImage *image = &mImage;
+	if (mIndexed)
+	{
+		auto check = mTranslated.CheckKey(translation);
+		if (check != nullptr) return *check;
+		image = new PolyTextureImage;
+		mTranslated.Insert(translation, image);
+	}
+	else if (image->Width > 0)
+	{
+		return image;
+	}
+
+	FTextureBuffer texbuffer;
+	if (!tex->isHardwareCanvas())
+	{
+		texbuffer = tex->CreateTexBuffer(translation, (flags & ~CTF_Indexed) | CTF_ProcessData);
+	}
+
+	if (texbuffer.mBuffer != nullptr && texbuffer.mWidth > 0 && texbuffer.mHeight > 0)
+	{
+		image->Width = texbuffer.mWidth;
+		image->Height = texbuffer.mHeight;
+		image->Pixels.Resize(image->Width * image->Height);
+		memcpy(image->Pixels.Data(), texbuffer.mBuffer, image->Width * image->Height * 4);
+	}
+	else
+	{
+		// Camera textures are not rendered by this backend.
+		image->Width = max(tex->GetWidth(), 1);
+		image->Height = max(tex->GetHeight(), 1);
+		image->Pixels.Resize(image->Width * image->Height);
+		memset(image->Pixels.Data(), 0, image->Width * image->Height * 4);
+	}
+	return image;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "hw_ihwtexture.h"
+#include "tarray.h"
+
+class FTexture;
+
+struct PolyTextureImage
+{
+	TArray<uint32_t> Pixels;	// BGRA, top to bottom
+	int Width = 0;
+	int Height = 0;
+};
+
+class PolyHardwareTexture : public IHardwareTexture
+{
+public:
+	PolyHardwareTexture(int numchannels);
+	~PolyHardwareTexture();
+
+	void AllocateBuffer(int w, int h, int texelsize) override;
+	uint8_t *MapBuffer() override;
+	unsigned int CreateTexture(unsigned char *buffer, int w, int h, int texunit, bool mipmap, const char *name) override;
+
+	const PolyTextureImage *GetImage(FTexture *tex, int translation, int flags);
+
+private:
+	// Indexed textures share one hardware texture for all translations, but this
+	// backend has no palette shader so it keeps a true color image for each.
+	bool mIndexed;
+	PolyTextureImage mImage;
+	TMap<int, PolyTextureImage*> mTranslated;
+};
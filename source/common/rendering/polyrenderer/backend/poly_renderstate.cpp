@@ -0,0 +1,747 @@
+/*
+** poly_renderstate.cpp
+** Render state and vertex processing for the software rasterizer backend
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+*/
+
+#include <math.h>
+
+#include "poly_renderstate.h"
+#include "poly_buffers.h"
+#include "poly_hwtexture.h"
+#include "v_video.h"
+#include "hw_viewpointbuffer.h"
+#include "hw_viewpointuniforms.h"
+#include "hw_clock.h"
+#include "flatvertices.h"
+#include "hw_material.h"
+#include "texturemanager.h"
+
+PolyRenderState *PolyRenderState::Instance;
+
+// Triangles per draw command. Must stay well below the frame memory block size.
+static const int MaxBatchTriangles = 2048;
+// Commands collected before the queue is handed to the worker threads.
+static const int MaxQueuedCommands = 64;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+PolyRenderState::PolyRenderState()
+{
+	Reset();
+	Instance = this;
+	mQueue = std::make_shared<DrawerCommandQueue>(&mFrameMemory);
+}
+
+PolyRenderState::~PolyRenderState()
+{
+	Flush();
+	if (Instance == this) Instance = nullptr;
+}
+
+void PolyRenderState::SetRenderTarget(const PolyRenderTarget &target)
+{
+	Flush();
+	mTarget = target;
+}
+
+void PolyRenderState::SetViewpointUniforms(PolyDataBuffer *buffer, size_t offset)
+{
+	mViewpointBuffer = buffer;
+	mViewpointOffset = offset;
+}
+
+//==========================================================================
+//
+// Command submission
+//
+//==========================================================================
+
+void PolyRenderState::SubmitQueue()
+{
+	if (mQueuedCommands > 0)
+	{
+		DrawerThreads::Execute(mQueue);
+		mQueue = std::make_shared<DrawerCommandQueue>(&mFrameMemory);
+		mQueuedCommands = 0;
+	}
+}
+
+void PolyRenderState::Flush()
+{
+	FlushBatch();
+	SubmitQueue();
+	DrawerThreads::WaitForWorkers();
+}
+
+void PolyRenderState::EndFrame()
+{
+	Flush();
+	mArgs = nullptr;
+	mFrameMemory.Clear();
+}
+
+void PolyRenderState::FlushAll()
+{
+	if (Instance != nullptr) Instance->Flush();
+}
+
+void PolyRenderState::FlushBatch()
+{
+	if (mBatchCount > 0)
+	{
+		mQueue->Push<PolyDrawTrianglesCommand>(mTarget, mArgs, mBatch, mBatchCount);
+		TrianglesRasterized += mBatchCount;
+		mBatch = nullptr;
+		mBatchCount = 0;
+		if (++mQueuedCommands >= MaxQueuedCommands) SubmitQueue();
+	}
+}
+
+PolyVertex *PolyRenderState::AllocTriangle()
+{
+	if (mBatch == nullptr)
+	{
+		mBatch = mFrameMemory.AllocMemory<PolyVertex>(MaxBatchTriangles * 3);
+	}
+	PolyVertex *v = mBatch + mBatchCount * 3;
+	if (++mBatchCount == MaxBatchTriangles) FlushBatch();
+	return v;
+}
+
+//==========================================================================
+//
+// Snapshot of everything the fragment stage needs
+//
+//==========================================================================
+
+const PolyDrawArgs *PolyRenderState::CreateDrawArgs()
+{
+	auto args = mFrameMemory.NewObject<PolyDrawArgs>();
+
+	int tempTM = TM_NORMAL;
+	int clampmode = CLAMP_NONE;
+	args->Texture = nullptr;
+	if (mTextureEnabled && mMaterial.mMaterial != nullptr)
+	{
+		auto mat = mMaterial.mMaterial;
+		auto tex = mat->Source();
+		if (tex->isHardwareCanvas()) tempTM = TM_OPAQUE;
+		clampmode = tex->GetClampMode(mMaterial.mClampMode);
+
+		MaterialLayerInfo *layer;
+		auto base = static_cast<PolyHardwareTexture*>(mat->GetLayer(0, mMaterial.mTranslation, &layer));
+		if (base != nullptr) args->Texture = base->GetImage(tex->GetTexture(), mMaterial.mTranslation, layer->scaleFlags);
+	}
+
+	int mode = mTextureMode < 0 ? TM_NORMAL : mTextureMode;
+	if (mode == TM_NORMAL && tempTM == TM_OPAQUE) mode = TM_OPAQUE;
+	args->TextureMode = mode;
+	args->ClampY = mTextureClamp || (mTextureModeFlags & TEXF_ClampY);
+	args->ClampU = clampmode == CLAMP_X || clampmode == CLAMP_NOFILTER_X || clampmode == CLAMP_XY || clampmode == CLAMP_XY_NOMIP || clampmode == CLAMP_NOFILTER_XY || clampmode == CLAMP_CAMTEX;
+	args->ClampV = clampmode == CLAMP_Y || clampmode == CLAMP_NOFILTER_Y || clampmode == CLAMP_XY || clampmode == CLAMP_XY_NOMIP || clampmode == CLAMP_NOFILTER_XY || clampmode == CLAMP_CAMTEX;
+	args->AlphaThreshold = mAlphaThreshold;
+
+	auto &objcolor = mStreamData.uObjectColor;
+	args->ObjectColor[0] = objcolor.r;
+	args->ObjectColor[1] = objcolor.g;
+	args->ObjectColor[2] = objcolor.b;
+	args->ObjectColor[3] = objcolor.a;
+	// Untextured draws only use the object color, like func_notexture.fp
+	bool useAdd = args->Texture != nullptr;
+	args->AddColor[0] = useAdd ? mStreamData.uAddColor.r : 0.0f;
+	args->AddColor[1] = useAdd ? mStreamData.uAddColor.g : 0.0f;
+	args->AddColor[2] = useAdd ? mStreamData.uAddColor.b : 0.0f;
+	args->FogColor[0] = m2DMode ? mFogColor.r / 255.0f : 0.0f;
+	args->FogColor[1] = m2DMode ? mFogColor.g / 255.0f : 0.0f;
+	args->FogColor[2] = m2DMode ? mFogColor.b / 255.0f : 0.0f;
+	args->Fade = mStreamData.uDynLightColor.W;
+
+	args->SrcBlend = mRenderStyle.SrcAlpha % STYLEALPHA_MAX;
+	args->DestBlend = mRenderStyle.DestAlpha % STYLEALPHA_MAX;
+	args->BlendOp = mRenderStyle.BlendOp;
+	if (args->BlendOp >= STYLEOP_Fuzz)
+	{
+		// Same substitution as the OpenGL backend.
+		args->SrcBlend = STYLEALPHA_DstCol;
+		args->DestBlend = STYLEALPHA_InvSrc;
+		args->BlendOp = STYLEOP_Add;
+	}
+	else if (args->BlendOp == STYLEOP_None)
+	{
+		args->BlendOp = STYLEOP_Add;
+	}
+
+	args->DepthTest = mDepthTest;
+	args->DepthWrite = mDepthMask;
+	args->DepthFunc = mDepthFunc;
+	args->StencilTest = mStencilTest;
+	args->StencilRef = (uint8_t)mStencilValue;
+	args->StencilOp = mStencilOp;
+	args->ColorMask = mColorMask;
+
+	int left = mViewport[0], bottom = mViewport[1];
+	int right = mViewport[0] + mViewport[2], top = mViewport[1] + mViewport[3];
+	if (mScissorEnabled)
+	{
+		left = max(left, mScissor[0]);
+		bottom = max(bottom, mScissor[1]);
+		right = min(right, mScissor[0] + mScissor[2]);
+		top = min(top, mScissor[1] + mScissor[3]);
+	}
+	args->ClipLeft = max(left, 0);
+	args->ClipBottom = max(bottom, 0);
+	args->ClipRight = min(right, mTarget.Width);
+	args->ClipTop = min(top, mTarget.Height);
+	return args;
+}
+
+//==========================================================================
+//
+// Vertex processing
+//
+//==========================================================================
+
+void PolyRenderState::SetupTransform()
+{
+	const HWViewpointUniforms *vp = mViewpointBuffer ? (const HWViewpointUniforms*)(mViewpointBuffer->Data() + mViewpointOffset) : nullptr;
+	if (vp != nullptr)
+	{
+		mTransform = vp->mProjectionMatrix;
+		mTransform.multMatrix(vp->mViewMatrix);
+	}
+	else
+	{
+		mTransform.loadIdentity();
+	}
+	if (mModelMatrixEnabled) mTransform.multMatrix(mModelMatrix);
+
+	// Build style software light emulation (see R_DoomLightingEquation in main.fp).
+	// Other light modes just use the light level.
+	mLightScale[0] = mLightScale[1] = 0.0f;
+	if (vp != nullptr && (vp->mPalLightLevels >> 16) == 5)
+	{
+		mLightScale[0] = float(vp->mPalLightLevels & 255);
+		mLightScale[1] = vp->mGlobVis * mLightParms[1];
+	}
+}
+
+static void FetchAttribute(const uint8_t *src, int format, float *out)
+{
+	switch (format)
+	{
+	case VFmt_Float4: memcpy(out, src, 4 * sizeof(float)); break;
+	case VFmt_Float3: memcpy(out, src, 3 * sizeof(float)); out[3] = 1.0f; break;
+	case VFmt_Float2: memcpy(out, src, 2 * sizeof(float)); out[2] = 0.0f; out[3] = 1.0f; break;
+	case VFmt_Float: memcpy(out, src, sizeof(float)); out[1] = out[2] = 0.0f; out[3] = 1.0f; break;
+	case VFmt_Byte4: for (int i = 0; i < 4; i++) out[i] = src[i] * (1.0f / 255.0f); break;
+	default: out[0] = out[1] = out[2] = 0.0f; out[3] = 1.0f; break;
+	}
+}
+
+void PolyRenderState::TransformVertex(const uint8_t *vertexdata, uint32_t vertexindex, ClipVertex &out)
+{
+	const size_t stride = mVB->Stride();
+	auto address = [&](const PolyVertexBuffer::PolyVertexAttribute &attr)
+	{
+		return vertexdata + (mVertexOffsets[attr.binding] + vertexindex) * stride + attr.offset;
+	};
+
+	FLOATTYPE pos[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float tmp[4];
+	auto &vattr = mVB->Attribute(VATTR_VERTEX);
+	if (vattr.enabled)
+	{
+		FetchAttribute(address(vattr), vattr.format, tmp);
+		auto &vattr2 = mVB->Attribute(VATTR_VERTEX2);
+		if (vattr2.enabled && mStreamData.uInterpolationFactor != 0.0f)
+		{
+			float tmp2[4];
+			FetchAttribute(address(vattr2), vattr2.format, tmp2);
+			for (int i = 0; i < 4; i++) tmp[i] += (tmp2[i] - tmp[i]) * mStreamData.uInterpolationFactor;
+		}
+		for (int i = 0; i < 4; i++) pos[i] = tmp[i];
+	}
+	FLOATTYPE clip[4];
+	mTransform.multMatrixPoint(pos, clip);
+	out.x = (float)clip[0];
+	out.y = (float)clip[1];
+	out.z = (float)clip[2];
+	out.w = (float)clip[3];
+
+	auto &tattr = mVB->Attribute(VATTR_TEXCOORD);
+	if (tattr.enabled)
+	{
+		FetchAttribute(address(tattr), tattr.format, tmp);
+		if (mTextureMatrixEnabled)
+		{
+			FLOATTYPE tc[4] = { tmp[0], tmp[1], 0.0f, 1.0f }, res[4];
+			mTextureMatrix.multMatrixPoint(tc, res);
+			tmp[0] = (float)res[0];
+			tmp[1] = (float)res[1];
+		}
+		out.u = tmp[0];
+		out.v = tmp[1];
+	}
+	else
+	{
+		out.u = out.v = 0.0f;
+	}
+
+	auto &cattr = mVB->Attribute(VATTR_COLOR);
+	if (cattr.enabled)
+	{
+		FetchAttribute(address(cattr), cattr.format, tmp);
+		out.r = tmp[0];
+		out.g = tmp[1];
+		out.b = tmp[2];
+		out.a = tmp[3];
+	}
+	else
+	{
+		auto &vc = mStreamData.uVertexColor;
+		out.r = vc.X;
+		out.g = vc.Y;
+		out.b = vc.Z;
+		out.a = vc.W;
+	}
+
+	if (!m2DMode)
+	{
+		float lightlevel = mLightParms[3];
+		if (lightlevel >= 0.0f)
+		{
+			float light = lightlevel;
+			if (mLightScale[0] > 0.0f)
+			{
+				float numShades = mLightScale[0];
+				float curshade = (1.0f - lightlevel) * (numShades - 1.0f);
+				float visibility = max(mLightScale[1] * out.w, 0.0f);
+				float shade = clamp(curshade + visibility, 0.0f, numShades - 1.0f);
+				light = 1.0f - clamp(shade * mLightParms[0], 0.0f, 1.0f);
+			}
+			out.r *= light;
+			out.g *= light;
+			out.b *= light;
+		}
+		auto &dyn = mStreamData.uDynLightColor;
+		out.r = clamp(out.r + dyn.X, 0.0f, 1.4f);
+		out.g = clamp(out.g + dyn.Y, 0.0f, 1.4f);
+		out.b = clamp(out.b + dyn.Z, 0.0f, 1.4f);
+	}
+}
+
+//==========================================================================
+//
+// Primitive assembly
+//
+//==========================================================================
+
+void PolyRenderState::Draw(int dt, int index, int count, bool apply)
+{
+	drawcalls.Clock();
+	DrawVertices(dt, nullptr, index, count);
+	drawcalls.Unclock();
+}
+
+void PolyRenderState::DrawIndexed(int dt, int index, int count, bool apply)
+{
+	if (mIndexBuffer == nullptr) return;
+	drawcalls.Clock();
+	auto ib = static_cast<PolyIndexBuffer*>(mIndexBuffer);
+	DrawVertices(dt, (const uint32_t*)ib->Data() + index, 0, count);
+	drawcalls.Unclock();
+}
+
+void PolyRenderState::DrawVertices(int dt, const uint32_t *indices, int index, int count)
+{
+	if (mVertexBuffer == nullptr || mTarget.Color == nullptr || count <= 0) return;
+
+	mVB = static_cast<PolyVertexBuffer*>(mVertexBuffer);
+	const uint8_t *vertexdata = mVB->Data();
+	m2DMode = mFogEnabled == 2;
+	SetupTransform();
+
+	// The args only depend on the state, which cannot change while the batch is open.
+	FlushBatch();
+	mArgs = CreateDrawArgs();
+	if (mArgs->ClipLeft >= mArgs->ClipRight || mArgs->ClipBottom >= mArgs->ClipTop) return;
+	DrawCalls++;
+
+	auto fetch = [&](int i, ClipVertex &v)
+	{
+		TransformVertex(vertexdata, indices ? indices[i] : uint32_t(index + i), v);
+	};
+
+	ClipVertex v[3];
+	switch (dt)
+	{
+	case DT_Points:
+		for (int i = 0; i < count; i++)
+		{
+			fetch(i, v[0]);
+			DrawPoint(v[0]);
+		}
+		break;
+
+	case DT_Lines:
+		for (int i = 0; i + 1 < count; i += 2)
+		{
+			fetch(i, v[0]);
+			fetch(i + 1, v[1]);
+			DrawLine(v[0], v[1]);
+		}
+		break;
+
+	default:
+	case DT_Triangles:
+		for (int i = 0; i + 2 < count; i += 3)
+		{
+			fetch(i, v[0]);
+			fetch(i + 1, v[1]);
+			fetch(i + 2, v[2]);
+			DrawTriangle(v[0], v[1], v[2]);
+		}
+		break;
+
+	case DT_TriangleFan:
+		if (count < 3) break;
+		fetch(0, v[0]);
+		fetch(1, v[2]);
+		for (int i = 2; i < count; i++)
+		{
+			v[1] = v[2];
+			fetch(i, v[2]);
+			DrawTriangle(v[0], v[1], v[2]);
+		}
+		break;
+
+	case DT_TriangleStrip:
+		if (count < 3) break;
+		fetch(0, v[1]);
+		fetch(1, v[2]);
+		for (int i = 2; i < count; i++)
+		{
+			v[0] = v[1];
+			v[1] = v[2];
+			fetch(i, v[2]);
+			// Keep the winding consistent for odd triangles.
+			if (i & 1) DrawTriangle(v[1], v[0], v[2]);
+			else DrawTriangle(v[0], v[1], v[2]);
+		}
+		break;
+	}
+}
+
+//==========================================================================
+//
+// Clipping and projection
+//
+//==========================================================================
+
+void PolyRenderState::ProjectVertex(const ClipVertex &in, PolyVertex &out)
+{
+	float rcpw = 1.0f / in.w;
+	out.x = mViewport[0] + (in.x * rcpw * 0.5f + 0.5f) * mViewport[2];
+	out.y = mViewport[1] + (in.y * rcpw * 0.5f + 0.5f) * mViewport[3];
+	float z = mDepthRangeMin + (in.z * rcpw * 0.5f + 0.5f) * (mDepthRangeMax - mDepthRangeMin);
+	// Only the constant part of the polygon offset is emulated.
+	z += mBias.mUnits * (1.0f / 16777216.0f);
+	out.z = clamp(z, 0.0f, 1.0f);
+	out.w = rcpw;
+	out.u = in.u * rcpw;
+	out.v = in.v * rcpw;
+	out.r = in.r * rcpw;
+	out.g = in.g * rcpw;
+	out.b = in.b * rcpw;
+	out.a = in.a * rcpw;
+}
+
+void PolyRenderState::DrawTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2)
+{
+	TrianglesSubmitted++;
+
+	// Sutherland-Hodgman against the frustum sides and the w = epsilon plane.
+	// Near and far only get clipped when depth clamping is off, as in OpenGL.
+	enum { MaxClipVerts = 12 };
+	ClipVertex buffers[2][MaxClipVerts];
+	ClipVertex *in = buffers[0], *out = buffers[1];
+	int numverts = 3;
+	in[0] = v0;
+	in[1] = v1;
+	in[2] = v2;
+
+	int numplanes = mDepthClampOn ? 5 : 7;
+	for (int plane = 0; plane < numplanes && numverts >= 3; plane++)
+	{
+		auto dist = [=](const ClipVertex &v)
+		{
+			switch (plane)
+			{
+			default:
+			case 0: return v.w - 1e-5f;
+			case 1: return v.w + v.x;
+			case 2: return v.w - v.x;
+			case 3: return v.w + v.y;
+			case 4: return v.w - v.y;
+			case 5: return v.w + v.z;
+			case 6: return v.w - v.z;
+			}
+		};
+
+		int numout = 0;
+		for (int i = 0; i < numverts; i++)
+		{
+			const ClipVertex &a = in[i];
+			const ClipVertex &b = in[(i + 1) % numverts];
+			float da = dist(a), db = dist(b);
+			if (da >= 0.0f) out[numout++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				float t = da / (da - db);
+				ClipVertex &c = out[numout++];
+				const float *pa = &a.x, *pb = &b.x;
+				float *pc = &c.x;
+				for (int j = 0; j < 10; j++) pc[j] = pa[j] + (pb[j] - pa[j]) * t;
+			}
+		}
+		numverts = numout;
+		std::swap(in, out);
+	}
+	if (numverts < 3) return;
+
+	PolyVertex projected[MaxClipVerts];
+	for (int i = 0; i < numverts; i++) ProjectVertex(in[i], projected[i]);
+
+	if (mCulling != Cull_None)
+	{
+		float area = 0.0f;
+		for (int i = 0; i < numverts; i++)
+		{
+			const PolyVertex &a = projected[i], &b = projected[(i + 1) % numverts];
+			area += a.x * b.y - b.x * a.y;
+		}
+		if (mCulling == Cull_CCW ? area < 0.0f : area > 0.0f) return;
+	}
+
+	for (int i = 2; i < numverts; i++)
+	{
+		PolyVertex *tri = AllocTriangle() ;
+		tri[0] = projected[0];
+		tri[1] = projected[i - 1];
+		tri[2] = projected[i];
+	}
+}
+
+//==========================================================================
+//
+// Lines and points become screen aligned quads one pixel wide.
+//
+//==========================================================================
+
+void PolyRenderState::DrawLine(const ClipVertex &v0, const ClipVertex &v1)
+{
+	if (v0.w < 1e-5f || v1.w < 1e-5f) return;
+
+	PolyVertex p0, p1;
+	ProjectVertex(v0, p0);
+	ProjectVertex(v1, p1);
+	float dx = p1.x - p0.x, dy = p1.y - p0.y;
+	float len = sqrtf(dx * dx + dy * dy);
+	if (len == 0.0f) return;
+	float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+
+	PolyVertex quad[4] = { p0, p0, p1, p1 };
+	quad[0].x += nx; quad[0].y += ny;
+	quad[1].x -= nx; quad[1].y -= ny;
+	quad[2].x -= nx; quad[2].y -= ny;
+	quad[3].x += nx; quad[3].y += ny;
+
+	TrianglesSubmitted += 2;
+	PolyVertex *tri = AllocTriangle();
+	tri[0] = quad[0]; tri[1] = quad[1]; tri[2] = quad[2];
+	tri = AllocTriangle();
+	tri[0] = quad[0]; tri[1] = quad[2]; tri[2] = quad[3];
+}
+
+void PolyRenderState::DrawPoint(const ClipVertex &v0)
+{
+	if (v0.w < 1e-5f) return;
+
+	PolyVertex p;
+	ProjectVertex(v0, p);
+	PolyVertex quad[4] = { p, p, p, p };
+	quad[0].x -= 0.5f; quad[0].y -= 0.5f;
+	quad[1].x += 0.5f; quad[1].y -= 0.5f;
+	quad[2].x += 0.5f; quad[2].y += 0.5f;
+	quad[3].x -= 0.5f; quad[3].y += 0.5f;
+
+	TrianglesSubmitted += 2;
+	PolyVertex *tri = AllocTriangle();
+	tri[0] = quad[0]; tri[1] = quad[1]; tri[2] = quad[2];
+	tri = AllocTriangle();
+	tri[0] = quad[0]; tri[1] = quad[2]; tri[2] = quad[3];
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void PolyRenderState::ClearScreen()
+{
+	screen->mViewpoints->Set2D(*this, SCREENWIDTH, SCREENHEIGHT);
+	SetColor(0, 0, 0);
+	bool depthtest = mDepthTest;
+	mDepthTest = false;
+	Draw(DT_TriangleStrip, FFlatVertexBuffer::FULLSCREEN_INDEX, 4);
+	mDepthTest = depthtest;
+}
+
+void PolyRenderState::Clear(int targets)
+{
+	if (mTarget.Color == nullptr) return;
+	FlushBatch();
+
+	int left = 0, bottom = 0, right = mTarget.Width, top = mTarget.Height;
+	if (mScissorEnabled)
+	{
+		left = max(mScissor[0], 0);
+		bottom = max(mScissor[1], 0);
+		right = min(mScissor[0] + mScissor[2], mTarget.Width);
+		top = min(mScissor[1] + mScissor[3], mTarget.Height);
+	}
+	if (left >= right || bottom >= top) return;
+
+	uint32_t color = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		static const int shift[4] = { 16, 8, 0, 24 };
+		color |= (uint32_t)(clamp(screen->mSceneClearColor[i], 0.0f, 1.0f) * 255.0f + 0.5f) << shift[i];
+	}
+	mQueue->Push<PolyClearCommand>(mTarget, left, bottom, right, top, targets, color, mColorMask, mDepthMask);
+	if (++mQueuedCommands >= MaxQueuedCommands) SubmitQueue();
+}
+
+bool PolyRenderState::SetDepthClamp(bool on)
+{
+	bool res = mDepthClampOn;
+	mDepthClampOn = on;
+	return res;
+}
+
+void PolyRenderState::SetDepthMask(bool on)
+{
+	mDepthMask = on;
+}
+
+void PolyRenderState::SetDepthFunc(int func)
+{
+	mDepthFunc = func;
+}
+
+void PolyRenderState::SetDepthRange(float min, float max)
+{
+	mDepthRangeMin = min;
+	mDepthRangeMax = max;
+}
+
+void PolyRenderState::SetColorMask(bool r, bool g, bool b, bool a)
+{
+	mColorMask = (r ? 0x00ff0000 : 0) | (g ? 0x0000ff00 : 0) | (b ? 0x000000ff : 0) | (a ? 0xff000000 : 0);
+}
+
+void PolyRenderState::SetStencil(int offs, int op, int flags)
+{
+	mStencilValue = screen->stencilValue + offs;
+	mStencilOp = op;
+
+	if (flags != -1)
+	{
+		bool cmon = !(flags & SF_ColorMaskOff);
+		SetColorMask(cmon, cmon, cmon, cmon);
+		mDepthMask = !(flags & SF_DepthMaskOff);
+	}
+}
+
+void PolyRenderState::SetCulling(int mode)
+{
+	mCulling = mode;
+}
+
+void PolyRenderState::EnableClipDistance(int num, bool state)
+{
+	// Not supported. The framebuffer reports RFL_NO_CLIP_PLANES so the renderer works around it.
+}
+
+void PolyRenderState::EnableStencil(bool on)
+{
+	mStencilTest = on;
+}
+
+void PolyRenderState::SetScissor(int x, int y, int w, int h)
+{
+	mScissorEnabled = w > -1;
+	mScissor[0] = x;
+	mScissor[1] = y;
+	mScissor[2] = w;
+	mScissor[3] = h;
+}
+
+void PolyRenderState::SetViewport(int x, int y, int w, int h)
+{
+	mViewport[0] = x;
+	mViewport[1] = y;
+	mViewport[2] = w;
+	mViewport[3] = h;
+}
+
+void PolyRenderState::EnableDepthTest(bool on)
+{
+	mDepthTest = on;
+}
+
+void PolyRenderState::EnableMultisampling(bool on)
+{
+}
+
+void PolyRenderState::EnableLineSmooth(bool on)
+{
+}
+
+void PolyRenderState::EnableDrawBuffers(int count, bool apply)
+{
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "hw_renderstate.h"
+#include "r_memory.h"
+#include "poly_triangle.h"
+
+class PolyDataBuffer;
+class PolyVertexBuffer;
+struct HWViewpointUniforms;
+
+//==========================================================================
+//
+// Render state for the software rasterizer backend.
+//
+// Vertex processing, clipping and triangle setup are done on the calling
+// thread when a draw call is made, so the vertex and index buffers can be
+// reused immediately afterwards. The resulting window space triangles are
+// queued for the DrawerThreads workers, which only do the per pixel work.
+//
+//==========================================================================
+
+class PolyRenderState final : public FRenderState
+{
+public:
+	PolyRenderState();
+	~PolyRenderState();
+
+	// Draw commands
+	void ClearScreen() override;
+	void Draw(int dt, int index, int count, bool apply = true) override;
+	void DrawIndexed(int dt, int index, int count, bool apply = true) override;
+
+	// Immediate render state change commands. These only change infrequently and should not clutter the render state.
+	bool SetDepthClamp(bool on) override;
+	void SetDepthMask(bool on) override;
+	void SetDepthFunc(int func) override;
+	void SetDepthRange(float min, float max) override;
+	void SetColorMask(bool r, bool g, bool b, bool a) override;
+	void SetStencil(int offs, int op, int flags = -1) override;
+	void SetCulling(int mode) override;
+	void EnableClipDistance(int num, bool state) override;
+	void Clear(int targets) override;
+	void EnableStencil(bool on) override;
+	void SetScissor(int x, int y, int w, int h) override;
+	void SetViewport(int x, int y, int w, int h) override;
+	void EnableDepthTest(bool on) override;
+	void EnableMultisampling(bool on) override;
+	void EnableLineSmooth(bool on) override;
+	void EnableDrawBuffers(int count, bool apply = false) override;
+
+	void SetRenderTarget(const PolyRenderTarget &target);
+	void SetViewpointUniforms(PolyDataBuffer *buffer, size_t offset);
+
+	// Hands all queued work to the worker threads and waits for it to finish.
+	void Flush();
+	void EndFrame();
+	static void FlushAll();
+
+	int DrawCalls = 0;
+	int TrianglesSubmitted = 0;
+	int TrianglesRasterized = 0;
+
+private:
+	struct ClipVertex
+	{
+		float x, y, z, w;
+		float u, v;
+		float r, g, b, a;
+	};
+
+	void DrawVertices(int dt, const uint32_t *indices, int index, int count);
+	const PolyDrawArgs *CreateDrawArgs();
+	void SetupTransform();
+	void TransformVertex(const uint8_t *vertexdata, uint32_t vertexindex, ClipVertex &out);
+	void DrawTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2);
+	void DrawLine(const ClipVertex &v0, const ClipVertex &v1);
+	void DrawPoint(const ClipVertex &v0);
+	void ProjectVertex(const ClipVertex &in, PolyVertex &out);
+	PolyVertex *AllocTriangle();
+	void FlushBatch();
+	void SubmitQueue();
+
+	PolyRenderTarget mTarget;
+	RenderMemory mFrameMemory;
+	DrawerCommandQueuePtr mQueue;
+	int mQueuedCommands = 0;
+
+	const PolyDrawArgs *mArgs = nullptr;
+	PolyVertex *mBatch = nullptr;
+	int mBatchCount = 0;
+
+	PolyDataBuffer *mViewpointBuffer = nullptr;
+	size_t mViewpointOffset = 0;
+
+	// Per draw transform state
+	const PolyVertexBuffer *mVB = nullptr;
+	VSMatrix mTransform;
+	float mLightScale[2];
+	bool mDepthClampOn = true;
+	bool m2DMode = false;
+
+	bool mDepthTest = false;
+	bool mDepthMask = true;
+	int mDepthFunc = DF_Less;
+	float mDepthRangeMin = 0.0f;
+	float mDepthRangeMax = 1.0f;
+	uint32_t mColorMask = 0xffffffff;
+	bool mStencilTest = false;
+	int mStencilValue = 0;
+	int mStencilOp = SOP_Keep;
+	int mCulling = Cull_None;
+	bool mScissorEnabled = false;
+	int mScissor[4] = {};
+	int mViewport[4] = {};
+
+	static PolyRenderState *Instance;
+};
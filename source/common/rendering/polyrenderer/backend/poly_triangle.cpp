@@ -0,0 +1,314 @@
+/*
+** poly_triangle.cpp
+** Tiled triangle rasterizer for the software backend
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Triangles arrive fully set up in window space. Each worker thread walks
+** the screen tiles it owns that overlap the triangle's bounding box, rejects
+** tiles outside an edge and then evaluates the edge functions per pixel.
+** The fragment stage mirrors what main.fp does for the common paths.
+**
+*/
+
+#include <math.h>
+
+#include "poly_triangle.h"
+#include "poly_hwtexture.h"
+#include "hw_renderstate.h"
+#include "renderstyle.h"
+#include "basics.h"
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+PolyClearCommand::PolyClearCommand(const PolyRenderTarget &target, int left, int bottom, int right, int top, int targets, uint32_t color, uint32_t colormask, bool depthmask)
+	: target(target), left(left), bottom(bottom), right(right), top(top), targets(targets), color(color), colormask(colormask), depthmask(depthmask)
+{
+}
+
+void PolyClearCommand::Execute(DrawerThread *thread)
+{
+	for (int tiley = bottom >> POLY_TILE_SHIFT; tiley <= (top - 1) >> POLY_TILE_SHIFT; tiley++)
+	{
+		int y0 = max(tiley << POLY_TILE_SHIFT, bottom);
+		int y1 = min((tiley + 1) << POLY_TILE_SHIFT, top);
+		for (int tilex = left >> POLY_TILE_SHIFT; tilex <= (right - 1) >> POLY_TILE_SHIFT; tilex++)
+		{
+			if (!PolyTileOwnedByThread(thread, target.Height, tilex, tiley)) continue;
+
+			int x0 = max(tilex << POLY_TILE_SHIFT, left);
+			int x1 = min((tilex + 1) << POLY_TILE_SHIFT, right);
+			for (int y = y0; y < y1; y++)
+			{
+				int offset = y * target.Width;
+				if (targets & CT_Color)
+				{
+					uint32_t *dest = target.Color + offset;
+					for (int x = x0; x < x1; x++) dest[x] = (dest[x] & ~colormask) | (color & colormask);
+				}
+				if ((targets & CT_Depth) && depthmask)
+				{
+					float *dest = target.Depth + offset;
+					for (int x = x0; x < x1; x++) dest[x] = 1.0f;
+				}
+				if (targets & CT_Stencil)
+				{
+					memset(target.Stencil + offset + x0, 0, x1 - x0);
+				}
+			}
+		}
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void PolyDrawTrianglesCommand::Execute(DrawerThread *thread)
+{
+	for (int i = 0; i < numTriangles; i++)
+	{
+		DrawTriangle(thread, &vertices[i * 3], &vertices[i * 3 + 1], &vertices[i * 3 + 2]);
+	}
+}
+
+//==========================================================================
+//
+// Edge functions are set up so that the inside of a counter clockwise
+// triangle is positive. Pixels exactly on an edge belong to the triangle
+// on the side the edge normal points away from, so that shared edges
+// are drawn exactly once.
+//
+//==========================================================================
+
+static void SetupEdge(const PolyVertex *a, const PolyVertex *b, float *edge)
+{
+	edge[0] = a->y - b->y;
+	edge[1] = b->x - a->x;
+	edge[2] = -(edge[0] * a->x + edge[1] * a->y);
+}
+
+static inline bool EdgeInside(float e, const float *edge)
+{
+	return e > 0.0f || (e == 0.0f && (edge[0] > 0.0f || (edge[0] == 0.0f && edge[1] > 0.0f)));
+}
+
+void PolyDrawTrianglesCommand::DrawTriangle(DrawerThread *thread, const PolyVertex *v0, const PolyVertex *v1, const PolyVertex *v2)
+{
+	float area = (v1->x - v0->x) * (v2->y - v0->y) - (v2->x - v0->x) * (v1->y - v0->y);
+	if (area == 0.0f) return;
+	if (area < 0.0f) std::swap(v1, v2);
+
+	int minx = max((int)floorf(min(min(v0->x, v1->x), v2->x)), args->ClipLeft);
+	int maxx = min((int)ceilf(max(max(v0->x, v1->x), v2->x)), args->ClipRight);
+	int miny = max((int)floorf(min(min(v0->y, v1->y), v2->y)), args->ClipBottom);
+	int maxy = min((int)ceilf(max(max(v0->y, v1->y), v2->y)), args->ClipTop);
+	if (minx >= maxx || miny >= maxy) return;
+
+	float edge[9];
+	SetupEdge(v1, v2, edge);
+	SetupEdge(v2, v0, edge + 3);
+	SetupEdge(v0, v1, edge + 6);
+
+	for (int tiley = miny >> POLY_TILE_SHIFT; tiley <= (maxy - 1) >> POLY_TILE_SHIFT; tiley++)
+	{
+		int y0 = max(tiley << POLY_TILE_SHIFT, miny);
+		int y1 = min((tiley + 1) << POLY_TILE_SHIFT, maxy);
+		for (int tilex = minx >> POLY_TILE_SHIFT; tilex <= (maxx - 1) >> POLY_TILE_SHIFT; tilex++)
+		{
+			if (!PolyTileOwnedByThread(thread, target.Height, tilex, tiley)) continue;
+
+			int x0 = max(tilex << POLY_TILE_SHIFT, minx);
+			int x1 = min((tilex + 1) << POLY_TILE_SHIFT, maxx);
+
+			// Reject the tile if all four corners are outside the same edge.
+			bool outside = false;
+			for (int e = 0; e < 9 && !outside; e += 3)
+			{
+				float left = edge[e] * (x0 + 0.5f) + edge[e + 2];
+				float right = edge[e] * (x1 - 0.5f) + edge[e + 2];
+				float bottom = edge[e + 1] * (y0 + 0.5f);
+				float top = edge[e + 1] * (y1 - 0.5f);
+				outside = max(max(left + bottom, right + bottom), max(left + top, right + top)) < 0.0f;
+			}
+			if (!outside) ShadeTile(x0, y0, x1, y1, v0, v1, v2, edge);
+		}
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static inline float Grayscale(float r, float g, float b)
+{
+	return r * 0.3f + g * 0.56f + b * 0.14f;
+}
+
+static inline float BlendFactor(int style, float src, float srcalpha, float dest, float destalpha)
+{
+	switch (style)
+	{
+	default:
+	case STYLEALPHA_Zero: return 0.0f;
+	case STYLEALPHA_One: return 1.0f;
+	case STYLEALPHA_Src: return srcalpha;
+	case STYLEALPHA_InvSrc: return 1.0f - srcalpha;
+	case STYLEALPHA_SrcCol: return src;
+	case STYLEALPHA_InvSrcCol: return 1.0f - src;
+	case STYLEALPHA_DstCol: return dest;
+	case STYLEALPHA_InvDstCol: return 1.0f - dest;
+	case STYLEALPHA_Dst: return destalpha;
+	case STYLEALPHA_InvDst: return 1.0f - destalpha;
+	}
+}
+
+static inline uint32_t ToByte(float c)
+{
+	return (uint32_t)(clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+void PolyDrawTrianglesCommand::ShadeTile(int x0, int y0, int x1, int y1, const PolyVertex *v0, const PolyVertex *v1, const PolyVertex *v2, const float *edge)
+{
+	const PolyDrawArgs &a = *args;
+	const PolyTextureImage *tex = a.Texture;
+	const float rcpArea = 1.0f / (edge[6] * v2->x + edge[7] * v2->y + edge[8]);
+	const bool opaque = a.SrcBlend == STYLEALPHA_One && a.DestBlend == STYLEALPHA_Zero && a.BlendOp == STYLEOP_Add;
+
+	for (int y = y0; y < y1; y++)
+	{
+		float py = y + 0.5f;
+		float e0 = edge[0] * (x0 + 0.5f) + edge[1] * py + edge[2];
+		float e1 = edge[3] * (x0 + 0.5f) + edge[4] * py + edge[5];
+		float e2 = edge[6] * (x0 + 0.5f) + edge[7] * py + edge[8];
+		int offset = y * target.Width;
+
+		for (int x = x0; x < x1; x++, e0 += edge[0], e1 += edge[3], e2 += edge[6])
+		{
+			if (!EdgeInside(e0, edge) || !EdgeInside(e1, edge + 3) || !EdgeInside(e2, edge + 6)) continue;
+
+			int index = offset + x;
+			float b0 = e0 * rcpArea, b1 = e1 * rcpArea, b2 = e2 * rcpArea;
+
+			if (a.StencilTest && target.Stencil[index] != a.StencilRef) continue;
+
+			float depth = clamp(b0 * v0->z + b1 * v1->z + b2 * v2->z, 0.0f, 1.0f);
+			if (a.DepthTest)
+			{
+				float destdepth = target.Depth[index];
+				if (a.DepthFunc == DF_Less ? depth >= destdepth : a.DepthFunc == DF_LEqual ? depth > destdepth : false) continue;
+			}
+
+			float w = 1.0f / (b0 * v0->w + b1 * v1->w + b2 * v2->w);
+
+			// Texture stage
+			float tr = 1.0f, tg = 1.0f, tb = 1.0f, ta = 1.0f;
+			if (tex != nullptr)
+			{
+				float u = (b0 * v0->u + b1 * v1->u + b2 * v2->u) * w;
+				float v = (b0 * v0->v + b1 * v1->v + b2 * v2->v) * w;
+
+				float fu = a.ClampU ? clamp(u, 0.0f, 1.0f) : u - floorf(u);
+				float fv = a.ClampV ? clamp(v, 0.0f, 1.0f) : v - floorf(v);
+				int tx = min((int)(fu * tex->Width), tex->Width - 1);
+				int ty = min((int)(fv * tex->Height), tex->Height - 1);
+				uint32_t texel = tex->Pixels[ty * tex->Width + tx];
+				tb = (texel & 0xff) * (1.0f / 255.0f);
+				tg = ((texel >> 8) & 0xff) * (1.0f / 255.0f);
+				tr = ((texel >> 16) & 0xff) * (1.0f / 255.0f);
+				ta = (texel >> 24) * (1.0f / 255.0f);
+
+				switch (a.TextureMode)
+				{
+				case TM_STENCIL: tr = tg = tb = 1.0f; break;
+				case TM_OPAQUE: ta = 1.0f; break;
+				case TM_INVERSE: tr = 1.0f - tr; tg = 1.0f - tg; tb = 1.0f - tb; break;
+				case TM_ALPHATEXTURE: ta *= Grayscale(tr, tg, tb); tr = tg = tb = 1.0f; break;
+				case TM_CLAMPY: if (v < 0.0f || v > 1.0f) ta = 0.0f; break;
+				case TM_INVERTOPAQUE: tr = 1.0f - tr; tg = 1.0f - tg; tb = 1.0f - tb; ta = 1.0f; break;
+				default: break;
+				}
+				if (a.ClampY && (v < 0.0f || v > 1.0f)) ta = 0.0f;
+			}
+
+			tr = (tr + a.AddColor[0]) * a.ObjectColor[0];
+			tg = (tg + a.AddColor[1]) * a.ObjectColor[1];
+			tb = (tb + a.AddColor[2]) * a.ObjectColor[2];
+			ta *= a.ObjectColor[3];
+			if (ta <= a.AlphaThreshold) continue;
+
+			// Light stage. The vertex color already contains the light level.
+			float sr = min(tr * (b0 * v0->r + b1 * v1->r + b2 * v2->r) * w + a.FogColor[0], 1.0f) * a.Fade;
+			float sg = min(tg * (b0 * v0->g + b1 * v1->g + b2 * v2->g) * w + a.FogColor[1], 1.0f) * a.Fade;
+			float sb = min(tb * (b0 * v0->b + b1 * v1->b + b2 * v2->b) * w + a.FogColor[2], 1.0f) * a.Fade;
+			float sa = min(ta * (b0 * v0->a + b1 * v1->a + b2 * v2->a) * w, 1.0f);
+
+			// Output merger
+			uint32_t result;
+			uint32_t dest = target.Color[index];
+			if (opaque)
+			{
+				result = (ToByte(sa) << 24) | (ToByte(sr) << 16) | (ToByte(sg) << 8) | ToByte(sb);
+			}
+			else
+			{
+				float db = (dest & 0xff) * (1.0f / 255.0f);
+				float dg = ((dest >> 8) & 0xff) * (1.0f / 255.0f);
+				float dr = ((dest >> 16) & 0xff) * (1.0f / 255.0f);
+				float da = (dest >> 24) * (1.0f / 255.0f);
+
+				float src[4] = { sr, sg, sb, sa }, dst[4] = { dr, dg, db, da }, out[4];
+				for (int c = 0; c < 4; c++)
+				{
+					float s = src[c] * BlendFactor(a.SrcBlend, src[c], sa, dst[c], da);
+					float d = dst[c] * BlendFactor(a.DestBlend, src[c], sa, dst[c], da);
+					out[c] = a.BlendOp == STYLEOP_Sub ? s - d : a.BlendOp == STYLEOP_RevSub ? d - s : s + d;
+				}
+				result = (ToByte(out[3]) << 24) | (ToByte(out[0]) << 16) | (ToByte(out[1]) << 8) | ToByte(out[2]);
+			}
+			target.Color[index] = (dest & ~a.ColorMask) | (result & a.ColorMask);
+
+			if (a.DepthTest && a.DepthWrite) target.Depth[index] = depth;
+			if (a.StencilTest)
+			{
+				uint8_t &stencil = target.Stencil[index];
+				if (a.StencilOp == SOP_Increment && stencil < 255) stencil++;
+				else if (a.StencilOp == SOP_Decrement && stencil > 0) stencil--;
+			}
+		}
+	}
+}
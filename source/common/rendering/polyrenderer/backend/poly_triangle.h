@@ -0,0 +1,103 @@
+#pragma once
+
+#include "r_thread.h"
+
+struct PolyTextureImage;
+
+// The render target uses the OpenGL convention: row 0 is the bottom of the screen.
+struct PolyRenderTarget
+{
+	uint32_t *Color = nullptr;	// BGRA
+	float *Depth = nullptr;
+	uint8_t *Stencil = nullptr;
+	int Width = 0;
+	int Height = 0;
+};
+
+// A vertex after projection. x and y are in window coordinates, z is the depth
+// buffer value and w is 1/w of the clip space position. The varyings are
+// premultiplied with w so that they can be interpolated linearly.
+struct PolyVertex
+{
+	float x, y, z, w;
+	float u, v;
+	float r, g, b, a;
+};
+
+// Everything the fragment stage needs. Allocated from frame memory and
+// shared by all commands until the state changes.
+struct PolyDrawArgs
+{
+	const PolyTextureImage *Texture;
+	int TextureMode;
+	bool ClampU, ClampV, ClampY;
+	float AlphaThreshold;
+
+	float ObjectColor[4];
+	float AddColor[3];
+	float FogColor[3];		// added to the fragment in 2D mode
+	float Fade;
+
+	int SrcBlend, DestBlend, BlendOp;
+
+	bool DepthTest, DepthWrite;
+	int DepthFunc;
+	bool StencilTest;
+	uint8_t StencilRef;
+	int StencilOp;
+	uint32_t ColorMask;
+
+	// Scissor in window coordinates, right and top are exclusive.
+	int ClipLeft, ClipBottom, ClipRight, ClipTop;
+};
+
+enum
+{
+	POLY_TILE_SHIFT = 4,
+	POLY_TILE_SIZE = 1 << POLY_TILE_SHIFT,
+};
+
+// Each worker owns a fixed, interleaved set of screen tiles. Since every pixel is
+// only ever touched by one thread and commands execute in order the output does
+// not depend on the number of threads. The rows are split between the NUMA nodes
+// by the height of the render target, which does not have to be the screen's.
+inline bool PolyTileOwnedByThread(DrawerThread *thread, int targetheight, int tilex, int tiley)
+{
+	int y = tiley << POLY_TILE_SHIFT;
+	int node = thread->numa_node, numnodes = thread->num_numa_nodes;
+	if (y < node * targetheight / numnodes) return false;
+	if (node != numnodes - 1 && y >= (node + 1) * targetheight / numnodes) return false;
+	return (tilex + tiley) % thread->num_cores == thread->core;
+}
+
+class PolyClearCommand : public DrawerCommand
+{
+public:
+	PolyClearCommand(const PolyRenderTarget &target, int left, int bottom, int right, int top, int targets, uint32_t color, uint32_t colormask, bool depthmask);
+	void Execute(DrawerThread *thread) override;
+
+private:
+	PolyRenderTarget target;
+	int left, bottom, right, top;
+	int targets;
+	uint32_t color;
+	uint32_t colormask;
+	bool depthmask;
+};
+
+class PolyDrawTrianglesCommand : public DrawerCommand
+{
+public:
+	PolyDrawTrianglesCommand(const PolyRenderTarget &target, const PolyDrawArgs *args, const PolyVertex *vertices, int numTriangles)
+		: target(target), args(args), vertices(vertices), numTriangles(numTriangles) {}
+	void Execute(DrawerThread *thread) override;
+
+private:
+	void DrawTriangle(DrawerThread *thread, const PolyVertex *v0, const PolyVertex *v1, const PolyVertex *v2);
+	void ShadeTile(int x0, int y0, int x1, int y1, const PolyVertex *v0, const PolyVertex *v1, const PolyVertex *v2, const float *edge);
+
+	PolyRenderTarget target;
+	const PolyDrawArgs *args;
+	const PolyVertex *vertices;
+	int numTriangles;
+};
@@ -28,6 +28,7 @@
 #include "r_thread.h"
 #include "r_memory.h"
 #include "printf.h"
+#include "tracing.h"
 #include <chrono>
 
 CVAR(Int, r_multithreaded, 1, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
@@ -115,6 +116,10 @@ void DrawerThreads::WaitForWorkers()
 
 void DrawerThreads::WorkerMain(DrawerThread *thread)
 {
+	FString name;
+	name.Format("Drawer thread %d", thread->core);
+	Trace::SetThreadName(name.GetChars());
+
 	while (true)
 	{
 		// Wait until we are signalled to run:
@@ -131,6 +136,7 @@ void DrawerThreads::WorkerMain(DrawerThread *thread)
 		start_lock.unlock();
 
 		// Do the work:
+		TRACE_ZONE("DrawerQueue");
 		if (r_debug_draw)
 		{
 			for (auto& command : list->commands)
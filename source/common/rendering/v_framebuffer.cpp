@@ -50,6 +50,7 @@
 #include "flatvertices.h"
 #include "version.h"
 #include "hw_material.h"
+#include "texturemanager.h"
 
 #include <chrono>
 #include <thread>
@@ -105,6 +106,7 @@ void DFrameBuffer::Update()
 		V_OutputResized(clientWidth, clientHeight);
 		mVertexData->OutputResized(clientWidth, clientHeight);
 	}
+	TexMan.EnforceTextureBudget();
 }
 
 void DFrameBuffer::SetClearColor(int color)
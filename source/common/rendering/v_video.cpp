@@ -112,6 +112,9 @@ CUSTOM_CVAR(Int, vid_preferbackend, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_N
 		Printf("Selecting Vulkan backend...\n");
 		break;
 #endif
+	case 4:
+		Printf("Selecting software rasterizer backend...\n");
+		break;
 	default:
 		Printf("Selecting OpenGL backend...\n");
 	}
@@ -123,7 +126,7 @@ int V_GetBackend()
 {
 	int v = vid_preferbackend;
 	if (v == 3) v = 2;
-	else if (v < 0 || v > 3) v = 0;
+	else if (v < 0 || v > 4) v = 0;
 	return v;
 }
 
@@ -74,6 +74,7 @@ enum EHWCaps
 
 	RFL_INVALIDATE_BUFFER = 64,
 	RFL_DEBUG = 128,
+	RFL_NO_INDEXED_TEXTURES = 256,	// backend cannot do palette emulation on indexed textures
 };
 
 
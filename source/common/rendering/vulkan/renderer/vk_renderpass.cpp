@@ -35,6 +35,10 @@
 #include "hw_viewpointuniforms.h"
 #include "v_2ddrawer.h"
 #include "i_specialpaths.h"
+#include "i_time.h"
+#include "printf.h"
+#include "c_dispatch.h"
+#include "engineerrors.h"
 
 VkRenderPassManager::VkRenderPassManager(VulkanRenderDevice* fb) : fb(fb)
 {
@@ -42,47 +46,297 @@ VkRenderPassManager::VkRenderPassManager(VulkanRenderDevice* fb) : fb(fb)
 	CreatePath(path);
 	CacheFilename = path + "/pipelinecache.zdpc";
 
+	LoadCache();
+}
+
+VkRenderPassManager::~VkRenderPassManager()
+{
+	StopWarmup();
+	SaveCache();
+}
+
+//==========================================================================
+//
+// The cache file starts with a header identifying the driver and the
+// shaders it was written for, followed by the vertex formats and the
+// pipeline keys seen in recent sessions and finally the driver's own
+// pipeline cache data. The driver data is only used for the exact same
+// driver, the keys only for the exact same shader sources.
+//
+//==========================================================================
+
+namespace
+{
+	struct PipelineCacheHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t VendorID;
+		uint32_t DeviceID;
+		uint32_t DriverVersion;
+		uint8_t CacheUUID[VK_UUID_SIZE];
+		uint32_t ShaderHash;
+		uint32_t NumVertexFormats;
+		uint32_t NumPipelines;
+		uint32_t CacheDataSize;
+	};
+
+	struct PipelineCacheVertexFormat
+	{
+		int32_t NumBindingPoints;
+		int32_t Stride;
+		int32_t NumAttributes;
+	};
+
+	struct PipelineCacheEntry
+	{
+		VkRenderPassKey PassKey;
+		VkPipelineKey Key;
+		uint32_t Age;
+	};
+
+	enum
+	{
+		PipelineCacheMagic = MAKE_ID('Z', 'D', 'P', 'C'),
+		PipelineCacheVersion = 1,
+		MaxPipelineAge = 4			// Sessions a pipeline can go unused before it is dropped from the file
+	};
+}
+
+void VkRenderPassManager::LoadCache()
+{
 	PipelineCacheBuilder builder;
 	builder.DebugName("PipelineCache");
 
+	std::vector<uint8_t> data;
+
 	try
 	{
 		FileReader fr;
 		if (fr.OpenFile(CacheFilename))
 		{
-			std::vector<uint8_t> data;
-			data.resize(fr.GetLength());
-			if (fr.Read(data.data(), data.size()) == (FileReader::Size)data.size())
+			PipelineCacheHeader header;
+			if (fr.Read(&header, sizeof(header)) == sizeof(header) && header.Magic == PipelineCacheMagic && header.Version == PipelineCacheVersion)
 			{
-				builder.InitialData(data.data(), data.size());
+				std::vector<int> formats;
+				for (uint32_t i = 0; i < header.NumVertexFormats; i++)
+				{
+					PipelineCacheVertexFormat format;
+					if (fr.Read(&format, sizeof(format)) != sizeof(format) || format.NumAttributes < 0 || format.NumAttributes > VATTR_MAX)
+						throw CVulkanError("Invalid pipeline cache vertex format");
+
+					FVertexBufferAttribute attrs[VATTR_MAX];
+					if (fr.Read(attrs, format.NumAttributes * sizeof(FVertexBufferAttribute)) != (FileReader::Size)(format.NumAttributes * sizeof(FVertexBufferAttribute)))
+						throw CVulkanError("Invalid pipeline cache vertex format");
+
+					formats.push_back(GetVertexFormat(format.NumBindingPoints, format.NumAttributes, format.Stride, attrs));
+				}
+
+				for (uint32_t i = 0; i < header.NumPipelines; i++)
+				{
+					PipelineCacheEntry entry;
+					if (fr.Read(&entry, sizeof(entry)) != sizeof(entry))
+						throw CVulkanError("Invalid pipeline cache entry");
+
+					if (entry.Key.VertexFormat < 0 || entry.Key.VertexFormat >= (int)formats.size())
+						continue;
+					entry.Key.VertexFormat = formats[entry.Key.VertexFormat];
+					CachedPipelines[{ entry.PassKey, entry.Key }] = entry.Age + 1;
+				}
+				CachedShaderHash = header.ShaderHash;
+
+				const auto& props = fb->device->PhysicalDevice.Properties;
+				bool sameDriver =
+					header.VendorID == props.vendorID &&
+					header.DeviceID == props.deviceID &&
+					header.DriverVersion == props.driverVersion &&
+					memcmp(header.CacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+				if (sameDriver)
+				{
+					data.resize(header.CacheDataSize);
+					if (fr.Read(data.data(), data.size()) == (FileReader::Size)data.size())
+					{
+						builder.InitialData(data.data(), data.size());
+						CacheDataLoaded = true;
+					}
+				}
 			}
 		}
 	}
 	catch (...)
 	{
+		CachedPipelines.clear();
 	}
 
 	PipelineCache = builder.Create(fb->device.get());
 }
 
-VkRenderPassManager::~VkRenderPassManager()
+void VkRenderPassManager::SaveCache()
 {
 	try
 	{
+		CollectUsedPipelines();
+
 		auto data = PipelineCache->GetCacheData();
+
+		PipelineCacheHeader header = {};
+		header.Magic = PipelineCacheMagic;
+		header.Version = PipelineCacheVersion;
+		const auto& props = fb->device->PhysicalDevice.Properties;
+		header.VendorID = props.vendorID;
+		header.DeviceID = props.deviceID;
+		header.DriverVersion = props.driverVersion;
+		memcpy(header.CacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+		header.ShaderHash = fb->GetShaderManager() && fb->GetShaderManager()->IsCompiled() ? fb->GetShaderManager()->GetSourceHash() : CachedShaderHash;
+		header.NumVertexFormats = (uint32_t)VertexFormats.size();
+		header.NumPipelines = 0;
+		for (auto& it : CachedPipelines)
+		{
+			if (it.second <= MaxPipelineAge)
+				header.NumPipelines++;
+		}
+		header.CacheDataSize = (uint32_t)data.size();
+
 		std::unique_ptr<FileWriter> fw(FileWriter::Open(CacheFilename));
 		if (fw)
+		{
+			fw->Write(&header, sizeof(header));
+			for (auto& format : VertexFormats)
+			{
+				PipelineCacheVertexFormat f = { format.NumBindingPoints, (int32_t)format.Stride, (int32_t)format.Attrs.size() };
+				fw->Write(&f, sizeof(f));
+				fw->Write(format.Attrs.data(), format.Attrs.size() * sizeof(FVertexBufferAttribute));
+			}
+			for (auto& it : CachedPipelines)
+			{
+				if (it.second <= MaxPipelineAge)
+				{
+					PipelineCacheEntry entry = { it.first.first, it.first.second, it.second };
+					fw->Write(&entry, sizeof(entry));
+				}
+			}
 			fw->Write(data.data(), data.size());
+		}
 	}
 	catch (...)
 	{
 	}
 }
 
+void VkRenderPassManager::CollectUsedPipelines()
+{
+	for (auto& setup : RenderPassSetup)
+	{
+		for (auto& pipeline : setup.second->Pipelines)
+			CachedPipelines[{ setup.first, pipeline.first }] = 0;
+	}
+}
+
+//==========================================================================
+//
+// Pipelines used in earlier sessions get created by a background thread
+// once the shaders have been compiled and the render buffers exist. The
+// builders are set up here because that needs the shader manager and the
+// render pass setups, neither of which may be touched by other threads.
+//
+//==========================================================================
+
+void VkRenderPassManager::BeginFrame()
+{
+	if (WarmupPending && fb->GetShaderManager()->IsCompiled())
+	{
+		WarmupPending = false;
+		StartWarmup();
+	}
+
+	if (WarmupDone && WarmupThread.joinable())
+	{
+		WarmupThread.join();
+		WarmupJobs.clear();
+		DPrintf(DMSG_NOTIFY, "Vulkan pipeline warm-up: %d pipelines in %.1f ms\n", PipelinesWarmed.load(), WarmupTime.load() / 1000000.0);
+	}
+}
+
+void VkRenderPassManager::StartWarmup()
+{
+	if (CachedShaderHash != fb->GetShaderManager()->GetSourceHash())
+	{
+		CachedPipelines.clear();
+		CachedShaderHash = fb->GetShaderManager()->GetSourceHash();
+	}
+
+	for (auto& it : CachedPipelines)
+	{
+		const VkPipelineKey& key = it.first.second;
+		if (key.VertexFormat < 0 || key.VertexFormat >= (int)VertexFormats.size() || key.DrawType < 0 || key.DrawType > DT_TriangleStrip ||
+			key.DepthFunc < 0 || key.DepthFunc > 2 || key.StencilPassOp < 0 || key.StencilPassOp > 2 || key.NumTextureLayers < 0 || key.NumTextureLayers > 16)
+			continue;
+
+		VkRenderPassSetup* setup = GetRenderPass(it.first.first);
+		if (setup->Pipelines.find(key) != setup->Pipelines.end())
+			continue;
+
+		auto builder = setup->CreatePipelineBuilder(key);
+		if (builder)
+			WarmupJobs.push_back({ setup, key, std::move(builder) });
+	}
+
+	if (WarmupJobs.empty())
+		return;
+
+	WarmupAbort = false;
+	WarmupDone = false;
+	WarmupThread = std::thread([this]()
+	{
+		uint64_t start = I_nsTime();
+		for (auto& job : WarmupJobs)
+		{
+			if (WarmupAbort)
+				break;
+
+			try
+			{
+				auto pipeline = job.Builder->Create(fb->device.get());
+				std::unique_lock<std::mutex> lock(job.Setup->WarmedPipelinesMutex);
+				job.Setup->WarmedPipelines[job.Key] = std::move(pipeline);
+				PipelinesWarmed++;
+			}
+			catch (...)
+			{
+				// The render state will run into the same error if it ever needs this pipeline.
+			}
+		}
+		WarmupTime += I_nsTime() - start;
+		WarmupDone = true;
+	});
+}
+
+void VkRenderPassManager::StopWarmup()
+{
+	if (WarmupThread.joinable())
+	{
+		WarmupAbort = true;
+		WarmupThread.join();
+	}
+	WarmupJobs.clear();
+}
+
+void VkRenderPassManager::PrintStats()
+{
+	Printf("Shader compilation: %.1f ms\n", fb->GetShaderManager()->GetCompileTime() / 1000000.0);
+	Printf("Pipeline cache: %s, %d known pipelines\n", CacheDataLoaded ? "loaded" : "not loaded", (int)CachedPipelines.size());
+	Printf("Pipelines warmed in background: %d in %.1f ms%s\n", PipelinesWarmed.load(), WarmupTime.load() / 1000000.0, WarmupThread.joinable() && !WarmupDone ? " (still running)" : "");
+	Printf("Pipelines created on demand: %d in %.1f ms\n", PipelinesCreated, PipelineCreateTime / 1000000.0);
+}
+
 void VkRenderPassManager::RenderBuffersReset()
 {
+	StopWarmup();
+	CollectUsedPipelines();
 	RenderPassSetup.clear();
 	PPRenderPassSetup.clear();
+	WarmupPending = true;
 }
 
 VkRenderPassSetup *VkRenderPassManager::GetRenderPass(const VkRenderPassKey &key)
@@ -166,6 +420,18 @@ VkPPRenderPassSetup* VkRenderPassManager::GetPPRenderPass(const VkPPRenderPassKe
 	return passSetup.get();
 }
 
+CCMD(vk_pipelinestats)
+{
+	if (screen->IsVulkan())
+	{
+		static_cast<VulkanRenderDevice*>(screen)->GetRenderPassManager()->PrintStats();
+	}
+	else
+	{
+		Printf("Vulkan is not the current render device\n");
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 VkRenderPassSetup::VkRenderPassSetup(VulkanRenderDevice* fb, const VkRenderPassKey &key) : PassKey(key), fb(fb)
@@ -235,13 +501,36 @@ VulkanPipeline *VkRenderPassSetup::GetPipeline(const VkPipelineKey &key)
 {
 	auto &item = Pipelines[key];
 	if (!item)
-		item = CreatePipeline(key);
+	{
+		{
+			std::unique_lock<std::mutex> lock(WarmedPipelinesMutex);
+			auto it = WarmedPipelines.find(key);
+			if (it != WarmedPipelines.end())
+			{
+				item = std::move(it->second);
+				WarmedPipelines.erase(it);
+			}
+		}
+
+		if (!item)
+		{
+			uint64_t start = I_nsTime();
+			item = CreatePipeline(key);
+			fb->GetRenderPassManager()->AddPipelineCreateTime(I_nsTime() - start);
+		}
+	}
 	return item.get();
 }
 
 std::unique_ptr<VulkanPipeline> VkRenderPassSetup::CreatePipeline(const VkPipelineKey &key)
 {
-	GraphicsPipelineBuilder builder;
+	return CreatePipelineBuilder(key)->Create(fb->device.get());
+}
+
+std::unique_ptr<GraphicsPipelineBuilder> VkRenderPassSetup::CreatePipelineBuilder(const VkPipelineKey &key)
+{
+	auto pbuilder = std::make_unique<GraphicsPipelineBuilder>();
+	GraphicsPipelineBuilder &builder = *pbuilder;
 	builder.Cache(fb->GetRenderPassManager()->GetCache());
 
 	VkShaderProgram *program;
@@ -253,6 +542,8 @@ std::unique_ptr<VulkanPipeline> VkRenderPassSetup::CreatePipeline(const VkPipeli
 	{
 		program = fb->GetShaderManager()->Get(key.EffectState, key.AlphaTest, PassKey.DrawBuffers > 1 ? GBUFFER_PASS : NORMAL_PASS);
 	}
+	if (!program)
+		return nullptr;
 	builder.AddVertexShader(program->vert.get());
 	builder.AddFragmentShader(program->frag.get());
 
@@ -328,7 +619,7 @@ std::unique_ptr<VulkanPipeline> VkRenderPassSetup::CreatePipeline(const VkPipeli
 	builder.RenderPass(GetRenderPass(0));
 	builder.DebugName("VkRenderPassSetup.Pipeline");
 
-	return builder.Create(fb->device.get());
+	return pbuilder;
 }
 
 /////////////////////////////////////////////////////////////////////////////
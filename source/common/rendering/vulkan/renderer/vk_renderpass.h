@@ -8,6 +8,9 @@
 #include "hw_renderstate.h"
 #include <string.h>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
 
 class VulkanRenderDevice;
 class VkPPShader;
@@ -63,6 +66,12 @@ public:
 	std::unique_ptr<VulkanRenderPass> RenderPasses[8];
 	std::map<VkPipelineKey, std::unique_ptr<VulkanPipeline>> Pipelines;
 
+	// Pipelines created by the warm-up thread that have not been asked for yet
+	std::mutex WarmedPipelinesMutex;
+	std::map<VkPipelineKey, std::unique_ptr<VulkanPipeline>> WarmedPipelines;
+
+	std::unique_ptr<GraphicsPipelineBuilder> CreatePipelineBuilder(const VkPipelineKey &key);
+
 private:
 	std::unique_ptr<VulkanRenderPass> CreateRenderPass(int clearTargets);
 	std::unique_ptr<VulkanPipeline> CreatePipeline(const VkPipelineKey &key);
@@ -137,7 +146,18 @@ public:
 
 	VulkanPipelineCache* GetCache() { return PipelineCache.get(); }
 
+	void BeginFrame();
+	void StopWarmup();
+	void PrintStats();
+
+	void AddPipelineCreateTime(uint64_t ns) { PipelinesCreated++; PipelineCreateTime += ns; }
+
 private:
+	void LoadCache();
+	void SaveCache();
+	void StartWarmup();
+	void CollectUsedPipelines();
+
 	VulkanRenderDevice* fb = nullptr;
 
 	std::map<VkRenderPassKey, std::unique_ptr<VkRenderPassSetup>> RenderPassSetup;
@@ -148,4 +168,27 @@ private:
 
 	FString CacheFilename;
 	std::unique_ptr<VulkanPipelineCache> PipelineCache;
+
+	// Every pipeline used in this or one of the recent sessions, with the number of sessions since it was last used
+	std::map<std::pair<VkRenderPassKey, VkPipelineKey>, uint32_t> CachedPipelines;
+	uint32_t CachedShaderHash = 0;
+	bool CacheDataLoaded = false;
+	bool WarmupPending = true;
+
+	struct WarmupJob
+	{
+		VkRenderPassSetup *Setup;
+		VkPipelineKey Key;
+		std::unique_ptr<GraphicsPipelineBuilder> Builder;
+	};
+
+	std::vector<WarmupJob> WarmupJobs;
+	std::thread WarmupThread;
+	std::atomic<bool> WarmupAbort = { false };
+	std::atomic<bool> WarmupDone = { false };
+	std::atomic<int> PipelinesWarmed = { 0 };
+	std::atomic<uint64_t> WarmupTime = { 0 };
+
+	int PipelinesCreated = 0;
+	uint64_t PipelineCreateTime = 0;
 };
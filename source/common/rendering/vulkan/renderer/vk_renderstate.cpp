@@ -40,6 +40,8 @@
 #include "hwrenderer/data/shaderuniforms.h"
 
 CVAR(Int, vk_submit_size, 1000, 0);
+CVAR(Bool, vk_multithreaded, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
+CVAR(Int, vk_chunk_size, 128, 0);
 EXTERN_CVAR(Bool, r_skipmats)
 
 VkRenderState::VkRenderState(VulkanRenderDevice* fb) : fb(fb), mStreamBufferWriter(fb), mMatrixBufferWriter(fb)
@@ -254,13 +256,18 @@ void VkRenderState::ApplyRenderPass(int dt)
 
 	if (!inRenderPass)
 	{
-		mCommandBuffer = fb->GetCommands()->GetDrawCommands();
+		mCommandBuffer = &mCommandList;
 		mScissorChanged = true;
 		mViewportChanged = true;
 		mStencilRefChanged = true;
 		mBias.mChanged = true;
 
-		BeginRenderPass(mCommandBuffer);
+		BeginRenderPass();
+	}
+	else if (mDeferredPass && mCommandList.ChunkDrawCount() >= vk_chunk_size)
+	{
+		BeginChunk();
+		changingPipeline = true;
 	}
 
 	if (changingPipeline)
@@ -491,7 +498,29 @@ void VkRenderState::EndRenderPass()
 {
 	if (mCommandBuffer)
 	{
-		mCommandBuffer->endRenderPass();
+		if (mDeferredPass)
+			fb->GetCommands()->SetDeferredPass(nullptr);
+
+		auto cmdbuffer = fb->GetCommands()->GetDrawCommands();
+		if (!mDeferredPass)
+		{
+			// Already begun and recorded directly.
+		}
+		else if (mCommandList.NumChunks() > 1)
+		{
+			mPassBegin->Execute(cmdbuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+			fb->GetCommands()->ExecuteCommandList(mCommandList, mPassBeginRenderPass, mPassBeginFramebuffer);
+		}
+		else
+		{
+			mPassBegin->Execute(cmdbuffer);
+			if (mCommandList.NumChunks() == 1)
+				mCommandList.Execute(cmdbuffer->buffer, 0);
+		}
+		cmdbuffer->endRenderPass();
+
+		mCommandList.Clear();
+		mPassBegin.reset();
 		mCommandBuffer = nullptr;
 		mPipelineKey = {};
 
@@ -530,7 +559,17 @@ void VkRenderState::SetRenderTarget(VkTextureImage *image, VulkanImageView *dept
 	mRenderTarget.Samples = samples;
 }
 
-void VkRenderState::BeginRenderPass(VulkanCommandBuffer *cmdbuffer)
+//==========================================================================
+//
+// With vk_multithreaded the render pass only gets begun on the draw
+// commands once it ends, as by then it is known whether its commands went
+// into a single chunk that can be recorded inline or must be recorded into
+// secondary command buffers. Otherwise it is begun right away and the
+// commands are recorded directly.
+//
+//==========================================================================
+
+void VkRenderState::BeginRenderPass()
 {
 	VkRenderPassKey key = {};
 	key.DrawBufferFormat = mRenderTarget.Format;
@@ -562,22 +601,58 @@ void VkRenderState::BeginRenderPass(VulkanCommandBuffer *cmdbuffer)
 	if (!mRenderTarget.DepthStencil)
 		mClearTargets &= ~(CT_Depth | CT_Stencil);
 
-	RenderPassBegin beginInfo;
-	beginInfo.RenderPass(mPassSetup->GetRenderPass(mClearTargets));
-	beginInfo.RenderArea(0, 0, mRenderTarget.Width, mRenderTarget.Height);
-	beginInfo.Framebuffer(framebuffer.get());
-	beginInfo.AddClearColor(screen->mSceneClearColor[0], screen->mSceneClearColor[1], screen->mSceneClearColor[2], screen->mSceneClearColor[3]);
+	mPassBeginRenderPass = mPassSetup->GetRenderPass(mClearTargets);
+	mPassBeginFramebuffer = framebuffer.get();
+
+	mPassBegin = std::make_unique<RenderPassBegin>();
+	mPassBegin->RenderPass(mPassBeginRenderPass);
+	mPassBegin->RenderArea(0, 0, mRenderTarget.Width, mRenderTarget.Height);
+	mPassBegin->Framebuffer(mPassBeginFramebuffer);
+	mPassBegin->AddClearColor(screen->mSceneClearColor[0], screen->mSceneClearColor[1], screen->mSceneClearColor[2], screen->mSceneClearColor[3]);
 	if (key.DrawBuffers > 1)
-		beginInfo.AddClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		mPassBegin->AddClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	if (key.DrawBuffers > 2)
-		beginInfo.AddClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-	beginInfo.AddClearDepthStencil(1.0f, 0);
-	beginInfo.Execute(cmdbuffer);
+		mPassBegin->AddClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	mPassBegin->AddClearDepthStencil(1.0f, 0);
+
+	mDeferredPass = vk_multithreaded;
+	if (mDeferredPass)
+	{
+		fb->GetCommands()->SetDeferredPass(&mCommandList);
+	}
+	else
+	{
+		auto cmdbuffer = fb->GetCommands()->GetDrawCommands();
+		mPassBegin->Execute(cmdbuffer);
+		mCommandList.SetDirect(cmdbuffer->buffer);
+	}
 
 	mMaterial.mChanged = true;
 	mClearTargets = 0;
 }
 
+//==========================================================================
+//
+// Every chunk is recorded into its own secondary command buffer, which
+// starts out without any state bound. Everything has to be set again.
+//
+//==========================================================================
+
+void VkRenderState::BeginChunk()
+{
+	mCommandList.NewChunk();
+
+	mScissorChanged = true;
+	mViewportChanged = true;
+	mStencilRefChanged = true;
+	mBias.mChanged = true;
+	mMaterial.mChanged = true;
+
+	mLastViewpointOffset = 0xffffffff;
+	mLastVertexBuffer = nullptr;
+	mLastIndexBuffer = nullptr;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 void VkRenderStateMolten::Draw(int dt, int index, int count, bool apply)
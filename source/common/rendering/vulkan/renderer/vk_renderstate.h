@@ -5,6 +5,7 @@
 #include "vulkan/shaders/vk_shader.h"
 #include "vulkan/renderer/vk_renderpass.h"
 #include "vulkan/renderer/vk_streambuffer.h"
+#include "vulkan/system/vk_commandlist.h"
 
 #include "name.h"
 
@@ -64,13 +65,19 @@ protected:
 	void ApplyVertexBuffers();
 	void ApplyMaterial();
 
-	void BeginRenderPass(VulkanCommandBuffer *cmdbuffer);
+	void BeginRenderPass();
+	void BeginChunk();
 	void WaitForStreamBuffers();
 
 	VulkanRenderDevice* fb = nullptr;
 
 	bool mDepthClamp = true;
-	VulkanCommandBuffer *mCommandBuffer = nullptr;
+	VkCommandList *mCommandBuffer = nullptr;
+	VkCommandList mCommandList;
+	bool mDeferredPass = false;
+	std::unique_ptr<RenderPassBegin> mPassBegin;
+	VulkanRenderPass *mPassBeginRenderPass = nullptr;
+	VulkanFramebuffer *mPassBeginFramebuffer = nullptr;
 	VkPipelineKey mPipelineKey = {};
 	VkRenderPassSetup *mPassSetup = nullptr;
 	int mClearTargets = 0;
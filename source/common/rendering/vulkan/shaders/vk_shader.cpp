@@ -28,12 +28,15 @@
 #include "filesystem.h"
 #include "engineerrors.h"
 #include "version.h"
+#include "i_time.h"
+#include "m_crc32.h"
 
 bool VkShaderManager::CompileNextShader()
 {
 	const char *mainvp = "shaders/glsl/main.vp";
 	const char *mainfp = "shaders/glsl/main.fp";
 	int i = compileIndex;
+	uint64_t start = I_nsTime();
 
 	if (compileState == 0)
 	{
@@ -104,11 +107,13 @@ bool VkShaderManager::CompileNextShader()
 			if (compilePass == MAX_PASS_TYPES)
 			{
 				compileIndex = -1; // we're done.
+				mCompileTime += I_nsTime() - start;
 				return true;
 			}
 			compileState = 0;
 		}
 	}
+	mCompileTime += I_nsTime() - start;
 	return false;
 }
 
@@ -350,6 +355,8 @@ std::unique_ptr<VulkanShader> VkShaderManager::LoadVertShader(FString shadername
 	code << "#line 1\n";
 	code << LoadPrivateShaderLump(vert_lump).GetChars() << "\n";
 
+	mSourceHash = AddCRC32(mSourceHash, (const uint8_t*)code.GetChars(), (unsigned int)code.Len());
+
 	return ShaderBuilder()
 		.VertexShader(code.GetChars())
 		.DebugName(shadername.GetChars())
@@ -442,6 +449,8 @@ std::unique_ptr<VulkanShader> VkShaderManager::LoadFragShader(FString shadername
 		code << LoadPrivateShaderLump(light_lump).GetChars();
 	}
 
+	mSourceHash = AddCRC32(mSourceHash, (const uint8_t*)code.GetChars(), (unsigned int)code.Len());
+
 	return ShaderBuilder()
 		.FragmentShader(code.GetChars())
 		.DebugName(shadername.GetChars())
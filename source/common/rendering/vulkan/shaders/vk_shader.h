@@ -75,6 +75,11 @@ public:
 	VkShaderProgram *GetEffect(int effect, EPassType passType);
 	VkShaderProgram *Get(unsigned int eff, bool alphateston, EPassType passType);
 	bool CompileNextShader();
+	bool IsCompiled() const { return compileIndex == -1; }
+
+	// Hash of the GLSL sources of all the material and effect shaders
+	uint32_t GetSourceHash() const { return mSourceHash; }
+	uint64_t GetCompileTime() const { return mCompileTime; }
 
 	VkPPShader* GetVkShader(PPShader* shader);
 
@@ -96,6 +101,8 @@ private:
 	std::vector<VkShaderProgram> mEffectShaders[MAX_PASS_TYPES];
 	uint8_t compilePass = 0, compileState = 0;
 	int compileIndex = 0;
+	uint32_t mSourceHash = 0;
+	uint64_t mCompileTime = 0;
 
 	std::list<VkPPShader*> PPShaders;
 };
@@ -21,6 +21,7 @@
 */
 
 #include "vk_commandbuffer.h"
+#include "vk_commandlist.h"
 #include "vk_renderdevice.h"
 #include "zvulkan/vulkanswapchain.h"
 #include "zvulkan/vulkanbuilders.h"
@@ -29,6 +30,10 @@
 #include "vulkan/renderer/vk_postprocess.h"
 #include "hw_clock.h"
 #include "v_video.h"
+#include "r_thread.h"
+#include "r_memory.h"
+#include <atomic>
+#include <mutex>
 
 extern int rendered_commandbuffers;
 int current_rendered_commandbuffers;
@@ -44,6 +49,8 @@ VkCommandBufferManager::VkCommandBufferManager(VulkanRenderDevice* fb) : fb(fb)
 		.DebugName("mCommandPool")
 		.Create(fb->device.get());
 
+	mWorkerMemory = std::make_unique<RenderMemory>();
+
 	for (auto& semaphore : mSubmitSemaphore)
 		semaphore.reset(new VulkanSemaphore(fb->device.get()));
 
@@ -80,6 +87,9 @@ VulkanCommandBuffer* VkCommandBufferManager::GetTransferCommands()
 
 VulkanCommandBuffer* VkCommandBufferManager::GetDrawCommands()
 {
+	if (mDeferredPass)
+		fb->GetRenderState()->EndRenderPass();
+
 	if (!mDrawCommands)
 	{
 		mDrawCommands = mCommandPool->createBuffer();
@@ -159,6 +169,115 @@ void VkCommandBufferManager::FlushCommands(bool finish, bool lastsubmit, bool up
 	}
 }
 
+//==========================================================================
+//
+// Shared state of the workers recording the secondary command buffers.
+// Each worker claims a command pool slot and then keeps taking chunks
+// until none are left, so it does not matter how DrawerThreads numbers
+// its threads.
+//
+//==========================================================================
+
+struct VkRecordChunksJob
+{
+	const VkCommandList* List = nullptr;
+	VkCommandBufferInheritanceInfo Inheritance = {};
+	VulkanDevice* Device = nullptr;
+	std::unique_ptr<VulkanCommandPool>* Pools = nullptr;
+	int MaxPools = 0;
+	std::unique_ptr<VulkanCommandBuffer>* Buffers = nullptr;
+	int NumChunks = 0;
+
+	std::atomic<int> NextPool = { 0 };
+	std::atomic<int> NextChunk = { 0 };
+	std::mutex ErrorMutex;
+	std::exception_ptr Error;
+};
+
+class VkRecordChunksCommand : public DrawerCommand
+{
+public:
+	VkRecordChunksCommand(VkRecordChunksJob* job) : job(job) { }
+
+	void Execute(DrawerThread* thread) override
+	{
+		int slot = job->NextPool++;
+		if (slot >= job->MaxPools)
+			return;
+
+		try
+		{
+			auto& pool = job->Pools[slot];
+			if (!pool)
+			{
+				pool = CommandPoolBuilder()
+					.QueueFamily(job->Device->GraphicsFamily)
+					.DebugName("VkCommandBufferManager.mWorkerPools")
+					.Create(job->Device);
+			}
+
+			while (true)
+			{
+				int chunk = job->NextChunk++;
+				if (chunk >= job->NumChunks)
+					break;
+
+				auto cmdbuffer = pool->createBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+				cmdbuffer->begin(&job->Inheritance, VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+				job->List->Execute(cmdbuffer->buffer, chunk);
+				cmdbuffer->end();
+				job->Buffers[chunk] = std::move(cmdbuffer);
+			}
+		}
+		catch (...)
+		{
+			std::unique_lock<std::mutex> lock(job->ErrorMutex);
+			if (!job->Error)
+				job->Error = std::current_exception();
+		}
+	}
+
+private:
+	VkRecordChunksJob* job;
+};
+
+void VkCommandBufferManager::ExecuteCommandList(const VkCommandList& list, VulkanRenderPass* renderPass, VulkanFramebuffer* framebuffer)
+{
+	int numChunks = list.NumChunks();
+	std::vector<std::unique_ptr<VulkanCommandBuffer>> buffers(numChunks);
+
+	VkRecordChunksJob job;
+	job.List = &list;
+	job.Inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	job.Inheritance.renderPass = renderPass->renderPass;
+	job.Inheritance.subpass = 0;
+	job.Inheritance.framebuffer = framebuffer->framebuffer;
+	job.Device = fb->device.get();
+	job.Pools = mWorkerPools;
+	job.MaxPools = MaxWorkerPools;
+	job.Buffers = buffers.data();
+	job.NumChunks = numChunks;
+
+	auto queue = std::make_shared<DrawerCommandQueue>(mWorkerMemory.get());
+	queue->Push<VkRecordChunksCommand>(&job);
+	DrawerThreads::Execute(queue);
+	DrawerThreads::WaitForWorkers();
+	mWorkerMemory->Clear();
+
+	if (job.Error)
+		std::rethrow_exception(job.Error);
+
+	std::vector<VkCommandBuffer> handles;
+	handles.reserve(numChunks);
+	for (auto& cmdbuffer : buffers)
+		handles.push_back(cmdbuffer->buffer);
+
+	GetDrawCommands()->executeCommands((uint32_t)handles.size(), handles.data());
+
+	for (auto& cmdbuffer : buffers)
+		DrawDeleteList->Add(std::move(cmdbuffer));
+}
+
 void VkCommandBufferManager::WaitForCommands(bool finish, bool uploadOnly)
 {
 	if (finish)
@@ -214,7 +333,10 @@ void VkCommandBufferManager::PushGroup(const FString& name)
 		q.name = name;
 		q.startIndex = mNextTimestampQuery++;
 		q.endIndex = 0;
-		GetDrawCommands()->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.startIndex);
+		if (mDeferredPass)
+			mDeferredPass->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.startIndex);
+		else
+			GetDrawCommands()->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.startIndex);
 		mGroupStack.push_back(timeElapsedQueries.size());
 		timeElapsedQueries.push_back(q);
 	}
@@ -231,7 +353,10 @@ void VkCommandBufferManager::PopGroup()
 	if (mNextTimestampQuery < MaxTimestampQueries && fb->device->GraphicsTimeQueries)
 	{
 		q.endIndex = mNextTimestampQuery++;
-		GetDrawCommands()->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.endIndex);
+		if (mDeferredPass)
+			mDeferredPass->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.endIndex);
+		else
+			GetDrawCommands()->writeTimestamp(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, mTimestampQueryPool.get(), q.endIndex);
 	}
 }
 
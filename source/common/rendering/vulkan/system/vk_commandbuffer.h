@@ -5,6 +5,8 @@
 #include "zstring.h"
 
 class VulkanRenderDevice;
+class VkCommandList;
+class RenderMemory;
 
 class VkCommandBufferManager
 {
@@ -17,8 +19,18 @@ public:
 	VulkanCommandBuffer* GetTransferCommands();
 	VulkanCommandBuffer* GetDrawCommands();
 
+	// While a render pass is being recorded into a deferred list, the pass has not been begun on
+	// the draw commands yet. Anything else recorded into them must come after the pass, so
+	// GetDrawCommands ends it first. Timestamps go into the list so that they stay inside the pass.
+	void SetDeferredPass(VkCommandList* list) { mDeferredPass = list; }
+
 	void FlushCommands(bool finish, bool lastsubmit = false, bool uploadOnly = false);
 
+	// Records every chunk of the list into its own secondary command buffer on the
+	// drawer worker threads and then executes them, in order, on the draw commands.
+	// The render pass must have been begun with secondary command buffer contents.
+	void ExecuteCommandList(const VkCommandList& list, VulkanRenderPass* renderPass, VulkanFramebuffer* framebuffer);
+
 	void WaitForCommands(bool finish) { WaitForCommands(finish, false); }
 	void WaitForCommands(bool finish, bool uploadOnly);
 
@@ -65,8 +77,14 @@ private:
 
 	std::unique_ptr<VulkanCommandPool> mCommandPool;
 
+	// Command pools may only be used by one thread at a time, so every worker gets its own.
+	enum { MaxWorkerPools = 64 };
+	std::unique_ptr<VulkanCommandPool> mWorkerPools[MaxWorkerPools];
+	std::unique_ptr<RenderMemory> mWorkerMemory;
+
 	std::unique_ptr<VulkanCommandBuffer> mTransferCommands;
 	std::unique_ptr<VulkanCommandBuffer> mDrawCommands;
+	VkCommandList* mDeferredPass = nullptr;
 
 	enum { maxConcurrentSubmitCount = 8 };
 	std::unique_ptr<VulkanSemaphore> mSubmitSemaphore[maxConcurrentSubmitCount];
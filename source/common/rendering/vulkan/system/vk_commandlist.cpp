@@ -0,0 +1,285 @@
+/*
+**  Vulkan backend
+**  Copyright (c) 2016-2020 Magnus Norddahl
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+*/
+
+#include "vk_commandlist.h"
+#include <cstring>
+#include <cassert>
+
+namespace
+{
+	struct CommandHeader
+	{
+		uint32_t Type;
+		uint32_t ExtraSize;
+	};
+
+	struct BindPipelineArgs { VkPipelineBindPoint BindPoint; VkPipeline Pipeline; };
+	struct SetViewportArgs { VkViewport Viewport; };
+	struct SetScissorArgs { VkRect2D Scissor; };
+	struct SetDepthBiasArgs { float ConstantFactor, Clamp, SlopeFactor; };
+	struct SetStencilReferenceArgs { VkStencilFaceFlags FaceMask; uint32_t Reference; };
+	struct BindDescriptorSetArgs { VkPipelineBindPoint BindPoint; VkPipelineLayout Layout; uint32_t SetIndex; VkDescriptorSet Set; uint32_t DynamicOffsetCount; };
+	struct BindIndexBufferArgs { VkBuffer Buffer; VkDeviceSize Offset; VkIndexType IndexType; };
+	struct BindVertexBuffersArgs { uint32_t FirstBinding, BindingCount; };
+	struct DrawArgs { uint32_t VertexCount, InstanceCount, FirstVertex, FirstInstance; };
+	struct DrawIndexedArgs { uint32_t IndexCount, InstanceCount, FirstIndex; int32_t VertexOffset; uint32_t FirstInstance; };
+	struct PushConstantsArgs { VkPipelineLayout Layout; VkShaderStageFlags StageFlags; uint32_t Offset, Size; };
+	struct WriteTimestampArgs { VkPipelineStageFlagBits Stage; VkQueryPool QueryPool; uint32_t Query; };
+
+	// Keeps all entries aligned for the largest member any of them has.
+	constexpr size_t Align(size_t size) { return (size + 7) & ~size_t(7); }
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+template<typename T>
+void VkCommandList::Write(CommandType type, const T &data, const void *extra, uint32_t extrasize)
+{
+	if (mChunks.empty() && !mDirect)
+		mChunks.push_back(0);
+
+	size_t start = mData.size();
+	size_t pos = start;
+	mData.resize(pos + Align(sizeof(CommandHeader)) + Align(sizeof(T)) + Align(extrasize));
+
+	CommandHeader header = { (uint32_t)type, extrasize };
+	memcpy(&mData[pos], &header, sizeof(CommandHeader));
+	pos += Align(sizeof(CommandHeader));
+	memcpy(&mData[pos], &data, sizeof(T));
+	pos += Align(sizeof(T));
+	if (extrasize)
+		memcpy(&mData[pos], extra, extrasize);
+
+	if (mDirect)
+	{
+		Execute(mDirect, start, mData.size());
+		mData.resize(start);
+	}
+}
+
+void VkCommandList::bindPipeline(VkPipelineBindPoint pipelineBindPoint, VulkanPipeline *pipeline)
+{
+	Write(CmdBindPipeline, BindPipelineArgs{ pipelineBindPoint, pipeline->pipeline });
+}
+
+void VkCommandList::setViewport(uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports)
+{
+	assert(firstViewport == 0 && viewportCount == 1);
+	Write(CmdSetViewport, SetViewportArgs{ *pViewports });
+}
+
+void VkCommandList::setScissor(uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors)
+{
+	assert(firstScissor == 0 && scissorCount == 1);
+	Write(CmdSetScissor, SetScissorArgs{ *pScissors });
+}
+
+void VkCommandList::setDepthBias(float depthBiasConstantFactor, float depthBiasClamp, float depthBiasSlopeFactor)
+{
+	Write(CmdSetDepthBias, SetDepthBiasArgs{ depthBiasConstantFactor, depthBiasClamp, depthBiasSlopeFactor });
+}
+
+void VkCommandList::setStencilReference(VkStencilFaceFlags faceMask, uint32_t reference)
+{
+	Write(CmdSetStencilReference, SetStencilReferenceArgs{ faceMask, reference });
+}
+
+void VkCommandList::bindDescriptorSet(VkPipelineBindPoint pipelineBindPoint, VulkanPipelineLayout *layout, uint32_t setIndex, VulkanDescriptorSet *descriptorSet, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+{
+	assert(dynamicOffsetCount <= MaxDynamicOffsets);
+	Write(CmdBindDescriptorSet, BindDescriptorSetArgs{ pipelineBindPoint, layout->layout, setIndex, descriptorSet->set, dynamicOffsetCount }, pDynamicOffsets, dynamicOffsetCount * sizeof(uint32_t));
+}
+
+void VkCommandList::bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+{
+	Write(CmdBindIndexBuffer, BindIndexBufferArgs{ buffer, offset, indexType });
+}
+
+void VkCommandList::bindVertexBuffers(uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets)
+{
+	assert(bindingCount <= MaxVertexBindings);
+	uint8_t extra[MaxVertexBindings * (sizeof(VkBuffer) + sizeof(VkDeviceSize))];
+	memcpy(extra, pBuffers, bindingCount * sizeof(VkBuffer));
+	memcpy(extra + bindingCount * sizeof(VkBuffer), pOffsets, bindingCount * sizeof(VkDeviceSize));
+	Write(CmdBindVertexBuffers, BindVertexBuffersArgs{ firstBinding, bindingCount }, extra, bindingCount * uint32_t(sizeof(VkBuffer) + sizeof(VkDeviceSize)));
+}
+
+void VkCommandList::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+{
+	Write(CmdDraw, DrawArgs{ vertexCount, instanceCount, firstVertex, firstInstance });
+	mChunkDraws++;
+}
+
+void VkCommandList::drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+{
+	Write(CmdDrawIndexed, DrawIndexedArgs{ indexCount, instanceCount, firstIndex, vertexOffset, firstInstance });
+	mChunkDraws++;
+}
+
+void VkCommandList::pushConstants(VulkanPipelineLayout *layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues)
+{
+	Write(CmdPushConstants, PushConstantsArgs{ layout->layout, stageFlags, offset, size }, pValues, size);
+}
+
+void VkCommandList::writeTimestamp(VkPipelineStageFlagBits pipelineStage, VulkanQueryPool *queryPool, uint32_t query)
+{
+	Write(CmdWriteTimestamp, WriteTimestampArgs{ pipelineStage, queryPool->pool, query });
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void VkCommandList::NewChunk()
+{
+	if (!mChunks.empty() && mChunks.back() != mData.size())
+		mChunks.push_back(mData.size());
+	mChunkDraws = 0;
+}
+
+void VkCommandList::Clear()
+{
+	mData.clear();
+	mChunks.clear();
+	mChunkDraws = 0;
+	mDirect = VK_NULL_HANDLE;
+}
+
+//==========================================================================
+//
+// Only reads from the list, so the chunks can be replayed concurrently.
+//
+//==========================================================================
+
+void VkCommandList::Execute(VkCommandBuffer cmdbuffer, int chunk) const
+{
+	size_t pos = mChunks[chunk];
+	size_t end = (chunk + 1 < (int)mChunks.size()) ? mChunks[chunk + 1] : mData.size();
+	Execute(cmdbuffer, pos, end);
+}
+
+void VkCommandList::Execute(VkCommandBuffer cmdbuffer, size_t pos, size_t end) const
+{
+	const uint8_t *data = mData.data();
+
+	while (pos < end)
+	{
+		CommandHeader header;
+		memcpy(&header, data + pos, sizeof(CommandHeader));
+		const uint8_t *args = data + pos + Align(sizeof(CommandHeader));
+
+		size_t argsize;
+		switch (header.Type)
+		{
+		case CmdBindPipeline:
+		{
+			BindPipelineArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdBindPipeline(cmdbuffer, a.BindPoint, a.Pipeline);
+			break;
+		}
+		case CmdSetViewport:
+		{
+			SetViewportArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdSetViewport(cmdbuffer, 0, 1, &a.Viewport);
+			break;
+		}
+		case CmdSetScissor:
+		{
+			SetScissorArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdSetScissor(cmdbuffer, 0, 1, &a.Scissor);
+			break;
+		}
+		case CmdSetDepthBias:
+		{
+			SetDepthBiasArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdSetDepthBias(cmdbuffer, a.ConstantFactor, a.Clamp, a.SlopeFactor);
+			break;
+		}
+		case CmdSetStencilReference:
+		{
+			SetStencilReferenceArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdSetStencilReference(cmdbuffer, a.FaceMask, a.Reference);
+			break;
+		}
+		case CmdBindDescriptorSet:
+		{
+			BindDescriptorSetArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			uint32_t offsets[MaxDynamicOffsets];
+			memcpy(offsets, args + Align(sizeof(a)), header.ExtraSize);
+			vkCmdBindDescriptorSets(cmdbuffer, a.BindPoint, a.Layout, a.SetIndex, 1, &a.Set, a.DynamicOffsetCount, offsets);
+			break;
+		}
+		case CmdBindIndexBuffer:
+		{
+			BindIndexBufferArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdBindIndexBuffer(cmdbuffer, a.Buffer, a.Offset, a.IndexType);
+			break;
+		}
+		case CmdBindVertexBuffers:
+		{
+			BindVertexBuffersArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			VkBuffer buffers[MaxVertexBindings];
+			VkDeviceSize offsets[MaxVertexBindings];
+			const uint8_t *extra = args + Align(sizeof(a));
+			memcpy(buffers, extra, a.BindingCount * sizeof(VkBuffer));
+			memcpy(offsets, extra + a.BindingCount * sizeof(VkBuffer), a.BindingCount * sizeof(VkDeviceSize));
+			vkCmdBindVertexBuffers(cmdbuffer, a.FirstBinding, a.BindingCount, buffers, offsets);
+			break;
+		}
+		case CmdDraw:
+		{
+			DrawArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdDraw(cmdbuffer, a.VertexCount, a.InstanceCount, a.FirstVertex, a.FirstInstance);
+			break;
+		}
+		case CmdDrawIndexed:
+		{
+			DrawIndexedArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdDrawIndexed(cmdbuffer, a.IndexCount, a.InstanceCount, a.FirstIndex, a.VertexOffset, a.FirstInstance);
+			break;
+		}
+		case CmdPushConstants:
+		{
+			PushConstantsArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdPushConstants(cmdbuffer, a.Layout, a.StageFlags, a.Offset, a.Size, args + Align(sizeof(a)));
+			break;
+		}
+		case CmdWriteTimestamp:
+		{
+			WriteTimestampArgs a; memcpy(&a, args, sizeof(a)); argsize = sizeof(a);
+			vkCmdWriteTimestamp(cmdbuffer, a.Stage, a.QueryPool, a.Query);
+			break;
+		}
+		default:
+			assert(false);
+			return;
+		}
+
+		pos += Align(sizeof(CommandHeader)) + Align(argsize) + Align(header.ExtraSize);
+	}
+}
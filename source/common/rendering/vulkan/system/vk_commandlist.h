@@ -0,0 +1,68 @@
+#pragma once
+
+#include <zvulkan/vulkanobjects.h>
+#include <vector>
+
+// Deferred list of the commands issued inside a render pass.
+//
+// It has the same interface as VulkanCommandBuffer for everything VkRenderState
+// records, but only stores the raw handles and parameters. When the render pass
+// ends the list is replayed, either straight into the primary command buffer or,
+// if it was split into multiple chunks, into one secondary command buffer per
+// chunk. Every chunk must therefore begin by binding all the state it uses.
+//
+// In direct mode every command is recorded into the given command buffer right
+// away instead, which is used when the pass is not recorded on worker threads.
+
+class VkCommandList
+{
+public:
+	void bindPipeline(VkPipelineBindPoint pipelineBindPoint, VulkanPipeline *pipeline);
+	void setViewport(uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports);
+	void setScissor(uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors);
+	void setDepthBias(float depthBiasConstantFactor, float depthBiasClamp, float depthBiasSlopeFactor);
+	void setStencilReference(VkStencilFaceFlags faceMask, uint32_t reference);
+	void bindDescriptorSet(VkPipelineBindPoint pipelineBindPoint, VulkanPipelineLayout *layout, uint32_t setIndex, VulkanDescriptorSet *descriptorSet, uint32_t dynamicOffsetCount = 0, const uint32_t* pDynamicOffsets = nullptr);
+	void bindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+	void bindVertexBuffers(uint32_t firstBinding, uint32_t bindingCount, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets);
+	void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+	void drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance);
+	void pushConstants(VulkanPipelineLayout *layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues);
+	void writeTimestamp(VkPipelineStageFlagBits pipelineStage, VulkanQueryPool *queryPool, uint32_t query);
+
+	void SetDirect(VkCommandBuffer cmdbuffer) { mDirect = cmdbuffer; }
+	void NewChunk();
+	void Clear();
+
+	int NumChunks() const { return (int)mChunks.size(); }
+	int ChunkDrawCount() const { return mChunkDraws; }
+
+	void Execute(VkCommandBuffer cmdbuffer, int chunk) const;
+
+private:
+	enum CommandType : uint32_t
+	{
+		CmdBindPipeline,
+		CmdSetViewport,
+		CmdSetScissor,
+		CmdSetDepthBias,
+		CmdSetStencilReference,
+		CmdBindDescriptorSet,
+		CmdBindIndexBuffer,
+		CmdBindVertexBuffers,
+		CmdDraw,
+		CmdDrawIndexed,
+		CmdPushConstants,
+		CmdWriteTimestamp
+	};
+
+	enum { MaxDynamicOffsets = 4, MaxVertexBindings = 2 };
+
+	template<typename T> void Write(CommandType type, const T &data, const void *extra = nullptr, uint32_t extrasize = 0);
+	void Execute(VkCommandBuffer cmdbuffer, size_t pos, size_t end) const;
+
+	std::vector<uint8_t> mData;
+	std::vector<size_t> mChunks;
+	int mChunkDraws = 0;
+	VkCommandBuffer mDirect = VK_NULL_HANDLE;
+};
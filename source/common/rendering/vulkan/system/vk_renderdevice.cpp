@@ -148,6 +148,9 @@ VulkanRenderDevice::VulkanRenderDevice(void *hMonitor, bool fullscreen, std::sha
 
 VulkanRenderDevice::~VulkanRenderDevice()
 {
+	if (mRenderPassManager)
+		mRenderPassManager->StopWarmup();
+
 	vkDeviceWaitIdle(device->device); // make sure the GPU is no longer using any objects before RAII tears them down
 
 	delete mVertexData;
@@ -483,6 +486,7 @@ void VulkanRenderDevice::BeginFrame()
 	mTextureManager->BeginFrame();
 	mScreenBuffers->BeginFrame(screen->mScreenViewport.width, screen->mScreenViewport.height, screen->mSceneViewport.width, screen->mSceneViewport.height);
 	mSaveBuffers->BeginFrame(SAVEPICWIDTH, SAVEPICHEIGHT, SAVEPICWIDTH, SAVEPICHEIGHT);
+	mRenderPassManager->BeginFrame();
 	mRenderState->BeginFrame();
 	mDescriptorSetManager->BeginFrame();
 }
@@ -25,6 +25,7 @@
 #include "hw_material.h"
 #include "hw_cvars.h"
 #include "hw_renderstate.h"
+#include "hw_texcompress.h"
 #include <zvulkan/vulkanobjects.h>
 #include <zvulkan/vulkanbuilders.h>
 #include "vulkan/system/vk_renderdevice.h"
@@ -62,6 +63,7 @@ void VkHardwareTexture::Reset()
 		mImage.Reset(fb);
 		mDepthStencil.Reset(fb);
 	}
+	SetAllocatedSize(0);
 }
 
 VkTextureImage *VkHardwareTexture::GetImage(FTexture *tex, int translation, int flags)
@@ -109,7 +111,16 @@ void VkHardwareTexture::CreateImage(FTexture *tex, int translation, int flags)
 	{
 		FTextureBuffer texbuffer = tex->CreateTexBuffer(translation, flags | CTF_ProcessData);
 		bool indexed = flags & CTF_Indexed;
-		CreateTexture(texbuffer.mWidth, texbuffer.mHeight,indexed? 1 : 4, indexed? VK_FORMAT_R8_UNORM : VK_FORMAT_B8G8R8A8_UNORM, texbuffer.mBuffer, !indexed);
+		FCompressedTexture compressed;
+		if (fb->device->EnabledFeatures.Features.textureCompressionBC && ShouldCompressTexture(texbuffer.mWidth, texbuffer.mHeight, flags) &&
+			CompressTexture(texbuffer.mBuffer, texbuffer.mWidth, texbuffer.mHeight, true, compressed))
+		{
+			CreateCompressedTexture(compressed);
+		}
+		else
+		{
+			CreateTexture(texbuffer.mWidth, texbuffer.mHeight, indexed ? 1 : 4, indexed ? VK_FORMAT_R8_UNORM : VK_FORMAT_B8G8R8A8_UNORM, texbuffer.mBuffer, !indexed);
+		}
 	}
 	else
 	{
@@ -179,6 +190,7 @@ void VkHardwareTexture::CreateTexture(int w, int h, int pixelsize, VkFormat form
 	cmdbuffer->copyBufferToImage(stagingBuffer->buffer, mImage.Image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
 	if (mipmap) mImage.GenerateMipmaps(cmdbuffer);
+	SetAllocatedSize(mipmap ? totalSize + totalSize / 3 : totalSize);
 
 	// If we queued more than 64 MB of data already: wait until the uploads finish before continuing
 	fb->GetCommands()->TransferDeleteList->Add(std::move(stagingBuffer));
@@ -186,6 +198,72 @@ void VkHardwareTexture::CreateTexture(int w, int h, int pixelsize, VkFormat form
 		fb->GetCommands()->WaitForCommands(false, true);
 }
 
+//==========================================================================
+//
+// Block compressed formats cannot be blitted, so these come with the
+// entire mip chain already included.
+//
+//==========================================================================
+
+void VkHardwareTexture::CreateCompressedTexture(const FCompressedTexture &tex)
+{
+	VkFormat format = tex.Format == TEXCOMP_BC3 ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+	int levels = tex.NumLevels();
+	size_t totalSize = tex.Data.Size();
+
+	auto stagingBuffer = BufferBuilder()
+		.Size(totalSize)
+		.Usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY)
+		.DebugName("VkHardwareTexture.mStagingBuffer")
+		.Create(fb->device.get());
+
+	uint8_t *data = (uint8_t*)stagingBuffer->Map(0, totalSize);
+	memcpy(data, tex.Data.Data(), totalSize);
+	stagingBuffer->Unmap();
+
+	mImage.Image = ImageBuilder()
+		.Format(format)
+		.Size(tex.Width, tex.Height, levels)
+		.Usage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+		.DebugName("VkHardwareTexture.mImage")
+		.Create(fb->device.get());
+
+	mImage.View = ImageViewBuilder()
+		.Image(mImage.Image.get(), format)
+		.DebugName("VkHardwareTexture.mImageView")
+		.Create(fb->device.get());
+
+	auto cmdbuffer = fb->GetCommands()->GetTransferCommands();
+
+	VkImageTransition()
+		.AddImage(&mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true, 0, levels)
+		.Execute(cmdbuffer);
+
+	TArray<VkBufferImageCopy> regions(levels, true);
+	for (int i = 0; i < levels; i++)
+	{
+		VkBufferImageCopy &region = regions[i];
+		region = {};
+		region.bufferOffset = tex.LevelOffsets[i];
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = i;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent.depth = 1;
+		region.imageExtent.width = tex.LevelWidth(i);
+		region.imageExtent.height = tex.LevelHeight(i);
+	}
+	cmdbuffer->copyBufferToImage(stagingBuffer->buffer, mImage.Image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, levels, regions.Data());
+
+	VkImageTransition()
+		.AddImage(&mImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false, 0, levels)
+		.Execute(cmdbuffer);
+	SetAllocatedSize(totalSize);
+
+	fb->GetCommands()->TransferDeleteList->Add(std::move(stagingBuffer));
+	if (fb->GetCommands()->TransferDeleteList->TotalSize > 64 * 1024 * 1024)
+		fb->GetCommands()->WaitForCommands(false, true);
+}
+
 int VkHardwareTexture::GetMipLevels(int w, int h)
 {
 	int levels = 1;
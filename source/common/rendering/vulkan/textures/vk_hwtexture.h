@@ -15,6 +15,7 @@
 #include <list>
 
 struct FMaterialState;
+struct FCompressedTexture;
 class VulkanDescriptorSet;
 class VulkanImage;
 class VulkanImageView;
@@ -49,6 +50,7 @@ private:
 	void CreateImage(FTexture *tex, int translation, int flags);
 
 	void CreateTexture(int w, int h, int pixelsize, VkFormat format, const void *pixels, bool mipmap);
+	void CreateCompressedTexture(const FCompressedTexture &tex);
 	static int GetMipLevels(int w, int h);
 
 	VkTextureImage mImage;
@@ -37,6 +37,8 @@
 #include "m_argv.h"
 #include "c_cvars.h"
 #include "jit.h"
+#include "stats.h"
+#include "vmcodecache.h"
 
 CVAR(Bool, strictdecorate, false, CVAR_GLOBALCONFIG | CVAR_ARCHIVE)
 
@@ -142,6 +144,7 @@ void VMFunctionBuilder::MakeFunction(VMScriptFunction *func)
 	func->NumRegS = Registers[REGT_STRING].MostUsed;
 	func->MaxParam = MaxParam;
 	func->StackSize = VMFrame::FrameSize(func->NumRegD, func->NumRegF, func->NumRegS, func->NumRegA, func->MaxParam, func->ExtraSpace);
+	VMInitCallSites(func);
 
 	// Technically, there's no reason why we can't end the function with
 	// entries on the parameter stack, but it means the caller probably
@@ -813,18 +816,62 @@ VMFunction *FFunctionBuildList::AddFunction(PNamespace *gnspc, const VersionInfo
 }
 
 
+//==========================================================================
+//
+// NumArgs for the VMFunction must be the amount of stack elements, which can differ from the amount of logical function arguments if vectors are in the list.
+// For the VM a vector is 2 or 3 args, depending on size.
+//
+//==========================================================================
+
+static int CountStackArgs(PFunction::Variant &funcVariant)
+{
+	int numargs = 0;
+	for (unsigned int i = 0; i < funcVariant.Proto->ArgumentTypes.Size(); i++)
+	{
+		auto argType = funcVariant.Proto->ArgumentTypes[i];
+		auto argFlags = funcVariant.ArgFlags[i];
+		if (argFlags & VARF_Out)
+		{
+			auto argPointer = NewPointer(argType);
+			numargs += argPointer->GetRegCount();
+		}
+		else
+		{
+			numargs += argType->GetRegCount();
+		}
+	}
+	return numargs;
+}
+
 void FFunctionBuildList::Build()
 {
 	VMDisassemblyDumper disasmdump(VMDisassemblyDumper::Overwrite);
+	cycle_t timer;
 
-	for (auto &item : mItems)
+	timer.Reset(); timer.Clock();
+	ScriptCodeCache.BeginBuild(mItems.Size());
+
+	for (unsigned index = 0; index < mItems.Size(); index++)
 	{
+		auto &item = mItems[index];
 		// [Player701] Do not emit code for abstract functions
 		bool isAbstract = item.Func->Variants[0].Implementation->VarFlags & VARF_Abstract;
 		if (isAbstract) continue;
 
 		assert(item.Code != NULL);
 
+		// Named functions already have their prototype so if the code was cached, resolving and emitting can be skipped.
+		if (item.Func->SymbolName != NAME_None && ScriptCodeCache.Restore(index, item.PrintableName, item.Function))
+		{
+			VMScriptFunction *sfunc = item.Function;
+			sfunc->SourceFileName = item.Code->ScriptPosition.FileName.GetChars();
+			sfunc->NumArgs = CountStackArgs(item.Func->Variants[0]);
+			disasmdump.Write(sfunc, item.PrintableName);
+			delete item.Code;
+			disasmdump.Flush();
+			continue;
+		}
+
 		// We don't know the return type in advance for anonymous functions.
 		FCompileContext ctx(item.CurGlobals, item.Func, item.Func->SymbolName == NAME_None ? nullptr : item.Func->Variants[0].Proto, item.FromDecorate, item.StateIndex, item.StateCount, item.Lump, item.Version);
 
@@ -887,28 +934,12 @@ void FFunctionBuildList::Build()
 				item.Code->Emit(&buildit);
 				buildit.EndStatement();
 				buildit.MakeFunction(sfunc);
-				sfunc->NumArgs = 0;
-				// NumArgs for the VMFunction must be the amount of stack elements, which can differ from the amount of logical function arguments if vectors are in the list.
-				// For the VM a vector is 2 or 3 args, depending on size.
-				auto funcVariant = item.Func->Variants[0];
-				for (unsigned int i = 0; i < funcVariant.Proto->ArgumentTypes.Size(); i++)
-				{
-					auto argType = funcVariant.Proto->ArgumentTypes[i];
-					auto argFlags = funcVariant.ArgFlags[i];
-					if (argFlags & VARF_Out)
-					{
-						auto argPointer = NewPointer(argType);
-						sfunc->NumArgs += argPointer->GetRegCount();
-					}
-					else
-					{
-						sfunc->NumArgs += argType->GetRegCount();
-					}
-				}
+				sfunc->NumArgs = CountStackArgs(item.Func->Variants[0]);
 
 				disasmdump.Write(sfunc, item.PrintableName);
 
 				sfunc->Unsafe = ctx.Unsafe;
+				if (item.Func->SymbolName != NAME_None) ScriptCodeCache.Store(index, item.PrintableName, sfunc);
 			}
 			catch (CRecoverableError &err)
 			{
@@ -921,6 +952,8 @@ void FFunctionBuildList::Build()
 	}
 	VMFunction::CreateRegUseInfo();
 	FScriptPosition::StrictErrors = strictdecorate;
+	timer.Unclock();
+	ScriptCodeCache.EndBuild(FScriptPosition::ErrorCounter == 0, timer.TimeMS());
 
 	if (FScriptPosition::ErrorCounter == 0 && Args->CheckParm("-dumpjit")) DumpJit();
 	mItems.Clear();
@@ -1089,7 +1122,10 @@ ExpEmit FunctionCallEmitter::EmitCall(VMFunctionBuilder *build, TArray<ExpEmit>
 	{
 		ExpEmit funcreg(build, REGT_POINTER);
 
-		build->Emit(OP_VTBL, funcreg.RegNum, virtualselfreg, target->VirtualIndex);
+		// The inline cache's constant index must fit into the C operand. If it doesn't, use the plain vtable lookup.
+		unsigned site = build->GetConstantAddress(FVirtualCallSite::Create(target->VirtualIndex));
+		if (site <= 255) build->Emit(OP_VTBL_K, funcreg.RegNum, virtualselfreg, site);
+		else build->Emit(OP_VTBL, funcreg.RegNum, virtualselfreg, target->VirtualIndex);
 		build->Emit(OP_CALL, funcreg.RegNum, paramcount, vm_jit? target->Proto->ReturnTypes.Size() : returns.Size());
 	}
 
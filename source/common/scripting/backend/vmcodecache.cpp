@@ -0,0 +1,481 @@
+/*
+** vmcodecache.cpp
+** Persistent cache for the output of the script code generator
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The cached code is position independent except for the address
+** constants. Those are stored by name, which limits the cache to functions
+** that only reference classes, other functions and virtual call sites.
+** Everything else, as well as any function that needs constructed locals
+** on the extra stack, still goes through the code generator on every start.
+**
+*/
+
+#include "vmcodecache.h"
+#include "vmintern.h"
+#include "dobject.h"
+#include "filesystem.h"
+#include "files.h"
+#include "cmdlib.h"
+#include "c_cvars.h"
+#include "i_specialpaths.h"
+#include "engineerrors.h"
+#include "printf.h"
+#include "version.h"
+#include "s_soundinternal.h"
+#include <memory>
+
+CVAR(Bool, vm_codecache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+FScriptCodeCache ScriptCodeCache;
+
+static const char CodeCacheMagic[4] = { 'Z', 'S', 'C', '2' };
+
+//==========================================================================
+//
+// Bounds checked access to the loaded cache file.
+//
+//==========================================================================
+
+struct FCodeCacheReader
+{
+	const uint8_t *Pos;
+	const uint8_t *End;
+
+	void Read(void *dest, size_t len)
+	{
+		if (len > size_t(End - Pos)) throw CRecoverableError("Truncated script code cache");
+		memcpy(dest, Pos, len);
+		Pos += len;
+	}
+
+	uint32_t ReadUInt32()
+	{
+		uint32_t v;
+		Read(&v, 4);
+		return v;
+	}
+
+	FString ReadString()
+	{
+		uint32_t len = ReadUInt32();
+		if (len > size_t(End - Pos)) throw CRecoverableError("Truncated script code cache");
+		FString s((const char *)Pos, len);
+		Pos += len;
+		return s;
+	}
+};
+
+static void WriteData(TArray<uint8_t> &out, const void *data, size_t len)
+{
+	auto pos = out.Reserve((unsigned)len);
+	if (len > 0) memcpy(&out[pos], data, len);
+}
+
+static void WriteUInt32(TArray<uint8_t> &out, uint32_t v)
+{
+	WriteData(out, &v, 4);
+}
+
+static void WriteString(TArray<uint8_t> &out, const FString &s)
+{
+	WriteUInt32(out, (uint32_t)s.Len());
+	WriteData(out, s.GetChars(), s.Len());
+}
+
+static FString CodeCacheFileName(bool create)
+{
+	FString path = M_GetCachePath(create);
+	if (create) CreatePath(path);
+	path << "/zscriptcode.zsc";
+	return path;
+}
+
+//==========================================================================
+//
+// Feeds a script lump into the key. Must be called for every lump the
+// parser reads, in the order they are read.
+//
+//==========================================================================
+
+void FScriptCodeCache::AddSource(int lump)
+{
+	auto data = fileSystem.ReadFile(lump);
+	auto &text = data.GetString();
+	uint32_t len = (uint32_t)text.Len();
+	SourceHash.Update((const uint8_t *)&len, 4);
+	SourceHash.Update((const uint8_t *)text.GetChars(), len);
+}
+
+//==========================================================================
+//
+// The engine is part of the key because the field layouts and native
+// functions the code refers to may change with any build.
+//
+// Name and sound constants end up in the code as plain indices, so the
+// name table and the sound table as they are before code generation are
+// part of the key as well. The names the code generator creates itself
+// are stored in the file and get recreated in the same order on load.
+//
+//==========================================================================
+
+static void HashString(MD5Context &md5, const char *str)
+{
+	uint32_t len = (uint32_t)strlen(str);
+	md5.Update((const uint8_t *)&len, 4);
+	md5.Update((const uint8_t *)str, len);
+}
+
+void FScriptCodeCache::CreateKey()
+{
+	MD5Context md5 = SourceHash;
+	uint32_t build[] = { (uint32_t)sizeof(void *), (uint32_t)sizeof(VMOP), (uint32_t)NUM_OPS };
+	HashString(md5, GetVersionString());
+	HashString(md5, GetGitHash());
+	md5.Update((const uint8_t *)build, sizeof(build));
+
+	FirstName = FName::GetNumNames();
+	for (int i = 0; i < FirstName; i++)
+	{
+		HashString(md5, FName(ENamedName(i)).GetChars());
+	}
+	unsigned numsounds = soundEngine != nullptr ? soundEngine->GetNumSounds() : 0;
+	md5.Update((const uint8_t *)&numsounds, 4);
+	for (unsigned i = 0; i < numsounds; i++)
+	{
+		HashString(md5, soundEngine->GetSfx(FSoundID::fromInt(i))->name.GetChars());
+	}
+	md5.Final(Key);
+}
+
+//==========================================================================
+//
+// Called before the code generator starts. At this point all functions
+// that can be referenced exist, so the name tables can be set up.
+//
+//==========================================================================
+
+void FScriptCodeCache::BeginBuild(unsigned numfunctions)
+{
+	Enabled = vm_codecache;
+	NumRestored = NumStored = NumCompiled = 0;
+	if (!Enabled) return;
+
+	// Names that are not unique cannot be used to identify a function.
+	for (auto cls : PClass::AllClasses)
+	{
+		NamedPointers.Insert(FString("C") + cls->TypeName.GetChars(), cls);
+	}
+	for (auto func : VMFunction::AllFunctions)
+	{
+		FString name = FString("F") + func->PrintableName;
+		auto check = NamedPointers.CheckKey(name);
+		if (check == nullptr) NamedPointers.Insert(name, func);
+		else if (*check != func) *check = nullptr;
+	}
+	TMap<FString, void *>::Iterator it(NamedPointers);
+	TMap<FString, void *>::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		if (pair->Value != nullptr) PointerNames.Insert(pair->Value, pair->Key);
+	}
+
+	CreateKey();
+	Load(numfunctions);
+}
+
+//==========================================================================
+//
+// Reads the whole file in one go. Records are only decoded when the
+// function they belong to is being built.
+//
+//==========================================================================
+
+void FScriptCodeCache::Load(unsigned numfunctions)
+{
+	Records.Resize(numfunctions);
+	for (auto &r : Records) r = -1;
+	CachedBuildTime = 0;
+
+	FileReader fr;
+	if (!fr.OpenFile(CodeCacheFileName(false))) return;
+	Input = fr.Read();
+
+	try
+	{
+		FCodeCacheReader rd = { Input.Data(), Input.Data() + Input.Size() };
+		char magic[4];
+		uint8_t filekey[16];
+		rd.Read(magic, 4);
+		rd.Read(filekey, 16);
+		if (memcmp(magic, CodeCacheMagic, 4) || memcmp(filekey, Key, 16))
+		{
+			Input.Reset();
+			return;
+		}
+		rd.Read(&CachedBuildTime, sizeof(double));
+
+		// Recreate the names the cached code refers to at the indices it was compiled with.
+		uint32_t numnames = rd.ReadUInt32();
+		for (uint32_t i = 0; i < numnames; i++)
+		{
+			FName name(rd.ReadString());
+			if (name.GetIndex() != FirstName + int(i)) throw CRecoverableError("Script code cache name mismatch");
+		}
+		uint32_t count = rd.ReadUInt32();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t index = rd.ReadUInt32();
+			uint32_t size = rd.ReadUInt32();
+			if (index >= numfunctions || size > size_t(rd.End - rd.Pos)) throw CRecoverableError("Bad script code cache record");
+			Records[index] = int(rd.Pos - Input.Data());
+			rd.Pos += size;
+		}
+	}
+	catch (CRecoverableError &)
+	{
+		for (auto &r : Records) r = -1;
+		Input.Reset();
+		CachedBuildTime = 0;
+	}
+}
+
+//==========================================================================
+//
+// Fills in the function from its cache record. The function is left
+// untouched if the record cannot be used.
+//
+//==========================================================================
+
+bool FScriptCodeCache::Restore(unsigned index, const FString &name, VMScriptFunction *func)
+{
+	if (!Enabled || index >= Records.Size() || Records[index] < 0) return false;
+
+	const uint8_t *start = Input.Data() + Records[index];
+	uint32_t size;
+	memcpy(&size, start - 4, 4);
+	FCodeCacheReader rd = { start, start + size };
+
+	TArray<FString> strings;
+	TArray<void *> pointers;
+	TArray<std::pair<unsigned, unsigned>> sites;
+	int extraspace;
+	uint8_t regs[4], isunsafe;
+	uint16_t maxparam;
+	uint32_t counts[6];
+	const uint8_t *data;
+
+	try
+	{
+		if (rd.ReadString().Compare(name) != 0) return false;
+		rd.Read(&extraspace, sizeof(extraspace));
+		rd.Read(regs, 4);
+		rd.Read(&maxparam, 2);
+		rd.Read(&isunsafe, 1);
+		rd.Read(counts, sizeof(counts));
+		if (counts[0] == 0) return false;
+		for (int i = 2; i < 6; i++) if (counts[i] > 65535) return false;
+
+		data = rd.Pos;
+		size_t datasize = counts[0] * sizeof(VMOP) + counts[1] * sizeof(FStatementInfo) + counts[2] * sizeof(int) + counts[3] * sizeof(double);
+		if (datasize > size_t(rd.End - rd.Pos)) return false;
+		rd.Pos += datasize;
+
+		for (uint32_t i = 0; i < counts[4]; i++)
+		{
+			strings.Push(rd.ReadString());
+		}
+		for (uint32_t i = 0; i < counts[5]; i++)
+		{
+			FString ptrname = rd.ReadString();
+			if (ptrname.IsEmpty())
+			{
+				pointers.Push(nullptr);
+				continue;
+			}
+			if (ptrname[0] == 'V')
+			{
+				// Virtual call sites are created anew and only need their vtable index.
+				pointers.Push(nullptr);
+				sites.Push({ i, (unsigned)strtoul(ptrname.GetChars() + 1, nullptr, 10) });
+				continue;
+			}
+			auto check = NamedPointers.CheckKey(ptrname);
+			if (check == nullptr || *check == nullptr) return false;
+			pointers.Push(*check);
+		}
+	}
+	catch (CRecoverableError &)
+	{
+		return false;
+	}
+
+	func->ExtraSpace = extraspace;
+	func->Alloc(counts[0], counts[2], counts[3], counts[4], counts[5], counts[1]);
+	memcpy(func->Code, data, counts[0] * sizeof(VMOP));
+	data += counts[0] * sizeof(VMOP);
+	if (counts[1] > 0) memcpy(func->LineInfo, data, counts[1] * sizeof(FStatementInfo));
+	data += counts[1] * sizeof(FStatementInfo);
+	if (counts[2] > 0) memcpy(func->KonstD, data, counts[2] * sizeof(int));
+	data += counts[2] * sizeof(int);
+	if (counts[3] > 0) memcpy(func->KonstF, data, counts[3] * sizeof(double));
+	for (uint32_t i = 0; i < counts[4]; i++) func->KonstS[i] = strings[i];
+	for (uint32_t i = 0; i < counts[5]; i++) func->KonstA[i].v = pointers[i];
+	for (auto &site : sites) func->KonstA[site.first].v = FVirtualCallSite::Create(site.second);
+
+	func->NumRegD = regs[0];
+	func->NumRegF = regs[1];
+	func->NumRegS = regs[2];
+	func->NumRegA = regs[3];
+	func->MaxParam = maxparam;
+	func->Unsafe = !!isunsafe;
+	func->StackSize = VMFrame::FrameSize(func->NumRegD, func->NumRegF, func->NumRegS, func->NumRegA, func->MaxParam, func->ExtraSpace);
+	VMInitCallSites(func);
+
+	// Carry the record over to the next version of the file.
+	WriteUInt32(Output, index);
+	WriteUInt32(Output, size);
+	WriteData(Output, start, size);
+	NumRestored++;
+	NumStored++;
+	return true;
+}
+
+//==========================================================================
+//
+// Records a function the code generator just created.
+//
+//==========================================================================
+
+void FScriptCodeCache::Store(unsigned index, const FString &name, VMScriptFunction *func)
+{
+	if (!Enabled) return;
+	NumCompiled++;
+	if (func->SpecialInits.Size() > 0 || func->CodeSize == 0) return;
+
+	TArray<FString> ptrnames(func->NumKonstA, true);
+	for (int i = 0; i < func->CodeSize; i++)
+	{
+		if (func->Code[i].op == OP_VTBL_K)
+		{
+			auto site = static_cast<FVirtualCallSite*>(func->KonstA[func->Code[i].c].v);
+			ptrnames[func->Code[i].c].Format("V%u", site->VirtualIndex);
+		}
+	}
+	for (unsigned i = 0; i < func->NumKonstA; i++)
+	{
+		const void *ptr = func->KonstA[i].v;
+		if (ptr == nullptr || ptrnames[i].IsNotEmpty()) continue;
+		auto check = PointerNames.CheckKey(ptr);
+		if (check == nullptr) return;
+		ptrnames[i] = *check;
+	}
+
+	TArray<uint8_t> rec;
+	WriteString(rec, name);
+	WriteData(rec, &func->ExtraSpace, sizeof(func->ExtraSpace));
+	uint8_t regs[4] = { func->NumRegD, func->NumRegF, func->NumRegS, func->NumRegA };
+	WriteData(rec, regs, 4);
+	uint16_t maxparam = func->MaxParam;
+	WriteData(rec, &maxparam, 2);
+	uint8_t isunsafe = func->Unsafe;
+	WriteData(rec, &isunsafe, 1);
+	uint32_t counts[6] = { (uint32_t)func->CodeSize, func->LineInfoCount, func->NumKonstD, func->NumKonstF, func->NumKonstS, func->NumKonstA };
+	WriteData(rec, counts, sizeof(counts));
+	WriteData(rec, func->Code, counts[0] * sizeof(VMOP));
+	WriteData(rec, func->LineInfo, counts[1] * sizeof(FStatementInfo));
+	WriteData(rec, func->KonstD, counts[2] * sizeof(int));
+	WriteData(rec, func->KonstF, counts[3] * sizeof(double));
+	for (uint32_t i = 0; i < counts[4]; i++) WriteString(rec, func->KonstS[i]);
+	for (auto &ptrname : ptrnames) WriteString(rec, ptrname);
+
+	WriteUInt32(Output, index);
+	WriteUInt32(Output, rec.Size());
+	WriteData(Output, rec.Data(), rec.Size());
+	NumStored++;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void FScriptCodeCache::Save(double buildms)
+{
+	TArray<uint8_t> names;
+	uint32_t numnames = FName::GetNumNames() - FirstName;
+	WriteUInt32(names, numnames);
+	for (uint32_t i = 0; i < numnames; i++)
+	{
+		WriteString(names, FName(ENamedName(FirstName + i)).GetChars());
+	}
+
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(CodeCacheFileName(true)));
+	if (fw)
+	{
+		fw->Write(CodeCacheMagic, 4);
+		fw->Write(Key, 16);
+		fw->Write(&buildms, sizeof(double));
+		fw->Write(names.Data(), names.Size());
+		fw->Write(&NumStored, sizeof(uint32_t));
+		fw->Write(Output.Data(), Output.Size());
+	}
+}
+
+//==========================================================================
+//
+// Only rewrites the file if something had to be compiled. Once the
+// compiler is done the name tables and file contents are no longer needed.
+//
+//==========================================================================
+
+void FScriptCodeCache::EndBuild(bool success, double ms)
+{
+	if (Enabled)
+	{
+		if (NumRestored > 0 && !batchrun)
+		{
+			Printf("Restored %u of %u script functions from the code cache, code generation took %.2f ms instead of %.2f ms\n",
+				NumRestored, NumRestored + NumCompiled, ms, CachedBuildTime);
+		}
+		if (success && NumCompiled > 0)
+		{
+			// The build time of a full compile is kept as the reference for later runs.
+			Save(NumRestored > 0 ? CachedBuildTime : ms);
+		}
+	}
+	Input.Reset();
+	Records.Reset();
+	Output.Reset();
+	PointerNames.Clear();
+	NamedPointers.Clear();
+	SourceHash.Init();
+}
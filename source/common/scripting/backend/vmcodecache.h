@@ -0,0 +1,48 @@
+#pragma once
+
+// Cache for the code the script code generator emits.
+//
+// The frontend still has to run on every start because it creates all the
+// types and class layouts, but resolving and emitting the function bodies
+// can be skipped for all functions whose output can be restored without
+// looking at the expression tree. This is keyed on the contents of all
+// script lumps that got parsed, on the engine build and on the name and
+// sound tables the code generator folds into constants, so any change to
+// those invalidates the entire cache.
+
+#include "tarray.h"
+#include "zstring.h"
+#include "md5.h"
+
+class VMScriptFunction;
+
+class FScriptCodeCache
+{
+public:
+	void AddSource(int lump);
+	void BeginBuild(unsigned numfunctions);
+	bool Restore(unsigned index, const FString &name, VMScriptFunction *func);
+	void Store(unsigned index, const FString &name, VMScriptFunction *func);
+	void EndBuild(bool success, double ms);
+
+private:
+	void CreateKey();
+	void Load(unsigned numfunctions);
+	void Save(double buildms);
+
+	MD5Context SourceHash;
+	uint8_t Key[16];
+	int FirstName = 0;
+	TArray<uint8_t> Input;
+	TArray<int> Records;
+	TArray<uint8_t> Output;
+	TMap<const void *, FString> PointerNames;
+	TMap<FString, void *> NamedPointers;
+	double CachedBuildTime = 0;
+	unsigned NumRestored = 0;
+	unsigned NumStored = 0;
+	unsigned NumCompiled = 0;
+	bool Enabled = false;
+};
+
+extern FScriptCodeCache ScriptCodeCache;
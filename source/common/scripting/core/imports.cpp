@@ -200,6 +200,7 @@ void InitImports()
 			*(afunc->VMPointer) = new VMNativeFunction(afunc->Function, afunc->FuncName);
 			(*(afunc->VMPointer))->PrintableName.Format("%s.%s [Native]", afunc->ClassName+1, afunc->FuncName);
 			(*(afunc->VMPointer))->DirectNativeCall = afunc->DirectNative;
+			(*(afunc->VMPointer))->ThreadSafety = afunc->ThreadSafe ? TS_Safe : TS_Unsafe;
 			AFTable.Push(*afunc);
 		});
 		AFTable.ShrinkToFit();
@@ -40,6 +40,7 @@
 #include "version.h"
 #include "zcc_parser.h"
 #include "zcc_compile.h"
+#include "vmcodecache.h"
 
 
 TArray<FString> Includes;
@@ -299,6 +300,7 @@ static void ParseSingleFile(FScanner *pSC, const char *filename, int lump, void
 			if (lump >= 0)
 			{
 				lsc.OpenLumpNum(lump);
+				ScriptCodeCache.AddSource(lump);
 			}
 			else
 			{
@@ -306,7 +308,11 @@ static void ParseSingleFile(FScanner *pSC, const char *filename, int lump, void
 				return;
 			}
 		}
-		else lsc.OpenLumpNum(lump);
+		else
+		{
+			lsc.OpenLumpNum(lump);
+			ScriptCodeCache.AddSource(lump);
+		}
 
 		pSC = &lsc;
 	}
@@ -430,6 +436,7 @@ PNamespace *ParseOneScript(const int baselump, ZCCParseState &state)
 #endif
 
 	sc.OpenLumpNum(lumpnum);
+	ScriptCodeCache.AddSource(lumpnum);
 	sc.SetParseVersion({ 2, 4 });	// To get 'version' we need parse version 2.4 for the initial test
 	auto saved = sc.SavePos();
 
@@ -1216,7 +1216,7 @@ void QuatFromAngles(double yaw, double pitch, double roll, DQuaternion* pquat)
 	*pquat = DQuaternion::FromAngles(DAngle::fromDeg(yaw), DAngle::fromDeg(pitch), DAngle::fromDeg(roll));
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(_QuatStruct, FromAngles, QuatFromAngles)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(_QuatStruct, FromAngles, QuatFromAngles)
 {
 	PARAM_PROLOGUE;
 	PARAM_FLOAT(yaw);
@@ -1235,7 +1235,7 @@ void QuatAxisAngle(double x, double y, double z, double angleDeg, DQuaternion* p
 	*pquat = DQuaternion::AxisAngle(axis, angle);
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(_QuatStruct, AxisAngle, QuatAxisAngle)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(_QuatStruct, AxisAngle, QuatAxisAngle)
 {
 	PARAM_PROLOGUE;
 	PARAM_FLOAT(x);
@@ -125,7 +125,7 @@ asmjit::CCFunc *JitCompiler::Codegen()
 			LineInfo.Push(info);
 		}
 
-		if (op != OP_PARAM && op != OP_PARAMI && op != OP_VTBL)
+		if (op != OP_PARAM && op != OP_PARAMI && op != OP_VTBL && op != OP_VTBL_K)
 		{
 			FString lineinfo;
 			lineinfo.Format("; line %d: %02x%02x%02x%02x %s", curLine, pc->op, pc->a, pc->b, pc->c, OpNames[op]);
@@ -430,13 +430,10 @@ void JitCompiler::EmitPopFrame()
 
 void JitCompiler::IncrementVMCalls()
 {
-	// VMCalls[0]++
+	// VMCalls[0]++, atomically because script code may also run on worker threads.
 	auto vmcallsptr = newTempIntPtr();
-	auto vmcalls = newTempInt32();
 	cc.mov(vmcallsptr, asmjit::imm_ptr(VMCalls));
-	cc.mov(vmcalls, asmjit::x86::dword_ptr(vmcallsptr));
-	cc.add(vmcalls, (int)1);
-	cc.mov(asmjit::x86::dword_ptr(vmcallsptr), vmcalls);
+	cc.lock().add(asmjit::x86::dword_ptr(vmcallsptr), (int)1);
 }
 
 void JitCompiler::CreateRegisters()
@@ -25,6 +25,16 @@ void JitCompiler::EmitVTBL()
 	// This instruction is handled in the CALL/CALL_K instruction following it
 }
 
+void JitCompiler::EmitVTBL_K()
+{
+	// This instruction is handled in the CALL/CALL_K instruction following it
+}
+
+static VMFunction *VirtualCallSiteMiss(FVirtualCallSite *site, PClass *cls)
+{
+	return site->Miss(cls);
+}
+
 void JitCompiler::EmitVtbl(const VMOP *op)
 {
 	int a = op->a;
@@ -35,11 +45,62 @@ void JitCompiler::EmitVtbl(const VMOP *op)
 	cc.test(regA[b], regA[b]);
 	cc.jz(label);
 
+	if (op->op == OP_VTBL_K)
+	{
+		EmitCachedVtbl(op);
+		return;
+	}
+
 	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[b], myoffsetof(DObject, Class)));
 	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[a], myoffsetof(PClass, Virtuals) + myoffsetof(FArray, Array)));
 	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[a], c * (int)sizeof(void*)));
 }
 
+// The site is known at compile time, so the guards compare directly against its class slots.
+// Only a miss has to leave the generated code.
+void JitCompiler::EmitCachedVtbl(const VMOP *op)
+{
+	using namespace asmjit;
+
+	int a = op->a;
+	int b = op->b;
+	auto site = static_cast<FVirtualCallSite*>(konsta[op->c].v);
+
+	auto cls = newTempIntPtr();
+	auto siteptr = newTempIntPtr();
+	cc.mov(cls, x86::qword_ptr(regA[b], myoffsetof(DObject, Class)));
+	cc.mov(siteptr, imm_ptr(site));
+
+	auto second = cc.newLabel();
+	auto hit = cc.newLabel();
+	auto miss = cc.newLabel();
+	auto done = cc.newLabel();
+
+	cc.cmp(cls, x86::qword_ptr(siteptr, myoffsetof(FVirtualCallSite, Classes)));
+	cc.jne(second);
+	cc.mov(regA[a], x86::qword_ptr(siteptr, myoffsetof(FVirtualCallSite, Targets)));
+	cc.jmp(hit);
+
+	cc.bind(second);
+	cc.cmp(cls, x86::qword_ptr(siteptr, myoffsetof(FVirtualCallSite, Classes) + (int)sizeof(PClass*)));
+	cc.jne(miss);
+	cc.mov(regA[a], x86::qword_ptr(siteptr, myoffsetof(FVirtualCallSite, Targets) + (int)sizeof(VMFunction*)));
+
+	cc.bind(hit);
+	cc.add(x86::dword_ptr(siteptr, myoffsetof(FVirtualCallSite, Hits)), 1);
+	cc.jmp(done);
+
+	cc.bind(miss);
+	auto result = newResultIntPtr();
+	auto call = CreateCall<VMFunction*, FVirtualCallSite*, PClass*>(VirtualCallSiteMiss);
+	call->setRet(0, result);
+	call->setArg(0, siteptr);
+	call->setArg(1, cls);
+	cc.mov(regA[a], result);
+
+	cc.bind(done);
+}
+
 void JitCompiler::EmitCALL()
 {
 	EmitVMCall(regA[A], nullptr);
@@ -78,7 +139,7 @@ void JitCompiler::EmitVMCall(asmjit::X86Gp vmfunc, VMFunction *target)
 	if (numparams != B)
 		I_Error("OP_CALL parameter count does not match the number of preceding OP_PARAM instructions");
 
-	if (pc > sfunc->Code && (pc - 1)->op == OP_VTBL)
+	if (pc > sfunc->Code && ((pc - 1)->op == OP_VTBL || (pc - 1)->op == OP_VTBL_K))
 		EmitVtbl(pc - 1);
 
 	FillReturns(pc + 1, C);
@@ -331,7 +392,7 @@ void JitCompiler::EmitNativeCall(VMNativeFunction *target)
 {
 	using namespace asmjit;
 
-	if (pc > sfunc->Code && (pc - 1)->op == OP_VTBL)
+	if (pc > sfunc->Code && ((pc - 1)->op == OP_VTBL || (pc - 1)->op == OP_VTBL_K))
 	{
 		I_Error("Native direct member function calls not implemented\n");
 	}
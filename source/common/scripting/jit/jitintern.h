@@ -10,11 +10,12 @@
 
 #include <asmjit/asmjit.h>
 #include <asmjit/x86.h>
+#include <atomic>
 #include <functional>
 #include <vector>
 
-extern cycle_t VMCycles[10];
-extern int VMCalls[10];
+extern thread_local cycle_t VMCycles[10];
+extern std::atomic<int> VMCalls[10];
 
 #define A				(pc[0].a)
 #define B				(pc[0].b)
@@ -63,6 +64,7 @@ private:
 	void EmitNativeCall(VMNativeFunction *target);
 	void EmitVMCall(asmjit::X86Gp ptr, VMFunction *target);
 	void EmitVtbl(const VMOP *op);
+	void EmitCachedVtbl(const VMOP *op);
 
 	int StoreCallParams();
 	void LoadInOuts();
@@ -56,6 +56,7 @@ extern FMemArena ClassDataAllocator;
 #define MAX_TRY_DEPTH	8	// Maximum number of nested TRYs in a single function
 
 void JitRelease();
+void VMReleaseCallSites();
 
 extern void (*VM_CastSpriteIDToString)(FString* a, unsigned int b);
 
@@ -440,10 +441,20 @@ struct VMValue
 	}
 };
 
+// Whether a function may be called from a worker thread. Natives declare this, for script functions it gets determined on demand by VMCheckThreadSafe.
+enum EThreadSafety : uint8_t
+{
+	TS_Unknown,
+	TS_Checking,
+	TS_Safe,
+	TS_Unsafe
+};
+
 class VMFunction
 {
 public:
 	bool Unsafe = false;
+	EThreadSafety ThreadSafety = TS_Unknown;
 	uint8_t ImplicitArgs = 0;	// either 0 for static, 1 for method or 3 for action
 	int VarFlags = 0; // [ZZ] this replaces 5+ bool fields
 	unsigned VirtualIndex = ~0u;
@@ -479,6 +490,7 @@ public:
 		AllFunctions.Clear();
 		// also release any JIT data
 		JitRelease();
+		VMReleaseCallSites();
 	}
 	static void CreateRegUseInfo()
 	{
@@ -525,6 +537,8 @@ private:
 };
 
 int VMCall(VMFunction *func, VMValue *params, int numparams, VMReturn *results, int numresults/*, VMException **trap = NULL*/);
+bool VMCheckThreadSafe(VMFunction *func);
+void VMReserveFrameStack(int size);
 int VMCallWithDefaults(VMFunction *func, TArray<VMValue> &params, VMReturn *results, int numresults/*, VMException **trap = NULL*/);
 
 inline int VMCallAction(VMFunction *func, VMValue *params, int numparams, VMReturn *results, int numresults/*, VMException **trap = NULL*/)
@@ -663,6 +677,7 @@ struct AFuncDesc
 	actionf_p Function;
 	VMNativeFunction **VMPointer;
 	DirectNativeDesc DirectNative;
+	bool ThreadSafe;
 };
 
 #if defined(_MSC_VER)
@@ -691,6 +706,15 @@ struct AFuncDesc
 	MSVC_ASEG AFuncDesc const *const cls##_##name##_HookPtr GCC_ASEG = &cls##_##name##_Hook; \
 	static int AF_##cls##_##name(VM_ARGS)
 
+// For natives which neither modify nor depend on any state that is shared between script calls, so that they can be called from worker threads.
+#define DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(cls, name, native) \
+	static int AF_##cls##_##name(VM_ARGS); \
+	VMNativeFunction *cls##_##name##_VMPtr; \
+	static const AFuncDesc cls##_##name##_Hook = { #cls, #name, AF_##cls##_##name, &cls##_##name##_VMPtr, native, true }; \
+	extern AFuncDesc const *const cls##_##name##_HookPtr; \
+	MSVC_ASEG AFuncDesc const *const cls##_##name##_HookPtr GCC_ASEG = &cls##_##name##_Hook; \
+	static int AF_##cls##_##name(VM_ARGS)
+
 #define DEFINE_ACTION_FUNCTION_NATIVE0(cls, name, native) \
 	static int AF_##cls##_##name(VM_ARGS); \
 	VMNativeFunction *cls##_##name##_VMPtr; \
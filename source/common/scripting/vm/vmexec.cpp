@@ -33,6 +33,7 @@
 
 #include <math.h>
 #include <assert.h>
+#include <atomic>
 #include "v_video.h"
 #include "s_soundinternal.h"
 #include "basics.h"
@@ -44,8 +45,8 @@
 #include "texturemanager.h"
 #include "palutil.h"
 
-extern cycle_t VMCycles[10];
-extern int VMCalls[10];
+extern thread_local cycle_t VMCycles[10];
+extern std::atomic<int> VMCalls[10];
 
 // THe sprite ID to string cast is game specific so let's do it with a callback to remove the dependency and allow easier reuse.
 void (*VM_CastSpriteIDToString)(FString* a, unsigned int b) = [](FString* a, unsigned int b) { a->Format("%d", b); };
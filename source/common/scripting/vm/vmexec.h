@@ -854,6 +854,18 @@ static int ExecScriptFunc(VMFrameStack *stack, VMReturn *ret, int numret)
 			reg.a[a] = p->Virtuals[C];
 		}
 		NEXTOP;
+	OP(VTBL_K):
+		ASSERTA(a); ASSERTA(B); ASSERTKA(C);
+		{
+			auto o = (DObject*)reg.a[B];
+			if (o == nullptr)
+			{
+				ThrowAbortException(X_READ_NIL, nullptr);
+				return 0;
+			}
+			reg.a[a] = static_cast<FVirtualCallSite*>(konsta[C].v)->Lookup(o->GetClass());
+		}
+		NEXTOP;
 	OP(SCOPE):
 		{
 			ASSERTA(a); ASSERTKA(C);
@@ -33,6 +33,8 @@
 */
 
 #include <new>
+#include <algorithm>
+#include <atomic>
 #include "dobject.h"
 #include "v_text.h"
 #include "stats.h"
@@ -43,6 +45,7 @@
 #include "jit.h"
 #include "c_cvars.h"
 #include "version.h"
+#include "tracing.h"
 
 #ifdef HAVE_VM_JIT
 #ifdef __DragonFly__
@@ -60,8 +63,8 @@ FString JitCaptureStackTrace(int framesToSkip, bool includeNativeFrames, int max
 void JitRelease() {}
 #endif
 
-cycle_t VMCycles[10];
-int VMCalls[10];
+thread_local cycle_t VMCycles[10];
+std::atomic<int> VMCalls[10];	// also incremented by script code running on worker threads
 
 #if 0
 IMPLEMENT_CLASS(VMException, false, false)
@@ -291,20 +294,33 @@ int VMScriptFunction::FirstScriptCall(VMFunction *func, VMValue *params, int num
 	{
 		ThrowAbortException(X_OTHER, "attempt to call abstract function %s.", func->PrintableName.GetChars());
 	}
+	static_cast<VMScriptFunction*>(func)->SelectScriptCall();
+	return func->ScriptCall(func, params, numparams, ret, numret);
+}
+
+//===========================================================================
+//
+// Compiles the function if the JIT is on. Normally this happens on the
+// first call, but functions that are about to be called from worker threads
+// must be prepared in advance.
+//
+//===========================================================================
+
+void VMScriptFunction::SelectScriptCall()
+{
+	if (ScriptCall != &VMScriptFunction::FirstScriptCall) return;
 #ifdef HAVE_VM_JIT
-	if (vm_jit && CanJit(static_cast<VMScriptFunction*>(func)))
+	if (vm_jit && CanJit(this))
 	{
-		func->ScriptCall = JitCompile(static_cast<VMScriptFunction*>(func));
-		if (!func->ScriptCall)
-			func->ScriptCall = VMExec;
+		ScriptCall = JitCompile(this);
+		if (!ScriptCall)
+			ScriptCall = VMExec;
 	}
 	else
 #endif // HAVE_VM_JIT
 	{
-		func->ScriptCall = VMExec;
+		ScriptCall = VMExec;
 	}
-
-	return func->ScriptCall(func, params, numparams, ret, numret);
 }
 
 int VMNativeFunction::NativeScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *returns, int numret)
@@ -445,7 +461,7 @@ VMFrame *VMFrameStack::Alloc(int size)
 		{
 			blocksize = BLOCK_SIZE;
 		}
-		for (blockp = &UnusedBlocks, block = *blockp; block != NULL; block = block->NextBlock)
+		for (blockp = &UnusedBlocks, block = *blockp; block != NULL; blockp = &block->NextBlock, block = *blockp)
 		{
 			if (block->BlockSize >= blocksize)
 			{
@@ -475,6 +491,37 @@ VMFrame *VMFrameStack::Alloc(int size)
 }
 
 
+//===========================================================================
+//
+// VMFrameStack :: Reserve
+//
+// Puts a block of at least the given size into the pool of unused blocks,
+// so that a thread can run scripts without allocating memory as long as
+// they stay within that size.
+//
+//===========================================================================
+
+void VMFrameStack::Reserve(int size)
+{
+	int blocksize = ((sizeof(BlockHeader) + 15) & ~15) + ((size + 15) & ~15);
+	for (auto block = UnusedBlocks; block != NULL; block = block->NextBlock)
+	{
+		if (block->BlockSize >= blocksize)
+		{
+			return;
+		}
+	}
+	auto block = (BlockHeader *)new VM_UBYTE[blocksize];
+	block->BlockSize = blocksize;
+	block->NextBlock = UnusedBlocks;
+	UnusedBlocks = block;
+}
+
+void VMReserveFrameStack(int size)
+{
+	GlobalVMStack.Reserve(size);
+}
+
 //===========================================================================
 //
 // VMFrameStack :: PopFrame
@@ -577,6 +624,7 @@ int VMCall(VMFunction *func, VMValue *params, int numparams, VMReturn *results,
 				VMCycles[0].Clock();
 
 				auto sfunc = static_cast<VMScriptFunction *>(func);
+				TRACE_ZONE(sfunc->PrintableName.GetChars());
 				int numret = sfunc->ScriptCall(sfunc, params, numparams, results, numresults);
 				VMCycles[0].Unclock();
 				return numret;
@@ -744,14 +792,236 @@ ADD_STAT(VM)
 		added += d.TimeMS();
 		peak = max<double>(peak, d.TimeMS());
 	}
-	for (auto d : VMCalls) addedc += d;
+	for (auto &d : VMCalls) addedc += d;
 	memmove(&VMCycles[1], &VMCycles[0], 9 * sizeof(cycle_t));
-	memmove(&VMCalls[1], &VMCalls[0], 9 * sizeof(int));
+	for (int i = 9; i > 0; i--) VMCalls[i] = VMCalls[i - 1].load();
 	VMCycles[0].Reset();
 	VMCalls[0] = 0;
 	return FStringf("VM time in last 10 tics: %f ms, %d calls, peak = %f ms", added, addedc, peak);
 }
 
+//-----------------------------------------------------------------------------
+//
+// Virtual call inline caches
+//
+//-----------------------------------------------------------------------------
+
+static TArray<FVirtualCallSite *> VirtualCallSites;
+
+FVirtualCallSite *FVirtualCallSite::Create(unsigned virtualindex)
+{
+	// Allocated in the arena so that the constant does not need to be maintained, just like the vararg type info.
+	auto site = (FVirtualCallSite*)ClassDataAllocator.Alloc(sizeof(FVirtualCallSite));
+	memset(site, 0, sizeof(FVirtualCallSite));
+	site->VirtualIndex = virtualindex;
+	site->PC = -1;
+	return site;
+}
+
+VMFunction *FVirtualCallSite::Miss(PClass *cls)
+{
+	if (cls->Virtuals.Size() <= 0) ThrowAbortException(X_OTHER, "Attempted to call an invalid virtual function in class %s", cls->TypeName.GetChars());
+	assert(VirtualIndex < cls->Virtuals.Size());
+	auto target = cls->Virtuals[VirtualIndex];
+	Misses++;
+	Classes[1] = Classes[0];
+	Targets[1] = Targets[0];
+	Classes[0] = cls;
+	Targets[0] = target;
+	return target;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Tells the call sites of a newly built function where they are.
+//
+//-----------------------------------------------------------------------------
+
+void VMInitCallSites(VMScriptFunction *func)
+{
+	for (int i = 0; i < func->CodeSize; i++)
+	{
+		if (func->Code[i].op == OP_VTBL_K)
+		{
+			auto site = static_cast<FVirtualCallSite*>(func->KonstA[func->Code[i].c].v);
+			site->Caller = func;
+			site->PC = i;
+			VirtualCallSites.Push(site);
+		}
+	}
+}
+
+void VMReleaseCallSites()
+{
+	VirtualCallSites.Reset();
+}
+
+//-----------------------------------------------------------------------------
+//
+// VMCheckThreadSafe
+//
+// Script code is safe to run on a worker thread if it only calls natives
+// declared thread-safe and script functions which themselves are safe, and
+// does not touch any of the VM's shared state. That rules out strings,
+// because FString's reference counting is not atomic, object pointer
+// stores, which go through the GC's write barrier, and calls whose target
+// is not known in advance, like virtual calls, which also update the
+// inline caches.
+//
+// The only memory the function may write to is what its pointer parameters
+// other than self point to, and only through the parameter itself, so stores
+// to globals, to self's fields or to anything reached through a pointer
+// field are rejected. The caller must ensure that every such parameter is
+// only used by one thread at a time. Script functions it calls may not
+// write to memory at all, since there is no telling what gets passed to them.
+//
+// Must be called on the main thread. All functions that pass are compiled
+// here so that their first call cannot happen on a worker thread.
+//
+//-----------------------------------------------------------------------------
+
+static bool IsStoreOp(int op)
+{
+	switch (op)
+	{
+	case OP_SB: case OP_SB_R:
+	case OP_SH: case OP_SH_R:
+	case OP_SW: case OP_SW_R:
+	case OP_SSP: case OP_SSP_R:
+	case OP_SDP: case OP_SDP_R:
+	case OP_SS: case OP_SS_R:
+	case OP_SP: case OP_SP_R:
+	case OP_SO: case OP_SO_R:
+	case OP_SV2: case OP_SV2_R:
+	case OP_SV3: case OP_SV3_R:
+	case OP_SV4: case OP_SV4_R:
+	case OP_SFV2: case OP_SFV2_R:
+	case OP_SFV3: case OP_SFV3_R:
+	case OP_SFV4: case OP_SFV4_R:
+	case OP_SBIT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool CheckThreadSafe(VMFunction *func, bool callee);
+
+static bool CheckScriptThreadSafe(VMScriptFunction *sfunc, bool callee)
+{
+	if (sfunc->Code == nullptr || sfunc->NumRegS != 0 || sfunc->NumKonstS != 0 || sfunc->SpecialInits.Size() != 0) return false;
+
+	// The pointer registers that may be stored to. Parameters get passed in the first registers of each type.
+	TArray<bool> writable(sfunc->NumRegA, true);
+	for (auto &w : writable) w = false;
+	if (!callee)
+	{
+		int rega = 0;
+		for (int i = 0; i < sfunc->NumArgs; i++)
+		{
+			if (sfunc->RegTypes[i] != REGT_POINTER) continue;
+			if (i >= sfunc->ImplicitArgs) writable[rega] = true;
+			rega++;
+		}
+		// Once the register gets reassigned it cannot be trusted anymore.
+		for (int i = 0; i < sfunc->CodeSize; i++)
+		{
+			auto &code = sfunc->Code[i];
+			if (code.op == OP_RESULT && (code.b & REGT_TYPE) == REGT_POINTER) writable[code.c] = false;
+			else if ((OpInfo[code.op].Mode & MODE_ATYPE) == MODE_AP && !IsStoreOp(code.op)) writable[code.a] = false;
+		}
+	}
+
+	for (int i = 0; i < sfunc->CodeSize; i++)
+	{
+		auto &code = sfunc->Code[i];
+		switch (code.op)
+		{
+		case OP_CALL:
+		case OP_VTBL:
+		case OP_VTBL_K:
+		case OP_SO:
+		case OP_SO_R:
+			return false;
+
+		case OP_CALL_K:
+			if (!CheckThreadSafe(static_cast<VMFunction *>(sfunc->KonstA[code.a].v), true)) return false;
+			break;
+
+		default:
+			if (IsStoreOp(code.op) && !writable[code.a]) return false;
+			break;
+		}
+	}
+	return true;
+}
+
+static bool CheckThreadSafe(VMFunction *func, bool callee)
+{
+	if (func == nullptr) return false;
+	if (func->VarFlags & (VARF_Native | VARF_Abstract))
+	{
+		// Natives are only ever safe if they were declared so.
+		if (func->ThreadSafety == TS_Unknown) func->ThreadSafety = TS_Unsafe;
+		return func->ThreadSafety == TS_Safe;
+	}
+
+	auto sfunc = static_cast<VMScriptFunction *>(func);
+	auto &state = callee ? sfunc->CalleeThreadSafety : sfunc->ThreadSafety;
+	if (state == TS_Safe) return true;
+	if (state != TS_Unknown) return false;	// TS_Checking means recursion, which is not worth supporting.
+
+	state = TS_Checking;
+	bool safe = CheckScriptThreadSafe(sfunc, callee);
+	if (safe) sfunc->SelectScriptCall();
+	state = safe ? TS_Safe : TS_Unsafe;
+	return safe;
+}
+
+bool VMCheckThreadSafe(VMFunction *func)
+{
+	return CheckThreadSafe(func, false);
+}
+
+//-----------------------------------------------------------------------------
+//
+// Lists the busiest virtual call sites with their cache statistics.
+//
+//-----------------------------------------------------------------------------
+
+CCMD(vmcallsites)
+{
+	if (argv.argc() > 1 && stricmp(argv[1], "reset") == 0)
+	{
+		for (auto site : VirtualCallSites) site->Hits = site->Misses = 0;
+		return;
+	}
+	int count = argv.argc() > 1 ? (int)strtol(argv[1], nullptr, 0) : 20;
+
+	TArray<FVirtualCallSite *> sorted = VirtualCallSites;
+	std::sort(sorted.begin(), sorted.end(), [](FVirtualCallSite *a, FVirtualCallSite *b)
+	{
+		return uint64_t(a->Hits) + a->Misses > uint64_t(b->Hits) + b->Misses;
+	});
+
+	uint64_t hits = 0, misses = 0;
+	for (auto site : sorted)
+	{
+		hits += site->Hits;
+		misses += site->Misses;
+	}
+	for (int i = 0; i < count && i < (int)sorted.Size(); i++)
+	{
+		auto site = sorted[i];
+		if (site->Hits + site->Misses == 0) break;
+		const char *kind = site->Misses <= 1 ? "monomorphic" : site->Misses <= 2 ? "polymorphic" : "megamorphic";
+		auto target = site->Targets[0] ? site->Targets[0]->PrintableName.GetChars() : "?";
+		Printf("%s, line %d: %s, %u hits, %u misses (%s)\n", site->Caller->PrintableName.GetChars(), site->Caller->PCToLine(site->Caller->Code + site->PC),
+			target, site->Hits, site->Misses, kind);
+	}
+	Printf("%u call sites, %llu hits, %llu misses\n", VirtualCallSites.Size(), (unsigned long long)hits, (unsigned long long)misses);
+}
+
 //-----------------------------------------------------------------------------
 //
 //
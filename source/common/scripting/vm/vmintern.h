@@ -355,6 +355,7 @@ public:
 	~VMFrameStack();
 	VMFrame *AllocFrame(VMScriptFunction *func);
 	VMFrame *PopFrame();
+	void Reserve(int size);
 	VMFrame *TopFrame()
 	{
 		assert(Blocks != NULL && Blocks->LastFrame != NULL);
@@ -473,12 +474,42 @@ public:
 	VM_UHALF MaxParam;		// Maximum number of parameters this function has on the stack at once
 	VM_UBYTE NumArgs;		// Number of arguments this function takes
 	TArray<FTypeAndOffset> SpecialInits;	// list of all contents on the extra stack which require construction and destruction
+	EThreadSafety CalleeThreadSafety = TS_Unknown;	// same as ThreadSafety, for calls from other thread-safe functions, which may not write to anything.
 
 	void InitExtra(void *addr);
 	void DestroyExtra(void *addr);
 	int AllocExtraStack(PType *type);
 	int PCToLine(const VMOP *pc);
 
+	void SelectScriptCall();
+
 private:
 	static int FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
 };
+
+// Inline cache for a single virtual call site. It remembers the targets for
+// the last two classes seen at the site, so that sites which only ever get
+// called with one or two classes are resolved with a pointer compare.
+struct FVirtualCallSite
+{
+	PClass *Classes[2];
+	VMFunction *Targets[2];
+	unsigned VirtualIndex;
+	unsigned Hits;
+	unsigned Misses;
+	VMScriptFunction *Caller;
+	int PC;
+
+	static FVirtualCallSite *Create(unsigned virtualindex);
+
+	VMFunction *Lookup(PClass *cls)
+	{
+		if (cls == Classes[0]) { Hits++; return Targets[0]; }
+		if (cls == Classes[1]) { Hits++; return Targets[1]; }
+		return Miss(cls);
+	}
+
+	VMFunction *Miss(PClass *cls);
+};
+
+void VMInitCallSites(VMScriptFunction *func);
@@ -121,6 +121,7 @@ xx(PARAMI,	parami,	I24,		NOP,	0, 0)		// push immediate, signed integer for funct
 xx(CALL,	call,	RPI8I8,		NOP,	0, 0)	// Call function pkA with parameter count B and expected result count C
 xx(CALL_K,	call,	KPI8I8,		CALL,	1, REGT_POINTER)
 xx(VTBL,	vtbl,	RPRPI8,		NOP,	0, 0)	// dereferences a virtual method table.
+xx(VTBL_K,	vtbl,	RPRPKP,		NOP,	0, 0)	// same, through the inline cache in pkC.
 xx(SCOPE,	scope,	RPI8,		NOP,	0, 0)		// Scope check at runtime.
 xx(RESULT,	result,	__BCP,		NOP,	0, 0)		// Result should go in register encoded in BC (in caller, after CALL)
 xx(RET,		ret,	I8BCP,		NOP,	0, 0)		// Copy value from register encoded in BC to return value A, possibly returning
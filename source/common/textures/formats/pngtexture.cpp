@@ -56,9 +56,12 @@ public:
 	FPNGTexture (FileReader &lump, int lumpnum, int width, int height, uint8_t bitdepth, uint8_t colortype, uint8_t interlace);
 
 	int CopyPixels(FBitmap *bmp, int conversion) override;
+	bool CanDecodeFromMemory() const override { return true; }
+	int CopyPixelsFromMemory(FBitmap *bmp, FileReader &data) override;
 	PalettedPixels CreatePalettedPixels(int conversion) override;
 
 protected:
+	int ReadPixels(FileReader *lump, FBitmap *bmp);
 	void ReadAlphaRemap(FileReader *lump, uint8_t *alpharemap);
 	void SetupPalette(FileReader &lump);
 
@@ -553,20 +556,40 @@ PalettedPixels FPNGTexture::CreatePalettedPixels(int conversion)
 //===========================================================================
 
 int FPNGTexture::CopyPixels(FBitmap *bmp, int conversion)
+{
+	FileReader lfr = fileSystem.OpenFileReader(SourceLump);
+	return ReadPixels(&lfr, bmp);
+}
+
+//===========================================================================
+//
+// FPNGTexture::CopyPixelsFromMemory
+//
+// This only touches the reader and the fields set up by the constructor,
+// so it can run on a worker thread.
+//
+//===========================================================================
+
+int FPNGTexture::CopyPixelsFromMemory(FBitmap *bmp, FileReader &data)
+{
+	return ReadPixels(&data, bmp);
+}
+
+//===========================================================================
+//
+// FPNGTexture::ReadPixels
+//
+//===========================================================================
+
+int FPNGTexture::ReadPixels(FileReader *lump, FBitmap *bmp)
 {
 	// Parse pre-IDAT chunks. I skip the CRCs. Is that bad?
 	PalEntry pe[256];
 	uint32_t len, id;
-	static char bpp[] = {1, 0, 3, 1, 2, 0, 4};
+	static const char bpp[] = {1, 0, 3, 1, 2, 0, 4};
 	int pixwidth = Width * bpp[ColorType];
 	int transpal = false;
 
-	FileReader *lump;
-	FileReader lfr;
-
-	lfr = fileSystem.OpenFileReader(SourceLump);
-	lump = &lfr;
-
 	lump->Seek(33, FileReader::SeekSet);
 	for(int i = 0; i < 256; i++)	// default to a gray map
 		pe[i] = PalEntry(255,i,i,i);
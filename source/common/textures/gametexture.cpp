@@ -49,6 +49,7 @@
 #include "texturemanager.h"
 #include "c_cvars.h"
 #include "hw_material.h"
+#include "hw_2datlas.h"
 
 FTexture *CreateBrightmapTexture(FImageSource*);
 
@@ -421,7 +422,11 @@ void FGameTexture::SetSpriteRect()
 
 void FGameTexture::CleanHardwareData(bool full)
 {
-	if (full) Base->CleanHardwareTextures();
+	if (full)
+	{
+		Base->CleanHardwareTextures();
+		TwoDAtlas.Invalidate(Base.get());
+	}
 	for (auto mat : Material) if (mat) mat->DeleteDescriptors();
 }
 
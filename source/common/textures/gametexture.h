@@ -187,6 +187,8 @@ public:
 	void SetSkyOffset(int offs) { SkyOffset = offs; }
 	int GetSkyOffset() const { return SkyOffset; }
 	void setSeen() { flags |= GTexf_Seen; }
+
+	void MarkUsed() { Base->MarkUsed(); }
 	bool isSeen(bool reset) 
 	{ 
 		int v = flags & GTexf_Seen;   
@@ -38,6 +38,8 @@
 #include "tarray.h"
 #include "xs_Float.h"
 
+size_t IHardwareTexture::totalAllocated;
+
 //===========================================================================
 // 
 //	Quick'n dirty image rescaling.
@@ -15,7 +15,7 @@ public:
 	};
 
 	IHardwareTexture() = default;
-	virtual ~IHardwareTexture() = default;
+	virtual ~IHardwareTexture() { SetAllocatedSize(0); }
 
 	virtual void AllocateBuffer(int w, int h, int texelsize) = 0;
 	virtual uint8_t *MapBuffer() = 0;
@@ -25,6 +25,13 @@ public:
 
 	int GetBufferPitch() const { return bufferpitch; }
 
+	// Estimated video memory of the texture, used to enforce gl_texture_budget.
+	void SetAllocatedSize(size_t size) { totalAllocated += size - allocatedSize; allocatedSize = size; }
+	size_t GetAllocatedSize() const { return allocatedSize; }
+	static size_t GetTotalAllocatedSize() { return totalAllocated; }
+
 protected:
 	int bufferpitch = -1;
+	size_t allocatedSize = 0;
+	static size_t totalAllocated;
 };
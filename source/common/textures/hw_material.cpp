@@ -47,8 +47,11 @@ void FMaterial::SetLayerCallback(IHardwareTexture* (*cb)(int layer, int translat
 //
 //===========================================================================
 
+std::list<FMaterial*> FMaterial::AllMaterials;
+
 FMaterial::FMaterial(FGameTexture * tx, int scaleflags)
 {
+	mListPos = AllMaterials.insert(AllMaterials.end(), this);
 	mShaderIndex = SHADER_Default;
 	sourcetex = tx;
 	auto imgtex = tx->GetTexture();
@@ -163,6 +166,31 @@ FMaterial::FMaterial(FGameTexture * tx, int scaleflags)
 
 FMaterial::~FMaterial()
 {
+	AllMaterials.erase(mListPos);
+}
+
+//===========================================================================
+//
+// Deletes the descriptors of all materials that use the given texture in
+// any layer. Needed when its hardware textures get deleted, because they
+// are shared by all game textures using it, including those that are not
+// registered with the texture manager, like font characters.
+//
+//===========================================================================
+
+void FMaterial::DeleteDescriptorsFor(FTexture *tex)
+{
+	for (auto mat : AllMaterials)
+	{
+		for (auto &layer : mat->mTextureLayers)
+		{
+			if (layer.layerTexture == tex)
+			{
+				mat->DeleteDescriptors();
+				break;
+			}
+		}
+	}
 }
 
 
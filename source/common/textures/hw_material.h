@@ -4,6 +4,7 @@
 
 #include "m_fixed.h"
 #include "textures.h"
+#include <list>
 
 struct FRemapTable;
 class IHardwareTexture;
@@ -28,6 +29,9 @@ class FMaterial
 	int mShaderIndex;
 	int mLayerFlags = 0;
 	int mScaleFlags;
+	std::list<FMaterial*>::iterator mListPos;
+
+	static std::list<FMaterial*> AllMaterials;
 
 public:
 	static void SetLayerCallback(IHardwareTexture* (*layercallback)(int layer, int translation));
@@ -69,6 +73,12 @@ public:
 
 
 	static FMaterial *ValidateTexture(FGameTexture * tex, int scaleflags, bool create = true);
+	static void DeleteDescriptorsFor(FTexture *tex);
+
+	void MarkUsed()
+	{
+		for (auto &layer : mTextureLayers) layer.layerTexture->MarkUsed();
+	}
 	const TArray<MaterialLayerInfo> &GetLayerArray() const
 	{
 		return mTextureLayers;
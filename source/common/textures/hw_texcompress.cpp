@@ -0,0 +1,469 @@
+/*
+** hw_texcompress.cpp
+** BC1/BC3 compression of true color textures with a disk cache
+**
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The encoder fits the endpoints to the bounding box of each block's
+** colors, using the diagonal that matches the sign of the color covariance.
+** This is not as good as a cluster fit, but fast enough to not be noticed
+** on a texture pack's first use.
+**
+*/
+
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "hw_texcompress.h"
+#include "hw_texcontainer.h"
+#include "texturemanager.h"
+#include "c_cvars.h"
+#include "cmdlib.h"
+#include "files.h"
+#include "i_specialpaths.h"
+#include "md5.h"
+#include "printf.h"
+#include "stats.h"
+
+CUSTOM_CVAR(Bool, hw_texcompression, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_NOINITCALL)
+{
+	TexMan.FlushAll();
+}
+
+// Textures with fewer pixels than a square of this size are left alone.
+CUSTOM_CVAR(Int, hw_texcompression_minsize, 256, CVAR_ARCHIVE | CVAR_GLOBALCONFIG | CVAR_NOINITCALL)
+{
+	if (self < 4) self = 4;
+	TexMan.FlushAll();
+}
+
+CVAR(Bool, hw_texcompression_cache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+static const char TexCacheMagic[4] = { 'B', 'C', 'T', '1' };
+
+static unsigned NumCompressed, NumFromCache;
+static uint64_t UncompressedBytes, CompressedBytes;
+static cycle_t EncodeTime;
+
+//==========================================================================
+//
+// Fetches a 4x4 block, repeating the last row and column for blocks that
+// extend past the edge of the image.
+//
+//==========================================================================
+
+static void FetchBlock(const uint8_t *src, int width, int height, int bx, int by, uint8_t *block)
+{
+	for (int y = 0; y < 4; y++)
+	{
+		int sy = std::min(by * 4 + y, height - 1);
+		for (int x = 0; x < 4; x++)
+		{
+			int sx = std::min(bx * 4 + x, width - 1);
+			memcpy(&block[(y * 4 + x) * 4], &src[(sy * width + sx) * 4], 4);
+		}
+	}
+}
+
+static uint16_t ToRGB565(int r, int g, int b)
+{
+	return uint16_t((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void FromRGB565(uint16_t c, int *rgb)
+{
+	int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+//==========================================================================
+//
+// Encodes the color part of a block. The source is in BGRA order.
+//
+//==========================================================================
+
+static void EncodeColorBlock(const uint8_t *block, uint8_t *dest)
+{
+	int minc[3] = { 255, 255, 255 }, maxc[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			int v = block[i * 4 + 2 - c];
+			minc[c] = std::min(minc[c], v);
+			maxc[c] = std::max(maxc[c], v);
+		}
+	}
+
+	// Move the endpoints inward a bit, the extremes are rarely representative for the block.
+	int center[3];
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (maxc[c] - minc[c]) >> 4;
+		minc[c] += inset;
+		maxc[c] -= inset;
+		center[c] = (minc[c] + maxc[c] + 1) >> 1;
+	}
+
+	// Pick the diagonal of the bounding box that follows the colors, using green as the reference.
+	int covrg = 0, covbg = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int dr = block[i * 4 + 2] - center[0];
+		int dg = block[i * 4 + 1] - center[1];
+		int db = block[i * 4 + 0] - center[2];
+		covrg += dr * dg;
+		covbg += db * dg;
+	}
+	if (covrg < 0) std::swap(minc[0], maxc[0]);
+	if (covbg < 0) std::swap(minc[2], maxc[2]);
+
+	uint16_t c0 = ToRGB565(maxc[0], maxc[1], maxc[2]);
+	uint16_t c1 = ToRGB565(minc[0], minc[1], minc[2]);
+	if (c0 < c1) std::swap(c0, c1);
+
+	uint32_t indices = 0;
+	if (c0 != c1)
+	{
+		int pal[4][3];
+		FromRGB565(c0, pal[0]);
+		FromRGB565(c1, pal[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+			pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int r = block[i * 4 + 2], g = block[i * 4 + 1], b = block[i * 4 + 0];
+			int best = 0, bestdist = INT_MAX;
+			for (int j = 0; j < 4; j++)
+			{
+				int dr = r - pal[j][0], dg = g - pal[j][1], db = b - pal[j][2];
+				int dist = dr * dr + dg * dg + db * db;
+				if (dist < bestdist)
+				{
+					bestdist = dist;
+					best = j;
+				}
+			}
+			indices |= uint32_t(best) << (i * 2);
+		}
+	}
+
+	dest[0] = c0 & 255;
+	dest[1] = c0 >> 8;
+	dest[2] = c1 & 255;
+	dest[3] = c1 >> 8;
+	for (int i = 0; i < 4; i++) dest[4 + i] = (indices >> (i * 8)) & 255;
+}
+
+//==========================================================================
+//
+// Encodes the alpha part of a BC3 block with the 8 value interpolation.
+//
+//==========================================================================
+
+static void EncodeAlphaBlock(const uint8_t *block, uint8_t *dest)
+{
+	int mina = 255, maxa = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		mina = std::min(mina, (int)block[i * 4 + 3]);
+		maxa = std::max(maxa, (int)block[i * 4 + 3]);
+	}
+
+	uint64_t indices = 0;
+	if (maxa > mina)
+	{
+		int pal[8] = { maxa, mina };
+		for (int i = 1; i < 7; i++) pal[i + 1] = ((7 - i) * maxa + i * mina) / 7;
+
+		for (int i = 0; i < 16; i++)
+		{
+			int a = block[i * 4 + 3];
+			int best = 0, bestdist = INT_MAX;
+			for (int j = 0; j < 8; j++)
+			{
+				int dist = abs(a - pal[j]);
+				if (dist < bestdist)
+				{
+					bestdist = dist;
+					best = j;
+				}
+			}
+			indices |= uint64_t(best) << (i * 3);
+		}
+	}
+
+	dest[0] = maxa;
+	dest[1] = mina;
+	for (int i = 0; i < 6; i++) dest[2 + i] = (indices >> (i * 8)) & 255;
+}
+
+//==========================================================================
+//
+// Compresses one mip level, with the rows of blocks spread over all cores.
+//
+//==========================================================================
+
+static void EncodeLevel(const uint8_t *src, int width, int height, int format, uint8_t *dest)
+{
+	int blocksx = (width + 3) / 4, blocksy = (height + 3) / 4;
+	int blocksize = format == TEXCOMP_BC3 ? 16 : 8;
+
+	auto encoderow = [=](int by)
+	{
+		uint8_t block[64];
+		uint8_t *out = dest + size_t(by) * blocksx * blocksize;
+		for (int bx = 0; bx < blocksx; bx++)
+		{
+			FetchBlock(src, width, height, bx, by, block);
+			if (format == TEXCOMP_BC3)
+			{
+				EncodeAlphaBlock(block, out);
+				out += 8;
+			}
+			EncodeColorBlock(block, out);
+			out += 8;
+		}
+	};
+
+	unsigned numthreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), 16u);
+	numthreads = std::min<unsigned>(numthreads, blocksx * blocksy / 1024 + 1);
+
+	std::atomic<int> next = { 0 };
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			int by = next++;
+			if (by >= blocksy) break;
+			encoderow(by);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < numthreads; i++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto &thread : threads)
+		thread.join();
+}
+
+//==========================================================================
+//
+// 2x2 box filter for the mip chain.
+//
+//==========================================================================
+
+static void Downsample(const uint8_t *src, int width, int height, uint8_t *dest)
+{
+	int w = std::max(width >> 1, 1), h = std::max(height >> 1, 1);
+	for (int y = 0; y < h; y++)
+	{
+		int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < w; x++)
+		{
+			int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; c++)
+			{
+				int sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] + src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+				dest[(y * w + x) * 4 + c] = (sum + 2) >> 2;
+			}
+		}
+	}
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static FString TexCacheFileName(const uint8_t *key, bool create)
+{
+	FString path = M_GetCachePath(create);
+	path << "/texcache";
+	if (create) CreatePath(path);
+	path << "/";
+	for (int i = 0; i < 16; i++) path.AppendFormat("%02x", key[i]);
+	path << ".bct";
+	return path;
+}
+
+static bool LoadCompressed(const uint8_t *key, FCompressedTexture &out)
+{
+	FileReader fr;
+	if (!fr.OpenFile(TexCacheFileName(key, false))) return false;
+
+	char magic[4];
+	uint32_t header[4];
+	if (fr.Read(magic, 4) != 4 || memcmp(magic, TexCacheMagic, 4) || fr.Read(header, sizeof(header)) != sizeof(header)) return false;
+	if ((int)header[0] != out.Format || (int)header[1] != out.Width || (int)header[2] != out.Height || header[3] == 0 || header[3] > 32) return false;
+
+	out.LevelOffsets.Resize(header[3] + 1);
+	if (fr.Read(out.LevelOffsets.Data(), out.LevelOffsets.Size() * 4) != (FileReader::Size)(out.LevelOffsets.Size() * 4)) return false;
+	uint32_t size = out.LevelOffsets.Last();
+	if (out.LevelOffsets[0] != 0) return false;
+	for (unsigned i = 1; i < out.LevelOffsets.Size(); i++)
+	{
+		if (out.LevelOffsets[i] < out.LevelOffsets[i - 1]) return false;
+	}
+
+	out.Data.Resize(size);
+	return fr.Read(out.Data.Data(), size) == (FileReader::Size)size;
+}
+
+static void SaveCompressed(const uint8_t *key, const FCompressedTexture &tex)
+{
+	std::unique_ptr<FileWriter> fw(FileWriter::Open(TexCacheFileName(key, true)));
+	if (fw)
+	{
+		uint32_t header[4] = { (uint32_t)tex.Format, (uint32_t)tex.Width, (uint32_t)tex.Height, (uint32_t)tex.NumLevels() };
+		fw->Write(TexCacheMagic, 4);
+		fw->Write(header, sizeof(header));
+		fw->Write(tex.LevelOffsets.Data(), tex.LevelOffsets.Size() * 4);
+		fw->Write(tex.Data.Data(), tex.Data.Size());
+	}
+}
+
+//==========================================================================
+//
+// Compression is limited to sizes that are a multiple of the block size.
+// For anything else the hardware APIs differ in how they handle the
+// partial blocks at the edge.
+//
+//==========================================================================
+
+bool ShouldCompressTexture(int width, int height, int flags)
+{
+	if (!hw_texcompression || (flags & CTF_Indexed)) return false;
+	if (width <= 0 || height <= 0 || (width & 3) || (height & 3)) return false;
+	return width * height >= hw_texcompression_minsize * hw_texcompression_minsize;
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+bool CompressTexture(const uint8_t *bgra, int width, int height, bool mipmap, FCompressedTexture &out)
+{
+	if (bgra == nullptr) return false;
+
+	size_t size = size_t(width) * height * 4;
+	bool alpha = false;
+	for (size_t i = 3; i < size && !alpha; i += 4)
+	{
+		alpha = bgra[i] != 255;
+	}
+
+	out.Format = alpha ? TEXCOMP_BC3 : TEXCOMP_BC1;
+	out.Width = width;
+	out.Height = height;
+
+	int blocksize = alpha ? 16 : 8;
+	int numlevels = 1;
+	if (mipmap)
+	{
+		for (int w = width, h = height; w > 1 || h > 1; numlevels++)
+		{
+			w = std::max(w >> 1, 1);
+			h = std::max(h >> 1, 1);
+		}
+	}
+
+	uint64_t rawsize = 0;
+	for (int i = 0; i < numlevels; i++) rawsize += uint64_t(out.LevelWidth(i)) * out.LevelHeight(i) * 4;
+
+	uint8_t key[16];
+	MD5Context md5;
+	uint32_t params[3] = { (uint32_t)width, (uint32_t)height, (uint32_t)numlevels };
+	md5.Update((const uint8_t *)params, sizeof(params));
+	for (size_t pos = 0; pos < size; pos += 0x40000000)
+	{
+		md5.Update(bgra + pos, (unsigned)std::min<size_t>(size - pos, 0x40000000));
+	}
+	md5.Final(key);
+
+	if (hw_texcompression_cache && LoadCompressed(key, out) && out.NumLevels() == numlevels)
+	{
+		NumFromCache++;
+	}
+	else
+	{
+		EncodeTime.Clock();
+		out.LevelOffsets.Resize(numlevels + 1);
+		uint32_t offset = 0;
+		for (int i = 0; i < numlevels; i++)
+		{
+			out.LevelOffsets[i] = offset;
+			offset += ((out.LevelWidth(i) + 3) / 4) * ((out.LevelHeight(i) + 3) / 4) * blocksize;
+		}
+		out.LevelOffsets[numlevels] = offset;
+		out.Data.Resize(offset);
+
+		TArray<uint8_t> mip[2];
+		const uint8_t *src = bgra;
+		for (int i = 0; i < numlevels; i++)
+		{
+			EncodeLevel(src, out.LevelWidth(i), out.LevelHeight(i), out.Format, &out.Data[out.LevelOffsets[i]]);
+			if (i + 1 < numlevels)
+			{
+				auto &next = mip[i & 1];
+				next.Resize(out.LevelWidth(i + 1) * out.LevelHeight(i + 1) * 4);
+				Downsample(src, out.LevelWidth(i), out.LevelHeight(i), next.Data());
+				src = next.Data();
+			}
+		}
+		EncodeTime.Unclock();
+		if (hw_texcompression_cache) SaveCompressed(key, out);
+	}
+
+	NumCompressed++;
+	UncompressedBytes += rawsize;
+	CompressedBytes += out.Data.Size();
+	return true;
+}
+
+ADD_STAT(texcompress)
+{
+	FString out;
+	out.Format("%u textures compressed, %u from cache, %.1f MB instead of %.1f MB (%.1f MB saved), encoding took %.1f ms%s",
+		NumCompressed, NumFromCache, CompressedBytes / 1048576., UncompressedBytes / 1048576., (UncompressedBytes - CompressedBytes) / 1048576.,
+		EncodeTime.TimeMS(), hw_texcompression ? "" : " (hw_texcompression off)");
+	return out;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include "tarray.h"
+
+// Block compression of large true color textures.
+//
+// Opaque textures get compressed to BC1, everything with alpha to BC3. The
+// encoder runs on the CPU, so the results, including the mip chain, are
+// kept in a disk cache keyed by the source pixels. That way it only has to
+// run the first time a texture gets uploaded.
+
+enum ETexCompressionFormat
+{
+	TEXCOMP_BC1,
+	TEXCOMP_BC3,
+};
+
+struct FCompressedTexture
+{
+	int Format = TEXCOMP_BC1;
+	int Width = 0;
+	int Height = 0;
+	TArray<uint8_t> Data;
+	TArray<uint32_t> LevelOffsets;	// start of each mip level in Data, plus the end of the last one.
+
+	int NumLevels() const { return LevelOffsets.Size() - 1; }
+	int LevelWidth(int level) const { return Width >> level > 0 ? Width >> level : 1; }
+	int LevelHeight(int level) const { return Height >> level > 0 ? Height >> level : 1; }
+	uint32_t LevelSize(int level) const { return LevelOffsets[level + 1] - LevelOffsets[level]; }
+	const uint8_t *LevelData(int level) const { return Data.Data() + LevelOffsets[level]; }
+};
+
+bool ShouldCompressTexture(int width, int height, int flags);
+bool CompressTexture(const uint8_t *bgra, int width, int height, bool mipmap, FCompressedTexture &out);
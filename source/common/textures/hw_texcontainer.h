@@ -163,6 +163,13 @@ public:
 	}
 
 
+	size_t GetAllocatedSize()
+	{
+		size_t size = 0;
+		Iterate([&](IHardwareTexture* tex) { size += tex->GetAllocatedSize(); });
+		return size;
+	}
+
 	template<class T>
 	void Iterate(T callback)
 	{
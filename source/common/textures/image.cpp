@@ -34,12 +34,23 @@
 **
 */
 
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
 #include "bitmap.h"
 #include "image.h"
 #include "filesystem.h"
 #include "files.h"
 #include "cmdlib.h"
 #include "palettecontainer.h"
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "printf.h"
+#include "stats.h"
+
+CVAR(Bool, r_parallelimagedecode, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+EXTERN_CVAR(Bool, png_simd)
 
 FMemArena ImageArena(32768);
 TArray<FImageSource *>FImageSource::ImageForLump;
@@ -301,6 +312,171 @@ void FImageSource::RegisterForPrecache(FImageSource *img, bool requiretruecolor)
 	img->CollectForPrecache(precacheInfo, requiretruecolor);
 }
 
+//==========================================================================
+//
+// Calls func for all indices below count, spread over all cores.
+//
+//==========================================================================
+
+static void RunDecodeThreads(unsigned count, const std::function<void(unsigned)> &func)
+{
+	unsigned numthreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), 16u);
+	numthreads = std::min(numthreads, count);
+
+	std::atomic<unsigned> next = { 0 };
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			unsigned i = next++;
+			if (i >= count) break;
+			func(i);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < numthreads; i++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto &thread : threads)
+		thread.join();
+}
+
+//==========================================================================
+//
+// PredecodeImages
+//
+// Decodes the true color data of a batch of images at once and places it
+// in the cache, where the next GetCachedBitmap call for each image picks
+// it up. Only the decoding runs on the worker threads, the lumps get read
+// up front because the file system is not thread safe. Anything that is
+// not consumed gets discarded by EndPrecaching.
+//
+//==========================================================================
+
+void FImageSource::PredecodeImages(const TArray<FImageSource *> &images)
+{
+	struct DecodeJob
+	{
+		FImageSource *Image;
+		FileData Data;
+		FBitmap Pixels;
+		int TransInfo;
+		bool Success;
+	};
+
+	if (!r_parallelimagedecode) return;
+
+	TArray<DecodeJob> jobs;
+	for (auto img : images)
+	{
+		if (img == nullptr || img->SourceLump < 0 || !img->CanDecodeFromMemory()) continue;
+
+		int imageID = img->ImageID;
+		if (precacheDataRgba.FindEx([=](PrecacheDataRgba &entry) { return entry.ImageID == imageID; }) < precacheDataRgba.Size()) continue;
+		if (jobs.FindEx([=](DecodeJob &job) { return job.Image == img; }) < jobs.Size()) continue;
+
+		auto &job = jobs[jobs.Reserve(1)];
+		job.Image = img;
+		job.Data = fileSystem.ReadFile(img->SourceLump);
+		job.TransInfo = 0;
+		job.Success = false;
+	}
+	if (jobs.Size() < 2) return;
+
+	RunDecodeThreads(jobs.Size(), [&](unsigned i)
+	{
+		auto &job = jobs[i];
+		try
+		{
+			FileReader fr;
+			if (fr.OpenMemory(job.Data.GetMem(), job.Data.GetSize()) && job.Pixels.Create(job.Image->Width, job.Image->Height))
+			{
+				job.TransInfo = job.Image->CopyPixelsFromMemory(&job.Pixels, fr);
+				job.Success = true;
+			}
+		}
+		catch (...)
+		{
+			// Leave it to GetCachedBitmap which will then report the error on the main thread.
+		}
+	});
+
+	for (auto &job : jobs)
+	{
+		if (!job.Success) continue;
+		auto pdr = &precacheDataRgba[precacheDataRgba.Reserve(1)];
+		pdr->ImageID = job.Image->ImageID;
+		pdr->RefCount = 1;
+		pdr->TransInfo = job.TransInfo;
+		pdr->Pixels = std::move(job.Pixels);
+	}
+}
+
+//==========================================================================
+//
+// Decodes all PNGs in the loaded resources (or the given number of them)
+// with the generic and the SIMD row filters and on all cores.
+//
+//==========================================================================
+
+CCMD(pngbench)
+{
+	unsigned maxcount = argv.argc() > 1 ? (unsigned)max(atoi(argv[1]), 1) : 500;
+
+	TArray<FImageSource *> images;
+	TArray<FileData> data;
+	size_t insize = 0, outsize = 0;
+	for (int i = 0; i < fileSystem.GetNumEntries() && images.Size() < maxcount; i++)
+	{
+		FString name = fileSystem.GetFileFullName(i, false);
+		if (name.Len() < 4 || stricmp(name.GetChars() + name.Len() - 4, ".png")) continue;
+		auto img = FImageSource::GetImage(i, false);
+		if (img == nullptr || !img->CanDecodeFromMemory()) continue;
+
+		images.Push(img);
+		data.Push(fileSystem.ReadFile(i));
+		insize += data.Last().GetSize();
+		outsize += size_t(img->GetWidth()) * img->GetHeight() * 4;
+	}
+	if (images.Size() == 0)
+	{
+		Printf("No PNG images found\n");
+		return;
+	}
+
+	auto decode = [&](unsigned i)
+	{
+		FileReader fr;
+		FBitmap bmp;
+		if (fr.OpenMemory(data[i].GetMem(), data[i].GetSize()) && bmp.Create(images[i]->GetWidth(), images[i]->GetHeight()))
+		{
+			images[i]->CopyPixelsFromMemory(&bmp, fr);
+		}
+	};
+
+	auto run = [&](const char *label, bool simd, bool threaded)
+	{
+		bool oldsimd = png_simd;
+		png_simd = simd;
+		cycle_t time;
+		time.Reset();
+		time.Clock();
+		if (threaded) RunDecodeThreads(images.Size(), decode);
+		else for (unsigned i = 0; i < images.Size(); i++) decode(i);
+		time.Unclock();
+		png_simd = oldsimd;
+
+		double secs = max(time.TimeMS(), 0.001) / 1000.;
+		Printf("%-10s %8.1f ms, %7.1f MB/s in, %7.1f MB/s out\n", label, time.TimeMS(), insize / secs / 1048576., outsize / secs / 1048576.);
+	};
+
+	Printf("%u images, %.1f MB compressed, %.1f MB decoded\n", images.Size(), insize / 1048576., outsize / 1048576.);
+	run("generic", false, false);
+	run("simd", true, false);
+	run("threaded", true, true);
+}
+
 //==========================================================================
 //
 //
@@ -6,6 +6,7 @@
 #include "memarena.h"
 
 class FImageSource;
+class FileReader;
 using PrecacheInfo = TMap<int, std::pair<int, int>>;
 extern FMemArena ImageArena;
 
@@ -108,6 +109,11 @@ public:
 
 	virtual int CopyPixels(FBitmap* bmp, int conversion);
 
+	// Formats whose decoder only depends on the image's own fields can decode from a copy of
+	// the lump that was read beforehand. This is what allows running it on a worker thread.
+	virtual bool CanDecodeFromMemory() const { return false; }
+	virtual int CopyPixelsFromMemory(FBitmap *bmp, FileReader &data) { return CopyPixels(bmp, normal); }
+
 	FBitmap GetCachedBitmap(const PalEntry *remap, int conversion, int *trans = nullptr);
 
 	static void ClearImages() { ImageArena.FreeAll(); ImageForLump.Clear(); NextID = 0; }
@@ -166,6 +172,7 @@ public:
 	static void BeginPrecaching();
 	static void EndPrecaching();
 	static void RegisterForPrecache(FImageSource *img, bool requiretruecolor);
+	static void PredecodeImages(const TArray<FImageSource *> &images);
 };
 
 
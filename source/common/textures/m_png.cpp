@@ -48,6 +48,14 @@
 #include "c_cvars.h"
 #include "m_png.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__i386__) || defined(__amd64__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <emmintrin.h>
+#define PNG_SSE2
+#endif
+
 
 // MACROS ------------------------------------------------------------------
 
@@ -111,6 +119,7 @@ CUSTOM_CVAR(Int, png_level, 5, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 		self = 9;
 }
 CVAR(Float, png_gamma, 0.f, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Bool, png_simd, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 
 // PRIVATE DATA DEFINITIONS ------------------------------------------------
 
@@ -1077,10 +1086,145 @@ static bool WriteIDAT (FileWriter *file, const uint8_t *data, int len)
 //
 //==========================================================================
 
+#ifdef PNG_SSE2
+
+// Sub, Average and Paeth depend on the pixel to the left, so these work on
+// one whole pixel at a time, with all its channels in one register. This is
+// only done for 3 and 4 bytes per pixel, which is what true color images use.
+
+static inline __m128i LoadPixel(const uint8_t *p, int bpp)
+{
+	uint32_t v = 0;
+	memcpy(&v, p, bpp);
+	return _mm_cvtsi32_si128(v);
+}
+
+static inline void StorePixel(uint8_t *p, __m128i v, int bpp)
+{
+	uint32_t t = _mm_cvtsi128_si32(v);
+	memcpy(p, &t, bpp);
+}
+
+template<int bpp>
+static void UnfilterSub_SSE2(int width, uint8_t *dest, const uint8_t *row)
+{
+	__m128i a = _mm_setzero_si128();
+	for (int x = 0; x < width; x += bpp)
+	{
+		a = _mm_add_epi8(a, LoadPixel(row + x, bpp));
+		StorePixel(dest + x, a, bpp);
+	}
+}
+
+template<int bpp>
+static void UnfilterAverage_SSE2(int width, uint8_t *dest, const uint8_t *row, const uint8_t *prev)
+{
+	const __m128i one = _mm_set1_epi8(1);
+	__m128i a = _mm_setzero_si128();
+	for (int x = 0; x < width; x += bpp)
+	{
+		__m128i b = LoadPixel(prev + x, bpp);
+		// _mm_avg_epu8 rounds up but PNG rounds down.
+		__m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+		a = _mm_add_epi8(LoadPixel(row + x, bpp), avg);
+		StorePixel(dest + x, a, bpp);
+	}
+}
+
+template<int bpp>
+static void UnfilterPaeth_SSE2(int width, uint8_t *dest, const uint8_t *row, const uint8_t *prev)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a = zero, c = zero;
+	for (int x = 0; x < width; x += bpp)
+	{
+		__m128i b = _mm_unpacklo_epi8(LoadPixel(prev + x, bpp), zero);
+		__m128i pa = _mm_sub_epi16(b, c);
+		__m128i pb = _mm_sub_epi16(a, c);
+		__m128i pc = _mm_add_epi16(pa, pb);
+		pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+		pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+		pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+		__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+		__m128i usea = _mm_cmpeq_epi16(smallest, pa);
+		__m128i useb = _mm_andnot_si128(usea, _mm_cmpeq_epi16(smallest, pb));
+		__m128i usec = _mm_andnot_si128(_mm_or_si128(usea, useb), _mm_set1_epi16(-1));
+		__m128i pred = _mm_or_si128(_mm_or_si128(_mm_and_si128(usea, a), _mm_and_si128(useb, b)), _mm_and_si128(usec, c));
+
+		__m128i d = _mm_add_epi8(LoadPixel(row + x, bpp), _mm_packus_epi16(pred, pred));
+		StorePixel(dest + x, d, bpp);
+		a = _mm_unpacklo_epi8(d, zero);
+		c = b;
+	}
+}
+
+static void UnfilterUp_SSE2(int width, uint8_t *dest, const uint8_t *row, const uint8_t *prev)
+{
+	int x = 0;
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i r = _mm_loadu_si128((const __m128i *)(row + x));
+		__m128i p = _mm_loadu_si128((const __m128i *)(prev + x));
+		_mm_storeu_si128((__m128i *)(dest + x), _mm_add_epi8(r, p));
+	}
+	for (; x < width; x++)
+	{
+		dest[x] = row[x] + prev[x];
+	}
+}
+
+//==========================================================================
+//
+// UnfilterRow_SSE2
+//
+// Returns false for everything it cannot handle so that the generic
+// version can take care of it.
+//
+//==========================================================================
+
+static bool UnfilterRow_SSE2 (int width, uint8_t *dest, const uint8_t *row, const uint8_t *prev, int bpp)
+{
+	int filter = *row++;
+	if (filter == 2)
+	{
+		UnfilterUp_SSE2(width, dest, row, prev);
+		return true;
+	}
+	if (bpp == 4)
+	{
+		switch (filter)
+		{
+		case 1:	UnfilterSub_SSE2<4>(width, dest, row); return true;
+		case 3:	UnfilterAverage_SSE2<4>(width, dest, row, prev); return true;
+		case 4:	UnfilterPaeth_SSE2<4>(width, dest, row, prev); return true;
+		}
+	}
+	else if (bpp == 3)
+	{
+		switch (filter)
+		{
+		case 1:	UnfilterSub_SSE2<3>(width, dest, row); return true;
+		case 3:	UnfilterAverage_SSE2<3>(width, dest, row, prev); return true;
+		case 4:	UnfilterPaeth_SSE2<3>(width, dest, row, prev); return true;
+		}
+	}
+	return false;
+}
+
+#endif
+
 void UnfilterRow (int width, uint8_t *dest, uint8_t *row, uint8_t *prev, int bpp)
 {
 	int x;
 
+#ifdef PNG_SSE2
+	if (png_simd && UnfilterRow_SSE2(width, dest, row, prev, bpp))
+	{
+		return;
+	}
+#endif
+
 	switch (*row++)
 	{
 	case 1:		// Sub
@@ -56,6 +56,7 @@ IHardwareTexture* CreateHardwareTexture(int numchannels);
 
 // Make sprite offset adjustment user-configurable per renderer.
 int r_spriteadjustSW, r_spriteadjustHW;
+int FTexture::CurrentFrame = 1;
 
 //==========================================================================
 //
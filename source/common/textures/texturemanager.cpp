@@ -47,6 +47,10 @@
 #include "vectors.h"
 #include "animtexture.h"
 #include "formats/multipatchtexture.h"
+#include "hw_ihwtexture.h"
+#include "hw_material.h"
+#include "stats.h"
+#include <algorithm>
 
 FTextureManager TexMan;
 
@@ -115,6 +119,7 @@ void FTextureManager::DeleteAll()
 
 void FTextureManager::FlushAll()
 {
+	FlushCount++;
 	for (int i = TexMan.NumTextures() - 1; i >= 0; i--)
 	{
 		for (int j = 0; j < 2; j++)
@@ -127,6 +132,62 @@ void FTextureManager::FlushAll()
 	}
 }
 
+//==========================================================================
+//
+// Keeps the hardware textures within gl_texture_budget (in MB).
+// Once the estimated video memory goes over the budget the textures that
+// have not been drawn for the longest time get deleted. They will be
+// recreated when they are needed again. Called once at the end of each frame.
+//
+//==========================================================================
+
+CVAR(Int, gl_texture_budget, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+static int textureBudgetEvictions;
+
+void FTextureManager::EnforceTextureBudget()
+{
+	int frame = FTexture::CurrentFrame++;
+
+	if (gl_texture_budget <= 0) return;
+	size_t budget = size_t(gl_texture_budget) << 20;
+	if (IHardwareTexture::GetTotalAllocatedSize() <= budget) return;
+
+	// Go a bit below the budget so that this does not have to run again every frame.
+	size_t target = budget - budget / 8;
+
+	// Several game textures can share one FTexture, e.g. hightile layers and font characters,
+	// so candidates are collected per FTexture, which is what owns the hardware textures.
+	TMap<FTexture*, bool> visited;
+	TArray<FTexture*> candidates;
+	for (unsigned i = 0; i < Textures.Size(); i++)
+	{
+		auto tex = Textures[i].Texture->GetTexture();
+		if (tex == nullptr || visited.CheckKey(tex)) continue;
+		visited.Insert(tex, true);
+		// Anything drawn in the last frame is still needed.
+		if (tex->GetLastUsedFrame() >= frame || tex->isHardwareCanvas()) continue;
+		if (tex->GetHardwareTextureSize() == 0) continue;
+		candidates.Push(tex);
+	}
+	std::sort(candidates.begin(), candidates.end(), [](FTexture* a, FTexture* b) { return a->GetLastUsedFrame() < b->GetLastUsedFrame(); });
+
+	for (auto tex : candidates)
+	{
+		FMaterial::DeleteDescriptorsFor(tex);
+		tex->CleanHardwareTextures();
+		textureBudgetEvictions++;
+		if (IHardwareTexture::GetTotalAllocatedSize() <= target) break;
+	}
+}
+
+ADD_STAT(texbudget)
+{
+	FString out;
+	out.Format("Texture memory: %.1f MB, budget: %d MB, evicted: %d", IHardwareTexture::GetTotalAllocatedSize() / (1024. * 1024.), *gl_texture_budget, textureBudgetEvictions);
+	return out;
+}
+
 //==========================================================================
 //
 // Examines the lump contents to decide what type of texture to create,
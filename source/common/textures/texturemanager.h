@@ -76,6 +76,8 @@ public:
 	bool OkForLocalization(FTextureID texnum, const char *substitute, int locnum);
 
 	void FlushAll();
+	int GetFlushCount() const { return FlushCount; }
+	void EnforceTextureBudget();
 	void Listaliases();
 	FTextureID GetFrontSkyLayer(FTextureID);
 	FTextureID GetRawTexture(FTextureID tex, bool dontlookup = false);
@@ -179,10 +181,6 @@ public:
 		BuildTileData.Reserve(1);
 		return BuildTileData.Last();
 	}
-	TArray<TArray<uint8_t>>& GetBuildTileDataStore()
-	{
-		return BuildTileData;
-	}
 
 	FGameTexture* GameTexture(FTextureID id) { return Textures[id.GetIndex()].Texture; }
 	void SetTranslation(FTextureID fromtexnum, FTextureID totexnum);
@@ -219,6 +217,7 @@ private:
 	TArray<int> FirstTextureForFile;
 	TArray<TArray<uint8_t> > BuildTileData;
 	TArray<int> Translation;
+	int FlushCount = 0;
 
 	TMap<FName, TextureManipulation> tmanips;
 	TMap<FName, int> aliases;
@@ -219,9 +219,14 @@ protected:
 	bool bHasCanvas = false;
 	int8_t bTranslucent = -1;
 	int8_t areacount = 0;			// this is capped at 4 sections.
+	int LastUsedFrame = 0;
 
 
 public:
+	// Frame tracking for the texture budget. This is per FTexture because the hardware textures are shared by all game textures using it.
+	static int CurrentFrame;
+	void MarkUsed() { LastUsedFrame = CurrentFrame; }
+	int GetLastUsedFrame() const { return LastUsedFrame; }
 
 	IHardwareTexture* GetHardwareTexture(int translation, int scaleflags);
 	virtual FImageSource *GetImage() const { return nullptr; }
@@ -232,6 +237,11 @@ public:
 		SystemTextures.Clean();
 	}
 
+	size_t GetHardwareTextureSize()
+	{
+		return SystemTextures.GetAllocatedSize();
+	}
+
 	void CleanPrecacheMarker()
 	{
 		SystemTextures.UnmarkAll();
@@ -39,6 +39,9 @@
 #include "vm.h"
 #include "texturemanager.h"
 #include "buildtiles.h"
+#include "stats.h"
+#include "c_dispatch.h"
+#include <algorithm>
 
 // Doubly linked ring list of Actors
 
@@ -58,6 +61,212 @@ static bool isSafe()
 	return isBlood() || safe_spritelist;
 }
 
+//==========================================================================
+//
+// Spatial hash for radius queries
+//
+// Actors are linked into a fixed number of buckets by the map cell their
+// position falls into. Since the game code writes actor positions directly
+// in many places, the hash cannot be kept exact at all times. Instead it is
+// invalidated at the start of each tic and rebuilt by the first query in
+// that tic. Afterward SetActor and ChangeActorSect relink moved actors,
+// actors inserted in the meantime are kept on a pending list that every
+// query checks, and queries look one cell beyond the requested area to
+// account for actors moved without notifying the hash.
+//
+//==========================================================================
+
+enum
+{
+	HashBuckets = 4096,
+	HashCellShift = 7,		// 128 map units, i.e. 2048 Build units.
+	HashPending = -2,
+};
+
+static DCoreActor* hashBuckets[HashBuckets];
+static unsigned hashBucketStamp[HashBuckets];
+static unsigned hashStamp;
+static TArray<DCoreActor*> hashPending;
+static bool hashValid;
+static int minLinkSeq, maxLinkSeq;
+static int hashRebuilds, hashQueries, hashCandidates;
+
+static inline int HashCellCoord(double v)
+{
+	return int(floor(v)) >> HashCellShift;
+}
+
+static inline int HashBucket(int cx, int cy)
+{
+	return (unsigned(cx) * 73856093u ^ unsigned(cy) * 19349663u) & (HashBuckets - 1);
+}
+
+static void HashUnlink(DCoreActor* actor)
+{
+	if (actor->hashCell >= 0)
+	{
+		if (actor->prevHash) actor->prevHash->nextHash = actor->nextHash;
+		else hashBuckets[actor->hashCell] = actor->nextHash;
+		if (actor->nextHash) actor->nextHash->prevHash = actor->prevHash;
+	}
+	else if (actor->hashCell == HashPending)
+	{
+		hashPending.Delete(hashPending.Find(actor));
+	}
+	actor->prevHash = actor->nextHash = nullptr;
+	actor->hashCell = -1;
+}
+
+static void HashLink(DCoreActor* actor)
+{
+	int bucket = HashBucket(HashCellCoord(actor->spr.pos.X), HashCellCoord(actor->spr.pos.Y));
+	actor->prevHash = nullptr;
+	actor->nextHash = hashBuckets[bucket];
+	if (actor->nextHash) actor->nextHash->prevHash = actor;
+	hashBuckets[bucket] = actor;
+	actor->hashCell = bucket;
+}
+
+static void HashRelink(DCoreActor* actor)
+{
+	// Pending actors stay pending because their position may not be final yet.
+	if (!hashValid || actor->hashCell == HashPending) return;
+	HashUnlink(actor);
+	HashLink(actor);
+}
+
+static void HashAddPending(DCoreActor* actor)
+{
+	if (!hashValid) return;
+	HashUnlink(actor);
+	actor->hashCell = HashPending;
+	hashPending.Push(actor);
+}
+
+static void HashRemove(DCoreActor* actor)
+{
+	if (hashValid) HashUnlink(actor);
+}
+
+static void RebuildActorHash()
+{
+	memset(hashBuckets, 0, sizeof(hashBuckets));
+	hashPending.Clear();
+	hashValid = true;
+	for (auto& stat : statList)
+	{
+		for (auto actor = stat.firstEntry; actor; actor = actor->nextStat)
+		{
+			HashLink(actor);
+		}
+	}
+	hashRebuilds++;
+}
+
+//==========================================================================
+//
+// Must be called whenever actors may have moved without being relinked.
+//
+//==========================================================================
+
+void InvalidateActorHash()
+{
+	hashValid = false;
+	hashPending.Clear();
+}
+
+//==========================================================================
+//
+// Same, but also renumbers the stat lists' sequence numbers. Needed when
+// the lists were set up without going through AddStatTail/AddStatHead,
+// i.e. after loading a savegame.
+//
+//==========================================================================
+
+void ResetActorHash()
+{
+	InvalidateActorHash();
+	int seq = 0;
+	for (auto& stat : statList)
+	{
+		for (auto actor = stat.firstEntry; actor; actor = actor->nextStat)
+		{
+			actor->linkseq = seq++;
+		}
+	}
+	minLinkSeq = 0;
+	maxLinkSeq = seq;
+}
+
+//==========================================================================
+//
+// Collects all actors in the stat list whose 2D position is within the
+// radius, in stat list order. Only actors that were linked into the list
+// at or after minseq are returned. The return value is the sequence number
+// that the next actor to be appended to any stat list will get.
+//
+//==========================================================================
+
+int CollectActorsInRadius(TArray<DCoreActor*>& list, const DVector2& center, double radius, int statnum, int minseq)
+{
+	if (!hashValid) RebuildActorHash();
+	hashQueries++;
+
+	double radiussq = radius * radius;
+	auto check = [&](DCoreActor* actor)
+	{
+		hashCandidates++;
+		if (!actor->exists() || actor->spr.statnum != statnum || actor->linkseq < minseq) return;
+		if ((actor->spr.pos.XY() - center).LengthSquared() <= radiussq) list.Push(actor);
+	};
+
+	int x1 = HashCellCoord(center.X - radius) - 1;
+	int x2 = HashCellCoord(center.X + radius) + 1;
+	int y1 = HashCellCoord(center.Y - radius) - 1;
+	int y2 = HashCellCoord(center.Y + radius) + 1;
+
+	if (int64_t(x2 - x1 + 1) * (y2 - y1 + 1) >= HashBuckets)
+	{
+		for (auto head : hashBuckets)
+		{
+			for (auto actor = head; actor; actor = actor->nextHash) check(actor);
+		}
+	}
+	else
+	{
+		// Different cells may share a bucket, which must only be scanned once.
+		if (++hashStamp == 0)
+		{
+			memset(hashBucketStamp, 0, sizeof(hashBucketStamp));
+			hashStamp = 1;
+		}
+		for (int y = y1; y <= y2; y++)
+		{
+			for (int x = x1; x <= x2; x++)
+			{
+				int bucket = HashBucket(x, y);
+				if (hashBucketStamp[bucket] == hashStamp) continue;
+				hashBucketStamp[bucket] = hashStamp;
+				for (auto actor = hashBuckets[bucket]; actor; actor = actor->nextHash) check(actor);
+			}
+		}
+	}
+	for (auto actor : hashPending) check(actor);
+
+	std::sort(list.begin(), list.end(), [](DCoreActor* a, DCoreActor* b)
+	{
+		return a->linkseq < b->linkseq;
+	});
+	return maxLinkSeq;
+}
+
+ADD_STAT(actorhash)
+{
+	FString out;
+	out.Format("Actor hash: %d rebuilds, %d queries, %d candidates", hashRebuilds, hashQueries, hashCandidates);
+	return out;
+}
+
 //==========================================================================
 //
 //
@@ -100,6 +309,7 @@ static void AddStatTail(DCoreActor* actor, int statnum)
 	else statList[statnum].firstEntry = actor;
 	statList[statnum].lastEntry = actor;
 	assert(ValidateStatList(statnum));
+	actor->linkseq = maxLinkSeq++;
 	actor->spr.statnum = statnum;
 	actor->link_stat = statnum;
 	GC::WriteBarrier(actor);
@@ -124,6 +334,7 @@ static void AddStatHead(DCoreActor* actor, int statnum)
 	else statList[statnum].lastEntry = actor;
 	assert(ValidateStatList(statnum));
 	statList[statnum].firstEntry = actor;
+	actor->linkseq = --minLinkSeq;
 	actor->spr.statnum = statnum;
 	actor->link_stat = statnum;
 	GC::WriteBarrier(actor);
@@ -337,6 +548,7 @@ void ChangeActorSect(DCoreActor* actor, sectortype* sect, bool tail)
 	if (sect == nullptr) return;
 	RemoveActorSect(actor);
 	InsertActorSect(actor, sect, tail);
+	HashRelink(actor);
 }
 
 //==========================================================================
@@ -366,6 +578,7 @@ DCoreActor* InsertActor(PClass* type, sectortype* sector, int stat, bool tail)
 
 	Numsprites++;
 	actor->time = leveltimer++;
+	HashAddPending(actor);	// the position has not been set yet.
 	return actor;
 }
 
@@ -403,6 +616,7 @@ void DCoreActor::initFromSprite(spritetype* mspr)
 #undef setter
 
 	clipdist = spr.clipdist * 0.25;
+	HashRelink(this);
 	if (mspr->statnum != 0 && !(actorinfo->DefaultFlags & DEFF_STATNUM))
 		ChangeActorStat(this, mspr->statnum);
 }
@@ -433,6 +647,7 @@ void DCoreActor::OnDestroy()
 	if(link_stat == INT_MAX) return;
 
 	int stat = link_stat;
+	HashRemove(this);
 	RemoveActorStat(this);
 
 	auto sect = link_sector;
@@ -465,6 +680,7 @@ void InitSpriteLists()
 	TSpriteIterator<DCoreActor> it;
 	while (auto actor = it.Next())
 		allActors.Push(actor);
+	InvalidateActorHash();
 
 	// clear all lists manually before doing any mass destruction. 
 	// This may also be called in error situations where the list has become corrupted, 
@@ -488,6 +704,7 @@ void InitSpriteLists()
 		}
 	}
 	Numsprites = 0;
+	ResetActorHash();
 }
 
 //==========================================================================
@@ -504,6 +721,8 @@ void SetActor(DCoreActor* actor, const DVector3& newpos)
 
 	if (tempsector && tempsector != actor->sector())
 		ChangeActorSect(actor, tempsector);
+	else
+		HashRelink(actor);
 }
 
 void SetActorZ(DCoreActor* actor, const DVector3& newpos)
@@ -514,9 +733,42 @@ void SetActorZ(DCoreActor* actor, const DVector3& newpos)
 
 	if (tempsector && tempsector != actor->sector())
 		ChangeActorSect(actor, tempsector);
+	else
+		HashRelink(actor);
 }
 
 
+//==========================================================================
+//
+// Measures how long walking all stat lists and touching the actors takes.
+//
+//==========================================================================
+
+CCMD(statlistbench)
+{
+	int passes = argv.argc() > 1 ? max(1, atoi(argv[1])) : 100;
+	int count = 0;
+	double sum = 0;
+	cycle_t clock;
+	clock.ResetAndClock();
+	for (int i = 0; i < passes; i++)
+	{
+		for (auto& stat : statList)
+		{
+			for (auto actor = stat.firstEntry; actor; actor = actor->nextStat)
+			{
+				sum += actor->spr.pos.X + actor->spr.pos.Y;
+				count++;
+			}
+		}
+	}
+	clock.Unclock();
+	static volatile double sink;
+	sink = sum;	// keeps the loop from being optimized out.
+	if (count == 0) Printf("No actors\n");
+	else Printf("%d actors, %.2fms per pass, %.2fns per actor\n", count / passes, clock.TimeMS() / passes, clock.TimeMS() * 1000000. / count);
+}
+
 IMPLEMENT_CLASS(DCoreActor, false, false)
 
 size_t DCoreActor::PropagateMark()
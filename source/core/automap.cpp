@@ -388,25 +388,27 @@ bool ShowRedLine(int j, int i)
 //
 //---------------------------------------------------------------------------
 
+static bool ShowTwoSidedLine(walltype& wal, int sect)
+{
+	if (!wal.twoSided()) return false;
+
+	auto osec = wal.nextSector();
+
+	if (osec->ceilingz == sector[sect].ceilingz && osec->floorz == sector[sect].floorz)
+		if (((wal.cstat | wal.nextWall()->cstat) & (CSTAT_WALL_MASKED | CSTAT_WALL_1WAY)) == 0) return false;
+
+	return ShowRedLine(wallindex(&wal), sect);
+}
+
 static void drawredlines(const DVector2& cpos, const DVector2& cangvect, const DVector2& xydim)
 {
 	for (unsigned i = 0; i < sector.Size(); i++)
 	{
 		if (!gFullMap && !show2dsector[i]) continue;
 
-		double z1 = sector[i].ceilingz;
-		double z2 = sector[i].floorz;
-
 		for (auto& wal : sector[i].walls)
 		{
-			if (!wal.twoSided()) continue;
-
-			auto osec = wal.nextSector();
-
-			if (osec->ceilingz == z1 && osec->floorz == z2)
-				if (((wal.cstat | wal.nextWall()->cstat) & (CSTAT_WALL_MASKED | CSTAT_WALL_1WAY)) == 0) continue;
-
-			if (ShowRedLine(wallindex(&wal), i))
+			if (ShowTwoSidedLine(wal, i))
 			{
 				auto v1 = OutAutomapVector(wal.pos - cpos, cangvect, gZoom, xydim);
 				auto v2 = OutAutomapVector(wal.point2Wall()->pos - cpos, cangvect, gZoom, xydim);
@@ -422,6 +424,14 @@ static void drawredlines(const DVector2& cpos, const DVector2& cangvect, const D
 //
 //---------------------------------------------------------------------------
 
+static bool ShowOneSidedLine(walltype& wal)
+{
+	if (wal.nextwall >= 0) return false;
+	if (!gFullMap && !wal.walltexture.isValid()) return false;
+	if (isSWALL() && !gFullMap && !show2dwall[wallindex(&wal)]) return false;
+	return true;
+}
+
 static void drawwhitelines(const DVector2& cpos, const DVector2& cangvect, const DVector2& xydim)
 {
 	for (int i = (int)sector.Size() - 1; i >= 0; i--)
@@ -430,11 +440,7 @@ static void drawwhitelines(const DVector2& cpos, const DVector2& cangvect, const
 
 		for (auto& wal : sector[i].walls)
 		{
-			if (wal.nextwall >= 0) continue;
-			if (!gFullMap && !wal.walltexture.isValid()) continue;
-
-			if (isSWALL() && !gFullMap && !show2dwall[wallindex(&wal)])
-				continue;
+			if (!ShowOneSidedLine(wal)) continue;
 
 			auto v1 = OutAutomapVector(wal.pos - cpos, cangvect, gZoom, xydim);
 			auto v2 = OutAutomapVector(wal.point2Wall()->pos - cpos, cangvect, gZoom, xydim);
@@ -443,6 +449,107 @@ static void drawwhitelines(const DVector2& cpos, const DVector2& cangvect, const
 	}
 }
 
+//---------------------------------------------------------------------------
+//
+// For single pixel lines all walls are kept in a vertex buffer in map space,
+// once in the two sided and once in the one sided color. Each frame only
+// has to pick the lines to show and pass the view as a transform. Nothing
+// gets uploaded unless the visible set, a wall position or a color changes.
+//
+//---------------------------------------------------------------------------
+
+static struct
+{
+	RefCountedPtr<DShape2DBufferInfo> bufferInfo;
+	TArray<F2DDrawer::TwoDVertex> vertices;
+	TArray<int> indices;
+	TArray<int> newindices;
+	PalEntry redcolor, whitecolor;
+} mapLines;
+
+static void UpdateMapLineVertices()
+{
+	const unsigned numwalls = wall.Size();
+	uint8_t alpha = uint8_t(am_linealpha * 255);
+	PalEntry red = RedLineColor(), white = WhiteLineColor();
+	red.a = white.a = alpha;
+
+	bool recolor = mapLines.vertices.Size() != numwalls * 2 || red != mapLines.redcolor || white != mapLines.whitecolor;
+	if (recolor)
+	{
+		mapLines.vertices.Resize(numwalls * 2);
+		mapLines.redcolor = red;
+		mapLines.whitecolor = white;
+		mapLines.bufferInfo->needsVertexUpload = true;
+	}
+
+	// Some sector effects move walls around so the positions need to be checked every frame.
+	auto verts = mapLines.vertices.Data();
+	for (unsigned i = 0; i < numwalls; i++)
+	{
+		float x = (float)wall[i].pos.X, y = (float)wall[i].pos.Y;
+		if (recolor || verts[i].x != x || verts[i].y != y)
+		{
+			verts[i].Set(x, y, 0, 0, 0, red);
+			verts[i + numwalls].Set(x, y, 0, 0, 0, white);
+			mapLines.bufferInfo->needsVertexUpload = true;
+		}
+	}
+}
+
+static void drawmaplines(const DVector2& cpos, const DVector2& cangvect, const DVector2& xydim)
+{
+	if (mapLines.bufferInfo == nullptr) mapLines.bufferInfo = new DShape2DBufferInfo;
+	UpdateMapLineVertices();
+
+	const int numwalls = wall.Size();
+	auto& indices = mapLines.newindices;
+	indices.Clear();
+
+	for (unsigned i = 0; i < sector.Size(); i++)
+	{
+		if (!gFullMap && !show2dsector[i]) continue;
+
+		for (auto& wal : sector[i].walls)
+		{
+			if (ShowTwoSidedLine(wal, i))
+			{
+				indices.Push(wallindex(&wal));
+				indices.Push(wal.point2);
+			}
+		}
+	}
+	for (int i = (int)sector.Size() - 1; i >= 0; i--)
+	{
+		if (!gFullMap && !show2dsector[i] && !isSWALL()) continue;
+
+		for (auto& wal : sector[i].walls)
+		{
+			if (ShowOneSidedLine(wal))
+			{
+				indices.Push(wallindex(&wal) + numwalls);
+				indices.Push(wal.point2 + numwalls);
+			}
+		}
+	}
+
+	if (indices.Size() != mapLines.indices.Size() || memcmp(indices.Data(), mapLines.indices.Data(), indices.Size() * sizeof(int)))
+	{
+		std::swap(mapLines.indices, mapLines.newindices);
+		mapLines.bufferInfo->needsVertexUpload = true;
+	}
+
+	// Same as OutAutomapVector.
+	const double xx = -gZoom * cangvect.Y, xy = gZoom * cangvect.X;
+	const double yx = -gZoom * cangvect.X, yy = -gZoom * cangvect.Y;
+	DMatrix3x3 transform(
+		DVector3(xx, xy, xydim.X - xx * cpos.X - xy * cpos.Y),
+		DVector3(yx, yy, xydim.Y - yx * cpos.X - yy * cpos.Y),
+		DVector3(0, 0, 1));
+
+	twod->AddLineBuffer(mapLines.bufferInfo, mapLines.vertices, mapLines.indices, transform, &viewport3d);
+}
+
 //---------------------------------------------------------------------------
 //
 // player sprite fallback
@@ -611,8 +718,15 @@ void DrawOverheadMap(const DVector2& plxy, const DAngle pl_angle, double const i
 		renderDrawMapView(follow, avect, xydim);
 	}
 
-	drawredlines(follow, avect, xydim);
-	drawwhitelines(follow, avect, xydim);
+	if (am_linethickness <= 1)
+	{
+		drawmaplines(follow, avect, xydim);
+	}
+	else
+	{
+		drawredlines(follow, avect, xydim);
+		drawwhitelines(follow, avect, xydim);
+	}
 	if (!gi->DrawAutomapPlayer(plxy, follow, follow_a, xydim, gZoom, interpfrac))
 		DrawPlayerArrow(follow, follow_a, gZoom, pl_angle);
 
@@ -36,6 +36,9 @@ public:
 	sectortype* link_sector;
 	DCoreActor* prevStat, * nextStat;
 	DCoreActor* prevSect, * nextSect;
+	DCoreActor* prevHash = nullptr, * nextHash = nullptr;	// links in the spatial hash. Not serialized, the hash gets rebuilt on demand.
+	int hashCell = -1;
+	int linkseq = 0;	// increases along each stat list, so that spatial queries can return their results in list order.
 	FWallSpriteInfo* wallspriteinfo; // this is render data but needs to be attached to the actor so it can be found.
 
 	spritetype spr;
@@ -470,10 +473,62 @@ public:
 
 using CoreSectIterator = TSectIterator<DCoreActor>;
 
+int CollectActorsInRadius(TArray<DCoreActor*>& list, const DVector2& center, double radius, int statnum, int minseq);
+
+// Returns the actors in a stat list whose position is within a 2D radius
+// around a point, using the spatial hash instead of walking the entire list.
+// The result is a superset of what a 3D distance check would accept, in stat
+// list order. Like TStatIterator it also returns actors that get added to the
+// end of the list during the iteration, by querying again for them once
+// everything else has been returned. Destroyed actors and those that left
+// the stat list are skipped.
+//
+// Positions are only tracked exactly for actors moved with SetActor or
+// ChangeActorSect since the hash was last rebuilt, which happens once per
+// tic. Actors whose spr.pos got written directly are only found if they
+// did not move more than one hash cell (128 map units) away from their
+// last tracked position.
+template<class TActor>
+class TRadiusIterator
+{
+	TArray<DCoreActor*> list;
+	DVector2 center;
+	double radius;
+	int statnum;
+	int nextseq;
+	unsigned index = 0;
+
+public:
+	TRadiusIterator(const DVector2& center, double radius, int statnum)
+		: center(center), radius(radius), statnum(statnum)
+	{
+		nextseq = CollectActorsInRadius(list, center, radius, statnum, INT_MIN);
+	}
+
+	TActor* Next()
+	{
+		while (true)
+		{
+			while (index < list.Size())
+			{
+				auto ac = list[index++];
+				if (!(ac->ObjectFlags & OF_EuthanizeMe) && ac->spr.statnum == statnum) return static_cast<TActor*>(ac);
+			}
+			// Look for actors that were appended to the list in the meantime.
+			list.Clear();
+			index = 0;
+			nextseq = CollectActorsInRadius(list, center, radius, statnum, nextseq);
+			if (list.Size() == 0) return nullptr;
+		}
+	}
+};
+
 DCoreActor* InsertActor(PClass* type, sectortype* sector, int stat, bool forcetail = false);
 void ChangeActorSect(DCoreActor* actor, sectortype* sector, bool forcetail = false);
 int ChangeActorStat(DCoreActor* actor, int nStatus, bool forcetail = false);
 void InitSpriteLists();
+void InvalidateActorHash();
+void ResetActorHash();
 
 
 void SetActorZ(DCoreActor* actor, const DVector3& newpos);
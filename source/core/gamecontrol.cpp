@@ -247,11 +247,6 @@ static bool System_CaptureModeInGame()
 	return true;
 }
 
-static bool System_DisableTextureFilter()
-{
-	return  hw_useindexedcolortextures;
-}
-
 static IntRect System_GetSceneRect()
 {
 	int viewbottom = viewport3d.Bottom();
@@ -588,7 +583,7 @@ int GameMain()
 		nullptr,
 		nullptr,
 		nullptr,
-		System_DisableTextureFilter,
+		nullptr,
 		nullptr,
 		System_GetSceneRect,
 		nullptr,
@@ -1408,6 +1403,7 @@ void GameInterface::FreeLevelData()
 	wall.Reset();
 	currentLevel = nullptr;
 	GC::FullGC();
+	ObjectPool::Compact();
 }
 
 //---------------------------------------------------------------------------
@@ -92,6 +92,7 @@
 #include "texinfo.h"
 #include "texturemanager.h"
 #include "gameinput.h"
+#include "tracing.h"
 
 CVAR(Bool, vid_activeinbackground, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 CVAR(Bool, r_ticstability, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
@@ -350,7 +351,11 @@ static void GameTicker()
 	case GS_LEVEL:
 		gameupdatetime.Reset();
 		gameupdatetime.Clock();
-		gi->Ticker();
+		InvalidateActorHash();
+		{
+			TRACE_ZONE("GameTicker");
+			gi->Ticker();
+		}
 		TickStatusBar();
 		levelTextTime--;
 		gameupdatetime.Unclock();
@@ -396,6 +401,7 @@ CVAR(String, drawtile, "", 0)	// debug stuff. Draws the tile with the given numb
 
 void Display()
 {
+	TRACE_ZONE("Display");
 	if (screen == nullptr || (!AppActive && (screen->IsFullscreen() || !vid_activeinbackground)))
 	{
 		return;
@@ -725,6 +731,7 @@ void MainLoop ()
 		}
 	}
 
+	Trace::SetThreadName("Main thread");
 	for (;;)
 	{
 		try
@@ -746,6 +753,7 @@ void MainLoop ()
 
 			Display();
 			Mus_UpdateMusic();		// must be at the end.
+			Trace::EndFrame();
 		}
 		catch (CRecoverableError &error)
 		{
@@ -47,6 +47,7 @@
 #include "render.h"
 #include "hw_sections.h"
 #include "interpolate.h"
+#include "walltags.h"
 #include "tiletexture.h"
 #include "games/blood/src/mapstructs.h"
 #include "buildtiles.h"
@@ -424,6 +425,7 @@ void allocateMapArrays(int numwall, int numsector, int numsprites)
 	memset(sector.Data(), 0, sizeof(sectortype) * numsector);
 	wall.Resize(numwall);
 	memset(wall.Data(), 0, sizeof(walltype) * wall.Size());
+	clearWallTagIndex();
 
 	ClearAutomap();
 }
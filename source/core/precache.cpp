@@ -46,12 +46,31 @@
 #include "models/modeldata.h"
 #include "gamefuncs.h"
 #include "texinfo.h"
+#include "image.h"
 
 #include "buildtiles.h"
 
-static void PrecacheTex(FGameTexture* tex, int palid)
+struct PrecacheItem
+{
+	FGameTexture* tex;
+	int palid;
+};
+
+static TArray<PrecacheItem> precacheList;
+
+// limits how much memory the images decoded ahead of time may occupy.
+static const size_t PREDECODE_BATCH = 256 << 20;
+
+static FGameTexture* HiresReplacement(FGameTexture* tex, int palid, int& translation)
+{
+	TexturePick pick;
+	if (!hw_hightile || !PickTexture(tex, palid, pick) || pick.texture == tex) return nullptr;
+	translation = pick.translation & 0x7fffffff;
+	return pick.texture;
+}
+
+static void PrecacheMaterial(FGameTexture* tex, int palid)
 {
-	if (!tex || !tex->isValid()) return;
 	int scaleflags = 0;
 	if (shouldUpscale(tex, UF_Texture)) scaleflags |= CTF_Upscale;
 
@@ -59,13 +78,67 @@ static void PrecacheTex(FGameTexture* tex, int palid)
 	screen->PrecacheMaterial(mat, palid);
 }
 
+static void PrecacheTex(FGameTexture* tex, int palid)
+{
+	if (!tex || !tex->isValid()) return;
+	PrecacheMaterial(tex, palid);
+
+	int translation;
+	auto hires = HiresReplacement(tex, palid, translation);
+	if (hires && hires->isValid()) PrecacheMaterial(hires, translation);
+}
+
+//==========================================================================
+//
+// Returns the image of a hires replacement that still needs to be loaded
+// so that it can be decoded on a worker thread.
+//
+//==========================================================================
+
+static FImageSource* PredecodeImage(FGameTexture* tex, int palid)
+{
+	int translation;
+	if (!tex || !tex->isValid()) return nullptr;
+	auto hires = HiresReplacement(tex, palid, translation);
+	if (!hires || !hires->isValid() || translation != 0 || shouldUpscale(hires, UF_Texture)) return nullptr;
+	auto systex = hires->GetTexture();
+	if (systex->SystemTextures.GetHardwareTexture(0, 0)) return nullptr;
+	return systex->GetImage();
+}
+
+static void PrecacheList()
+{
+	FImageSource::BeginPrecaching();
+	for (unsigned start = 0; start < precacheList.Size(); )
+	{
+		TArray<FImageSource*> images;
+		size_t batchsize = 0;
+		unsigned end = start;
+		for (; end < precacheList.Size() && batchsize < PREDECODE_BATCH; end++)
+		{
+			auto img = PredecodeImage(precacheList[end].tex, precacheList[end].palid);
+			if (!img) continue;
+			images.Push(img);
+			batchsize += size_t(img->GetWidth()) * img->GetHeight() * 4;
+		}
+		FImageSource::PredecodeImages(images);
+
+		for (; start < end; start++)
+		{
+			PrecacheTex(precacheList[start].tex, precacheList[start].palid);
+		}
+	}
+	FImageSource::EndPrecaching();
+	precacheList.Clear();
+}
+
 static void doprecache(FTextureID texid, int palette)
 {
    if ((palette < (MAXPALOOKUPS - RESERVEDPALS)) && (!lookups.checkTable(palette))) return;
 
     int palid = TRANSLATION(Translation_Remap + curbasepal, palette);
 	auto tex = TexMan.GetGameTexture(texid);
-    PrecacheTex(tex, palid);
+	if (tex && tex->isValid()) precacheList.Push({ tex, palid });
 
 	int const mid = -1;// hw_models ? modelManager.CheckModel(texid, palette) : -1;
 
@@ -152,9 +225,10 @@ void precacheMarkedTiles()
 	while (it2.NextPair(pair2))
 	{
 		auto tex = TexMan.FindGameTexture(pair2->Key, ETextureType::Any);
-		if (tex) PrecacheTex(tex, 0);
+		if (tex && tex->isValid()) precacheList.Push({ tex, 0 });
 	}
 
+	PrecacheList();
 	cachemap.Clear();
 }
 
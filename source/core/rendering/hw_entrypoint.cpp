@@ -61,10 +61,7 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state);
 
 CVARD(Bool, hw_hightile, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "enable/disable hightile texture rendering")
 bool hw_int_useindexedcolortextures;
-CUSTOM_CVARD(Bool, hw_useindexedcolortextures, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "enable/disable indexed color texture rendering")
-{
-	if (screen) screen->SetTextureFilterMode();
-}
+CVARD(Bool, hw_useindexedcolortextures, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "enable/disable indexed color texture rendering")
 CVARD(Bool, hw_models, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "enable/disable model rendering")
 
 
@@ -128,7 +125,7 @@ void RenderViewpoint(FRenderViewpoint& mainvp, IntRect* bounds, float fov, float
 	auto vrmode = VRMode::GetVRMode(mainview && toscreen);
 	const int eyeCount = vrmode->mEyeCount;
 	screen->FirstEye();
-	hw_int_useindexedcolortextures = eyeCount > 1? false : *hw_useindexedcolortextures;
+	hw_int_useindexedcolortextures = eyeCount > 1 || (screen->hwcaps & RFL_NO_INDEXED_TEXTURES)? false : *hw_useindexedcolortextures;
 
 	for (int eye_ix = 0; eye_ix < eyeCount; ++eye_ix)
 	{
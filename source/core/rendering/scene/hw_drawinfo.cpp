@@ -37,12 +37,14 @@
 #include "hw_lightbuffer.h"
 #include "hw_vrmodes.h"
 #include "hw_clipper.h"
+#include "hw_spritepass.h"
 #include "v_draw.h"
 #include "gamecvars.h"
 #include "gamestruct.h"
 #include "automap.h"
 #include "hw_voxels.h"
 #include "coreactor.h"
+#include "tracing.h"
 #include "tiletexture.h"
 
 #include "buildtiles.h"
@@ -276,6 +278,7 @@ HWPortal * HWDrawInfo::FindPortal(const void * src)
 
 void HWDrawInfo::DispatchSprites()
 {
+	TRACE_ZONE("DispatchSprites");
 	for (unsigned i = 0; i < tsprites.Size(); i++)
 	{
 		auto tspr = tsprites.get(i);
@@ -362,6 +365,7 @@ void HWDrawInfo::DispatchSprites()
 
 void HWDrawInfo::CreateScene(bool portal)
 {
+	TRACE_ZONE("CreateScene");
 	const auto& vp = Viewpoint;
 
 	angle_t a1 = FrustumAngle();
@@ -390,7 +394,9 @@ void HWDrawInfo::CreateScene(bool portal)
 
 	SetupSprite.Clock();
 	// vp is in render space, so we must convert back.
+	ProcessSpritesTime.Clock();
 	gi->processSprites(tsprites, DVector3(vp.Pos.X, -vp.Pos.Y, -vp.Pos.Z), DAngle::fromBam(vp.RotAngle), vp.TicFrac);
+	ProcessSpritesTime.Unclock();
 	DispatchSprites();
 	SetupSprite.Unclock();
 
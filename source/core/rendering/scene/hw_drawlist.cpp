@@ -31,6 +31,7 @@
 #include "hw_clock.h"
 #include "hw_renderstate.h"
 #include "hw_drawinfo.h"
+#include "tracing.h"
 
 #define MIN_EQ (0.0005f)
 
@@ -810,6 +811,7 @@ SortNode * HWDrawList::DoSort(HWDrawInfo *di, SortNode * head)
 //==========================================================================
 void HWDrawList::Sort(HWDrawInfo *di)
 {
+	TRACE_ZONE("HWDrawList::Sort");
 	reverseSort = false;
 	SortZ = di->Viewpoint.Pos.Z;
 	MakeSortList();
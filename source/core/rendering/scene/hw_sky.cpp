@@ -52,6 +52,7 @@ void initSkyInfo(HWDrawInfo *di, HWSkyInfo* sky, sectortype* sector, int plane)
 
 	FGameTexture* skytex = SkyboxReplacement(texid, palette);
 	int realskybits = 0;
+	int translation = 0;
 	// todo: check for skybox replacement.
 	SkyDefinition skydef;
 	if (!skytex)
@@ -62,8 +63,17 @@ void initSkyInfo(HWDrawInfo *di, HWSkyInfo* sky, sectortype* sector, int plane)
 
 		skytex = GetSkyTexture(texid, skydef.lognumtiles, skydef.offsets, remap);
 		realskybits = skydef.lognumtiles;
-		if (skytex) skydef.lognumtiles = 0;
-		else skytex = tex;
+		// The composited sky already has the palette remap baked into its pixels so for indexed rendering it only needs the base palette.
+		if (skytex)
+		{
+			skydef.lognumtiles = 0;
+			translation = TRANSLATION(Translation_Remap + curbasepal, 0);
+		}
+		else
+		{
+			skytex = tex;
+			translation = remap;
+		}
 	}
 	else
 	{
@@ -92,6 +102,7 @@ void initSkyInfo(HWDrawInfo *di, HWSkyInfo* sky, sectortype* sector, int plane)
 
 	sky->fadecolor = pe;
 	sky->shade = 0;// clamp(plane == plane_ceiling ? sector->ceilingshade : sector->floorshade, 0, numshades - 1);
+	sky->translation = translation;
 	sky->texture = skytex;
 }
 
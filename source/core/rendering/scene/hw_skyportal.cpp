@@ -36,22 +36,35 @@ CVAR(Float, skyoffsettest, 0.f, 0)
 void HWSkyPortal::DrawContents(HWDrawInfo *di, FRenderState &state)
 {
 	int indexed = hw_int_useindexedcolortextures;
-	hw_int_useindexedcolortextures = false; // this code does not work with indexed textures.
+	auto skybox = origin->texture ? dynamic_cast<FSkyBox*>(origin->texture->GetTexture()) : nullptr;
+	if (skybox) hw_int_useindexedcolortextures = false; // skybox faces are true color images.
 
-	state.SetNoSoftLightLevel();
+	PalEntry color;
+	int translation = 0;
+	if (hw_int_useindexedcolortextures)
+	{
+		// The palette shader does the shading itself, so pass the shade as light level and disable the distance fade.
+		state.SetSoftLightLevel(max(0, 255 - Scale(origin->shade, 255, numshades)));
+		state.SetLightParms(0.f, 0.f);
+		color = 0xffffffff;
+		translation = origin->translation;
+	}
+	else
+	{
+		state.SetNoSoftLightLevel();
+		color = shadeToLight(origin->shade);
+	}
 
 	state.ResetColor();
 	state.EnableFog(false);
 	state.AlphaFunc(Alpha_GEqual, 0.f);
 	state.SetRenderStyle(STYLE_Translucent);
 	bool oldClamp = state.SetDepthClamp(true);
-	auto color = shadeToLight(origin->shade);
 
 	di->SetupView(state, 0, 0, 0, !!(mState->MirrorFlag & 1), !!(mState->PlaneMirrorFlag & 1));
 
 	state.SetVertexBuffer(vertexBuffer);
 	state.SetTextureMode(TM_OPAQUE);
-	auto skybox = origin->texture ? dynamic_cast<FSkyBox*>(origin->texture->GetTexture()) : nullptr;
 	if (skybox)
 	{
 		vertexBuffer->RenderBox(state, skybox, origin->x_offset, false, /*di->Level->info->pixelstretch*/1, { 0, 0, 1 }, { 0, 0, 1 }, color);
@@ -78,12 +91,12 @@ void HWSkyPortal::DrawContents(HWDrawInfo *di, FRenderState &state)
 		textureMatrix.loadIdentity();
 		state.EnableTextureMatrix(true);
 		textureMatrix.scale(1.f, repeat_fac, 1.f);
-		vertexBuffer->DoRenderDome(state, origin->texture, FSkyVertexBuffer::SKYMODE_MAINLAYER, true, color);
+		vertexBuffer->DoRenderDome(state, origin->texture, FSkyVertexBuffer::SKYMODE_MAINLAYER, true, color, translation);
 		state.EnableTextureMatrix(false);
 	}
 	else
 	{
-		vertexBuffer->RenderDome(state, origin->texture, -origin->x_offset, origin->y_offset, false, FSkyVertexBuffer::SKYMODE_MAINLAYER, true, 0, 0, color);
+		vertexBuffer->RenderDome(state, origin->texture, -origin->x_offset, origin->y_offset, false, FSkyVertexBuffer::SKYMODE_MAINLAYER, true, 0, 0, color, translation);
 	}
 	state.SetTextureMode(TM_NORMAL);
 	if (origin->fadecolor & 0xffffff)
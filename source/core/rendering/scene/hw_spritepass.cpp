@@ -0,0 +1,154 @@
+/*
+** hw_spritepass.cpp
+** Runs the per-tsprite part of sprite animation on worker threads
+**
+**---------------------------------------------------------------------------
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The pass callback gets called with every index exactly once, but in no
+** particular order. Script functions it calls must have passed
+** VMCheckThreadSafe before, which also ensures they are already compiled.
+**
+*/
+
+#include <atomic>
+#include <mutex>
+#include "hw_spritepass.h"
+#include "c_cvars.h"
+#include "v_text.h"
+#include "r_thread.h"
+#include "r_memory.h"
+#include "vm.h"
+
+CVAR(Bool, r_parallelsprites, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+cycle_t ProcessSpritesTime;
+static unsigned SpritePassCount;
+static unsigned SpritePassThreaded;
+
+// Handing out single sprites would mostly measure the atomic counter.
+enum { SpritePassBatch = 16, SpritePassMinimum = 64 };
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+struct FSpritePassJob
+{
+	const std::function<void(unsigned)>* Pass = nullptr;
+	unsigned Count = 0;
+
+	std::atomic<unsigned> Next = { 0 };
+	std::mutex ErrorMutex;
+	std::exception_ptr Error;
+};
+
+class FSpritePassCommand : public DrawerCommand
+{
+public:
+	FSpritePassCommand(FSpritePassJob* job) : job(job) { }
+
+	void Execute(DrawerThread* thread) override
+	{
+		try
+		{
+			VMReserveFrameStack(16384);
+			while (true)
+			{
+				unsigned start = job->Next.fetch_add(SpritePassBatch);
+				if (start >= job->Count)
+					break;
+
+				unsigned end = std::min(start + SpritePassBatch, job->Count);
+				for (unsigned i = start; i < end; i++)
+					(*job->Pass)(i);
+			}
+		}
+		catch (...)
+		{
+			std::unique_lock<std::mutex> lock(job->ErrorMutex);
+			if (!job->Error)
+				job->Error = std::current_exception();
+		}
+	}
+
+private:
+	FSpritePassJob* job;
+};
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void RunSpritePass(unsigned count, const std::function<void(unsigned)>& pass)
+{
+	SpritePassCount += count;
+	if (!r_parallelsprites || count < SpritePassMinimum)
+	{
+		for (unsigned i = 0; i < count; i++)
+			pass(i);
+		return;
+	}
+
+	static RenderMemory memory;
+
+	FSpritePassJob job;
+	job.Pass = &pass;
+	job.Count = count;
+
+	auto queue = std::make_shared<DrawerCommandQueue>(&memory);
+	queue->Push<FSpritePassCommand>(&job);
+	DrawerThreads::Execute(queue);
+	DrawerThreads::WaitForWorkers();
+	memory.Clear();
+	SpritePassThreaded += count;
+
+	if (job.Error)
+		std::rethrow_exception(job.Error);
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+ADD_STAT(spritepass)
+{
+	FString out;
+	out.Format("processSprites: %2.3f ms, %u tsprites in pass, %u threaded%s", ProcessSpritesTime.TimeMS(), SpritePassCount, SpritePassThreaded,
+		r_parallelsprites ? "" : " (r_parallelsprites off)");
+	ProcessSpritesTime.Reset();
+	SpritePassCount = SpritePassThreaded = 0;
+	return out;
+}
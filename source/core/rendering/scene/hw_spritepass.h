@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include "stats.h"
+
+//==========================================================================
+//
+// Per-tsprite pass of a game's processSprites.
+//
+// Games whose sprite animation has a part that only ever modifies the
+// tsprite it is working on can hand that part to RunSpritePass. With
+// r_parallelsprites it gets spread across the drawer threads, everything
+// that adds tsprites or touches shared state must stay in the serial part
+// that follows.
+//
+//==========================================================================
+
+void RunSpritePass(unsigned count, const std::function<void(unsigned)>& pass);
+
+extern cycle_t ProcessSpritesTime;
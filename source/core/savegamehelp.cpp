@@ -64,6 +64,7 @@
 #include "serialize_obj.h"
 #include "games/blood/src/mapstructs.h"
 #include "texinfo.h"
+#include "walltags.h"
 #include <zlib.h>
 
 #include "buildtiles.h"
@@ -656,7 +657,9 @@ void SerializeMap(FSerializer& arc)
 	if (arc.isReading())
 	{
 		setWallSectors();
+		clearWallTagIndex();
 		hw_CreateSections();
+		ResetActorHash();
 		sectionGeometry.SetSize(sections.Size());
 	}
 }
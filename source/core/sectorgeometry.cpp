@@ -396,6 +396,59 @@ bool SectionGeometry::ValidateSection(Section* section, int plane)
 }
 
 
+//==========================================================================
+//
+// Sector objects in Shadow Warrior and similar constructs move all walls
+// of their sectors by the same rotation and translation each tic. In that
+// case the triangulation is still valid, so instead of redoing it the mesh
+// from the last triangulation gets transformed the same way as its outline.
+// The transform is always applied to the original mesh so that rounding
+// errors cannot accumulate.
+//
+//==========================================================================
+
+static bool TransformMesh(SectionGeometryData& sdata, const FOutline& outline, int count)
+{
+	if (count < 2 || sdata.refOutline.Size() != (unsigned)count) return false;
+
+	TArray<FVector2>& ref = sdata.refOutline;
+	FVector2 cur0(outline[0][0].first, outline[0][0].second);
+	FVector2 cur1(outline[0][1].first, outline[0][1].second);
+	FVector2 refdir = ref[1] - ref[0];
+	FVector2 curdir = cur1 - cur0;
+	float lensq = refdir.LengthSquared();
+	if (lensq == 0) return false;
+
+	// rotation that maps the reference's first edge onto the current one.
+	float cosa = (refdir.X * curdir.X + refdir.Y * curdir.Y) / lensq;
+	float sina = (refdir.X * curdir.Y - refdir.Y * curdir.X) / lensq;
+	if (fabs(cosa * cosa + sina * sina - 1.f) > 0.001f) return false;	// the edge changed its length.
+
+	auto transform = [&](const FVector2& v) -> FVector2
+	{
+		FVector2 d = v - ref[0];
+		return { cur0.X + d.X * cosa - d.Y * sina, cur0.Y + d.X * sina + d.Y * cosa };
+	};
+
+	const float maxdev = 1 / 16.f;
+	int p = 0;
+	for (auto& loop : outline)
+	{
+		for (auto& pt : loop)
+		{
+			FVector2 t = transform(ref[p++]);
+			if (fabs(t.X - pt.first) > maxdev || fabs(t.Y - pt.second) > maxdev) return false;
+		}
+	}
+
+	sdata.meshVertices.Resize(sdata.refVertices.Size());
+	for (unsigned i = 0; i < sdata.refVertices.Size(); i++)
+	{
+		sdata.meshVertices[i] = transform(sdata.refVertices[i]);
+	}
+	return true;
+}
+
 //==========================================================================
 //
 //
@@ -414,14 +467,34 @@ bool SectionGeometry::CreateMesh(Section* section)
 
 	auto& sdata = data[section->index];
 
-	if (!(section->flags & NoEarcut))
+	if (TransformMesh(sdata, foutline, count))
 	{
-		result = TriangulateOutlineEarcut(foutline, count, sdata.meshVertices, sdata.meshIndices);
+		result = ETriangulateResult::Ok;
 	}
-	if (result == ETriangulateResult::Failed && !(section->geomflags & NoLibtess))
+	else
 	{
-		section->geomflags |= NoEarcut;
-		result = TriangulateOutlineLibtess(foutline, count, sdata.meshVertices, sdata.meshIndices);
+		if (!(section->flags & NoEarcut))
+		{
+			result = TriangulateOutlineEarcut(foutline, count, sdata.meshVertices, sdata.meshIndices);
+		}
+		if (result == ETriangulateResult::Failed && !(section->geomflags & NoLibtess))
+		{
+			section->geomflags |= NoEarcut;
+			result = TriangulateOutlineLibtess(foutline, count, sdata.meshVertices, sdata.meshIndices);
+		}
+
+		sdata.refOutline.Clear();
+		sdata.refVertices.Clear();
+		if (result == ETriangulateResult::Ok)
+		{
+			sdata.refOutline.Resize(count);
+			int p = 0;
+			for (auto& loop : foutline)
+			{
+				for (auto& pt : loop) sdata.refOutline[p++] = { pt.first, pt.second };
+			}
+			sdata.refVertices = sdata.meshVertices;
+		}
 	}
 
 	sdata.planes[0].vertices.Clear();
@@ -57,6 +57,8 @@ struct SectionGeometryData
 	SectorGeometryPlane planes[2];
 	TArray<FVector2> meshVertices;	// flat vertices. Stored separately so that plane changes won't require completely new triangulation.
 	TArray<int> meshIndices;
+	TArray<FVector2> refOutline;	// outline and mesh vertices at the time of the last triangulation.
+	TArray<FVector2> refVertices;	// If a sector only gets moved as a whole, the mesh can be moved along with it.
 	sectortypelight compare[2] = {};
 	DVector2 poscompare[2] = {};
 	DVector2 poscompare2[2] = {};
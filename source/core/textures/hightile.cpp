@@ -50,6 +50,8 @@
 #include "hw_renderstate.h"
 #include "skyboxtexture.h"
 #include "gamefuncs.h"
+#include "v_video.h"
+#include "stats.h"
 
 enum ETexType
 {
@@ -75,6 +77,25 @@ static TMap<int, TArray<HightileReplacement>> textureReplacements;
 
 static TMap<FGameTexture*, FGameTexture*> deferredChars;
 
+// Per frame cache of PickTexture's results.
+struct PickCacheEntry
+{
+	FGameTexture* tex;
+	int paletteid;
+	int frame;
+	bool wantindexed;
+	bool result;
+	TexturePick pick;
+};
+
+static PickCacheEntry pickCache[1024];
+static bool pickCacheEnabled = true;	// only for benchmarking.
+
+static void ClearPickCache()
+{
+	memset(pickCache, 0, sizeof(pickCache));
+}
+
 FGameTexture* GetBaseForChar(FGameTexture* t)
 {
 	auto c = deferredChars.CheckKey(t);
@@ -120,6 +141,74 @@ void tileRemoveReplacement(int tilenum)
 	tileReplacements.Remove(tilenum);
 }
 
+//===========================================================================
+//
+// Flat lookup table for the replacements, keyed by texture, palette and
+// skybox flag. This gets checked for every wall, flat and sprite being
+// drawn, so it should not have to search a list per texture.
+// Must be rebuilt whenever textureReplacements changes.
+//
+//===========================================================================
+
+struct ReplacementSlot
+{
+	uint64_t key;
+	HightileReplacement* rep;
+};
+
+static TArray<ReplacementSlot> replacementTable;
+static unsigned replacementMask;
+static const uint64_t EmptySlot = ~0ull;
+
+static inline uint64_t ReplacementKey(int texindex, int palnum, bool skybox)
+{
+	return (uint64_t(uint32_t(texindex)) << 17) | (uint64_t(palnum & 0xffff) << 1) | uint64_t(skybox);
+}
+
+static inline unsigned ReplacementHash(uint64_t key)
+{
+	return unsigned((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static void BuildReplacementTable()
+{
+	unsigned count = 0;
+	decltype(textureReplacements)::Iterator it(textureReplacements);
+	decltype(textureReplacements)::Pair* pair;
+	while (it.NextPair(pair)) count += pair->Value.Size();
+
+	// keep the load factor at 50% or less.
+	unsigned size = 16;
+	while (size < count * 2) size <<= 1;
+	replacementTable.Resize(size);
+	for (auto& slot : replacementTable) slot = { EmptySlot, nullptr };
+	replacementMask = size - 1;
+
+	decltype(textureReplacements)::Iterator it2(textureReplacements);
+	while (it2.NextPair(pair))
+	{
+		for (auto& rep : pair->Value)
+		{
+			uint64_t key = ReplacementKey(pair->Key, rep.palnum, rep.issky);
+			unsigned i = ReplacementHash(key) & replacementMask;
+			while (replacementTable[i].key != EmptySlot && replacementTable[i].key != key) i = (i + 1) & replacementMask;
+			// the first definition wins, just like with the linear search.
+			if (replacementTable[i].key == EmptySlot) replacementTable[i] = { key, &rep };
+		}
+	}
+}
+
+static HightileReplacement* LookupReplacement(int texindex, int palnum, bool skybox)
+{
+	uint64_t key = ReplacementKey(texindex, palnum, skybox);
+	for (unsigned i = ReplacementHash(key) & replacementMask;; i = (i + 1) & replacementMask)
+	{
+		auto& slot = replacementTable[i];
+		if (slot.key == key) return slot.rep;
+		if (slot.key == EmptySlot) return nullptr;
+	}
+}
+
 //===========================================================================
 //
 //
@@ -127,6 +216,15 @@ void tileRemoveReplacement(int tilenum)
 //===========================================================================
 
 static HightileReplacement* FindReplacement(FTextureID texid, int palnum, bool skybox)
+{
+	if (replacementTable.Size() == 0) return nullptr;
+	auto rep = LookupReplacement(texid.GetIndex(), palnum, skybox);
+	if (!rep && palnum && palnum < MAXPALOOKUPS - RESERVEDPALS) rep = LookupReplacement(texid.GetIndex(), 0, skybox);
+	return rep;
+}
+
+// The list based search the table replaced, only kept for 'hightilebench'.
+static HightileReplacement* FindReplacementLinear(FTextureID texid, int palnum, bool skybox)
 {
 	auto Hightiles = textureReplacements.CheckKey(texid.GetIndex());
 	if (!Hightiles) return nullptr;
@@ -243,6 +341,8 @@ void highTileSetup()
 			}
 		}
 	}
+	BuildReplacementTable();
+	ClearPickCache();
 }
 
 //==========================================================================
@@ -317,7 +417,7 @@ int tileSetSkybox(int tilenum, int palnum, FString* facenames, bool indexed)
 //
 //===========================================================================
 
-bool PickTexture(FGameTexture* tex, int paletteid, TexturePick& pick, bool wantindexed)
+static bool DoPickTexture(FGameTexture* tex, int paletteid, TexturePick& pick, bool wantindexed)
 {
 	if (!tex->isValid() || tex->GetTexelWidth() <= 0 || tex->GetTexelHeight() <= 0) return false;
 
@@ -393,6 +493,33 @@ bool PickTexture(FGameTexture* tex, int paletteid, TexturePick& pick, bool wanti
 	return true;
 }
 
+//===========================================================================
+// 
+//	The result only depends on the texture, the translation and the global
+//	palette state, which does not change during a frame, so it gets
+//	cached for the rest of the frame.
+//
+//===========================================================================
+
+bool PickTexture(FGameTexture* tex, int paletteid, TexturePick& pick, bool wantindexed)
+{
+	unsigned hash = unsigned(uintptr_t(tex) >> 4) ^ (unsigned(paletteid) * 0x9E3779B1u) ^ unsigned(wantindexed);
+	auto& entry = pickCache[(hash ^ (hash >> 16)) & (countof(pickCache) - 1)];
+	if (pickCacheEnabled && entry.tex == tex && entry.paletteid == paletteid && entry.wantindexed == wantindexed && entry.frame == FTexture::CurrentFrame)
+	{
+		pick = entry.pick;
+		return entry.result;
+	}
+	bool result = DoPickTexture(tex, paletteid, pick, wantindexed);
+	entry.tex = tex;
+	entry.paletteid = paletteid;
+	entry.frame = FTexture::CurrentFrame;
+	entry.wantindexed = wantindexed;
+	entry.result = result;
+	entry.pick = pick;
+	return result;
+}
+
 bool PreBindTexture(FRenderState* state, FGameTexture*& tex, EUpscaleFlags& flags, int& scaleflags, int& clampmode, int& translation, int& overrideshader)
 {
 	TexturePick pick;
@@ -447,3 +574,80 @@ bool PreBindTexture(FRenderState* state, FGameTexture*& tex, EUpscaleFlags& flag
 	return tex->GetTexelWidth() > t->GetTexelWidth() && tex->GetTexelHeight() > t->GetTexelHeight();	// returning 'true' means to disable programmatic upscaling.
 }
 
+//===========================================================================
+//
+// Measures the replacement lookups for all defined replacements:
+// list search vs. lookup table, and PreBindTexture with and without
+// the pick cache.
+//
+//===========================================================================
+
+CCMD(hightilebench)
+{
+	int count = argv.argc() > 1 ? max(1, (int)strtol(argv[1], nullptr, 0)) : 100;
+
+	struct Sample
+	{
+		FTextureID texid;
+		int palnum;
+	};
+	TArray<Sample> samples;
+	decltype(textureReplacements)::Iterator it(textureReplacements);
+	decltype(textureReplacements)::Pair* pair;
+	while (it.NextPair(pair))
+	{
+		for (auto& rep : pair->Value)
+		{
+			if (!rep.issky) samples.Push({ FSetTextureID(pair->Key), rep.palnum });
+		}
+	}
+	if (samples.Size() == 0)
+	{
+		Printf("No hightile replacements defined\n");
+		return;
+	}
+
+	cycle_t linear, hashed, uncached, cached;
+	linear.Reset();
+	hashed.Reset();
+	uncached.Reset();
+	cached.Reset();
+	int found = 0;
+
+	linear.Clock();
+	for (int i = 0; i < count; i++)
+		for (auto& s : samples) found += FindReplacementLinear(s.texid, s.palnum, false) != nullptr;
+	linear.Unclock();
+
+	hashed.Clock();
+	for (int i = 0; i < count; i++)
+		for (auto& s : samples) found -= FindReplacement(s.texid, s.palnum, false) != nullptr;
+	hashed.Unclock();
+
+	auto state = screen->RenderState();
+	auto bind = [&](cycle_t& timer)
+	{
+		timer.Clock();
+		for (int i = 0; i < count; i++)
+		{
+			for (auto& s : samples)
+			{
+				auto tex = TexMan.GetGameTexture(s.texid);
+				EUpscaleFlags flags = UF_Texture;
+				int scaleflags = 0, clampmode = 0, overrideshader = -1;
+				int translation = TRANSLATION(Translation_Remap + curbasepal, s.palnum);
+				PreBindTexture(state, tex, flags, scaleflags, clampmode, translation, overrideshader);
+			}
+		}
+		timer.Unclock();
+	};
+	pickCacheEnabled = false;
+	bind(uncached);
+	pickCacheEnabled = true;
+	bind(cached);
+
+	double n = double(count) * samples.Size();
+	Printf("%u replacements, %d iterations%s\n", samples.Size(), count, found ? " (lookup mismatch!)" : "");
+	Printf("lookup: list %.1f ns, table %.1f ns\n", linear.TimeMS() * 1e6 / n, hashed.TimeMS() * 1e6 / n);
+	Printf("PreBindTexture: uncached %.1f ns, cached %.1f ns\n", uncached.TimeMS() * 1e6 / n, cached.TimeMS() * 1e6 / n);
+}
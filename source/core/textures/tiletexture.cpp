@@ -58,26 +58,57 @@ public:
 //==========================================================================
 //
 // A tile coming from an ART file.
+// The pixels only get read from the file when they are first needed.
+// They are kept in the texture manager's tile data store, because image
+// sources live in an arena that never runs their destructors.
 //
 //==========================================================================
 
 class FArtTile : public FTileTexture
 {
-	const TArray<uint8_t>& RawPixels;
+	uint8_t* RawPixels = nullptr;
+	const int Lump;
 	const uint32_t Offset;
+
+	void LoadPixels();
+
 public:
-	FArtTile(const TArray<uint8_t>& backingstore, uint32_t offset, int width, int height) noexcept
-		: RawPixels(backingstore), Offset(offset)
+	FArtTile(int lump, uint32_t offset, int width, int height) noexcept
+		: Lump(lump), Offset(offset)
 	{
 		Width = width;
 		Height = height;
 	}
 	uint8_t* GetRawData() override final
 	{
-		return &RawPixels[Offset];
+		if (RawPixels == nullptr) LoadPixels();
+		return RawPixels;
 	}
 };
 
+void FArtTile::LoadPixels()
+{
+	const int size = Width * Height;
+	auto& store = TexMan.GetNewBuildTileData();
+	store.Resize(size);
+	RawPixels = store.Data();
+
+	auto fr = fileSystem.OpenFileReader(Lump);
+	if (!fr.isOpen() || fr.Seek(Offset, FileReader::SeekSet) < 0 || fr.Read(RawPixels, size) != size)
+	{
+		// truncated file - treat the missing part as transparent.
+		memset(RawPixels, 0, size);
+		return;
+	}
+
+	for (auto& p : store)
+	{
+		// move transparent color to index 0 to get in line with the rest of the texture management.
+		if (p == 0) p = 255;
+		else if (p == 255) p = 0;
+	}
+}
+
 //==========================================================================
 //
 // A non-existent tile
@@ -121,6 +152,11 @@ public:
 		return buffer.Data();
 	}
 
+	virtual uint8_t* GetWritableData()
+	{
+		return buffer.Data();
+	}
+
 	bool ResizeImage(int w, int h)
 	{
 		if (w <= 0 || h <= 0)
@@ -143,7 +179,8 @@ public:
 
 //==========================================================================
 //
-// A tile with a writable surface
+// A writable copy of another tile. The copy only gets made when the pixels
+// are first written to, until then the original tile's pixels are used.
 //
 //==========================================================================
 
@@ -155,10 +192,24 @@ public:
 	FRestorableTile(FImageSource* base)
 	{
 		Base = base;
-
 		CopySize(*base);
-		ResizeImage(Width, Height);
-		Reload();
+	}
+
+	uint8_t* GetRawData() override
+	{
+		if (buffer.Size() == 0)
+		{
+			auto tile = dynamic_cast<FTileTexture*>(Base);
+			if (tile) return tile->GetRawData();
+			Reload();
+		}
+		return buffer.Data();
+	}
+
+	uint8_t* GetWritableData() override
+	{
+		if (buffer.Size() == 0) Reload();
+		return buffer.Data();
 	}
 
 	void Reload() override
@@ -288,7 +339,7 @@ uint8_t* GetWritablePixels(FTextureID texid, bool reload)
 		timg->Reload();
 
 	gtex->CleanHardwareData();	// we can safely assume that this only gets called when the texture is about to be changed.
-	return timg->GetRawData();
+	return timg->GetWritableData();
 }
 
 
@@ -298,7 +349,7 @@ uint8_t* GetWritablePixels(FTextureID texid, bool reload)
 //
 //==========================================================================
 
-static FImageSource* GetTileImage(const TArray<uint8_t>& backingstore, uint32_t offset, int width, int height, TArray<void*> freelist)
+static FImageSource* GetTileImage(int lump, uint32_t offset, int width, int height, TArray<void*> freelist)
 {
 	FImageSource* tex;
 
@@ -308,20 +359,29 @@ static FImageSource* GetTileImage(const TArray<uint8_t>& backingstore, uint32_t
 	if (mem)
 	{
 		memset(mem, 0, sizeof(FArtTile));
-		tex = new(mem) FArtTile(backingstore, offset, width, height);
-	}
-	else tex = new FArtTile(backingstore, offset, width, height);
-	auto p = &backingstore[offset];
-	auto siz = width * height;
-	for (int i = 0; i < siz; i++, p++)
-	{
-		// move transparent color to index 0 to get in line with the rest of the texture management.
-		if (*p == 0) *p = 255;
-		else if (*p == 255) *p = 0;
+		tex = new(mem) FArtTile(lump, offset, width, height);
 	}
+	else tex = new FArtTile(lump, offset, width, height);
 	return tex;
 }
 
+//===========================================================================
+//
+// Only the headers of the ART files are kept in memory. The tiles read
+// their pixels from the file on demand so that the memory being used
+// depends on how many tiles actually get used.
+//
+//===========================================================================
+
+struct FArtFile
+{
+	int Lump;
+	uint32_t Base;	// start of the header, i.e. after the optional "BUILDART" signature.
+	TArray<uint8_t> Header;	// header, tile sizes and picanm.
+};
+
+static TArray<FArtFile> ArtFiles;
+
 //===========================================================================
 //
 // Creates image sources for all valid tiles in one ART file.
@@ -330,16 +390,17 @@ static FImageSource* GetTileImage(const TArray<uint8_t>& backingstore, uint32_t
 //
 //===========================================================================
 
-static void GetImagesFromFile(TArray<FImageSource*>& array, TArray<unsigned>& picanmarray, TArray<void*> freelist, TArray<uint8_t>& RawData)
+static void GetImagesFromFile(TArray<FImageSource*>& array, TArray<unsigned>& picanmarray, TArray<void*> freelist, const FArtFile& file)
 {
-	const uint8_t* tiles = RawData.Data();
+	const uint8_t* tiles = file.Header.Data();
 	//	int numtiles = LittleLong(((uint32_t *)tiles)[1]);	// This value is not reliable
 	unsigned tilestart = LittleLong(((unsigned*)tiles)[2]);
 	unsigned tileend = LittleLong(((unsigned*)tiles)[3]);
 	const uint16_t* tilesizx = &((const uint16_t*)tiles)[8];
 	const uint16_t* tilesizy = &tilesizx[tileend - tilestart + 1];
 	const uint32_t* picanmraw = (const uint32_t*)&tilesizy[tileend - tilestart + 1];
-	const uint8_t* tiledata = (const uint8_t*)&picanmraw[tileend - tilestart + 1];
+	// The pixel data is not part of the header, so only keep track of its offset in the file.
+	uint32_t tiledata = 16 + 8 * (tileend - tilestart + 1);
 
 	unsigned oldsize = array.Size();
 	if (array.Size() < tileend + 1)
@@ -381,7 +442,7 @@ static void GetImagesFromFile(TArray<FImageSource*>& array, TArray<unsigned>& pi
 		}
 
 		FString texname;
-		auto tex = GetTileImage(RawData, uint32_t(tiledata - tiles), width, height, freelist);
+		auto tex = GetTileImage(file.Lump, file.Base + tiledata, width, height, freelist);
 		int leftoffset = (int8_t)((anm >> 8) & 255);
 		int topoffset = (int8_t)((anm >> 16) & 255);
 		tex->SetOffsets(leftoffset, topoffset);
@@ -426,34 +487,42 @@ int CountTiles(const char* fn, const uint8_t* RawData)
 
 //===========================================================================
 //
-// LoadArtFile
-//
-// Returns the number of tiles found.
+// AddArtFile
 //
-// let's load everything into memory on startup.
+// Reads the header and the tile tables of an ART file.
+// The pixel data is left in the file until a tile needs it.
 //
 //===========================================================================
 
 static void AddArtFile(const FString& filename)
 {
-	FileReader fr = fileSystem.OpenFileReader(filename);
-	if (fr.isOpen())
+	int lump = fileSystem.CheckNumForFullName(filename);
+	if (lump < 0) return;
+	FileReader fr = fileSystem.OpenFileReader(lump);
+	if (!fr.isOpen()) return;
+
+	FArtFile art;
+	art.Lump = lump;
+	art.Base = 0;
+	art.Header.Resize(16);
+
+	if (fr.Read(art.Header.Data(), 16) != 16) return;
+	if (memcmp(art.Header.Data(), "BUILDART", 8) == 0)
 	{
-		auto artdata = fr.Read();
-		if (artdata.Size() > 16)
-		{
-			if (memcmp(artdata.Data(), "BUILDART", 8) == 0)
-			{
-				artdata.Delete(0, 8);
-			}
-			// Only load the data if the header is present
-			if (CountTiles(filename, artdata.Data()) > 0)
-			{
-				// The texture manager already has a store for Build ART files, so let's use it. :)
-				auto& store = TexMan.GetNewBuildTileData();
-				store = std::move(artdata);
-			}
-		}
+		art.Base = 8;
+		memmove(art.Header.Data(), art.Header.Data() + 8, 8);
+		if (fr.Read(art.Header.Data() + 8, 8) != 8) return;
+	}
+
+	// Only load the data if the header is present
+	int numtiles = CountTiles(filename, art.Header.Data());
+	if (numtiles > 0)
+	{
+		// tile sizes and picanm
+		int tablesize = numtiles * 8;
+		art.Header.Resize(16 + tablesize);
+		if (fr.Read(art.Header.Data() + 16, tablesize) != tablesize) return;
+		ArtFiles.Push(std::move(art));
 	}
 }
 
@@ -467,6 +536,7 @@ void InitArtFiles(TArray<FString>& addedArt)
 {
 	const int MAXARTFILES_BASE = 200;
 
+	ArtFiles.Clear();
 	for (int index = 0; index < MAXARTFILES_BASE; index++)
 	{
 		FStringf fn("tiles%03d.art", index);
@@ -487,7 +557,7 @@ void InitArtFiles(TArray<FString>& addedArt)
 void GetArtImages(TArray<FImageSource*>& array, TArray<unsigned>& picanm)
 {
 	TArray<void*> freelist;
-	for (auto& f : TexMan.GetBuildTileDataStore())
+	for (auto& f : ArtFiles)
 	{
 		GetImagesFromFile(array, picanm, freelist, f);
 	}
@@ -41,6 +41,7 @@
 #include "texinfo.h"
 
 #include "buildtiles.h"
+#include "walltags.h"
 
 sectortype* Raze_updatesector(double x, double y, sectortype* sec, double dist)
 {
@@ -574,6 +575,36 @@ DEFINE_ACTION_FUNCTION_NATIVE(_walltype, setxpan, wall_setxpan)
 	return 0;
 }
 
+void wall_setlotag(walltype* wal, int tag)
+{
+	if (!wal) ThrowAbortException(X_READ_NIL, nullptr);
+	wal->lotag = tag;
+	wallTagChanged(wal);
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(_walltype, setlotag, wall_setlotag)
+{
+	PARAM_SELF_STRUCT_PROLOGUE(walltype);
+	PARAM_INT(tag);
+	wall_setlotag(self, tag);
+	return 0;
+}
+
+void wall_sethitag(walltype* wal, int tag)
+{
+	if (!wal) ThrowAbortException(X_READ_NIL, nullptr);
+	wal->hitag = tag;
+	wallTagChanged(wal);
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(_walltype, sethitag, wall_sethitag)
+{
+	PARAM_SELF_STRUCT_PROLOGUE(walltype);
+	PARAM_INT(tag);
+	wall_sethitag(self, tag);
+	return 0;
+}
+
 void wall_addxpan(walltype* wal, double val)
 {
 	if (!wal) ThrowAbortException(X_READ_NIL, nullptr);
@@ -805,7 +836,7 @@ void tspritetype_setSpritePic(tspritetype* targ, DCoreActor* self, unsigned z)
 	}
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(_tspritetype, setSpritePic, tspritetype_setSpritePic)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(_tspritetype, setSpritePic, tspritetype_setSpritePic)
 {
 	PARAM_SELF_STRUCT_PROLOGUE(tspritetype);
 	PARAM_OBJECT(owner, DCoreActor);
@@ -954,7 +985,7 @@ static double deltaangleDbl(double a1, double a2)
 	return deltaangle(DAngle::fromDeg(a1), DAngle::fromDeg(a2)).Degrees();
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(DCoreActor, deltaangle, deltaangleDbl)	// should this be global?
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(DCoreActor, deltaangle, deltaangleDbl)	// should this be global?
 {
 	PARAM_PROLOGUE;
 	PARAM_FLOAT(a1);
@@ -967,7 +998,7 @@ static double absangleDbl(double a1, double a2)
 	return absangle(DAngle::fromDeg(a1), DAngle::fromDeg(a2)).Degrees();
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(DCoreActor, absangle, absangleDbl)	// should this be global?
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(DCoreActor, absangle, absangleDbl)	// should this be global?
 {
 	PARAM_PROLOGUE;
 	PARAM_FLOAT(a1);
@@ -980,7 +1011,7 @@ static double Normalize180(double angle)
 	return DAngle::fromDeg(angle).Normalized180().Degrees();
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(DCoreActor, Normalize180, Normalize180)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(DCoreActor, Normalize180, Normalize180)
 {
 	PARAM_PROLOGUE;
 	PARAM_ANGLE(angle);
@@ -0,0 +1,141 @@
+/*
+** walltags.cpp
+** Lookup of walls by lotag or hitag
+**
+**---------------------------------------------------------------------------
+**---------------------------------------------------------------------------
+** Copyright 2026 Raze Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** Every bucket is kept sorted by wall index so that iterating one visits
+** the walls in the same order a scan of the wall array would. This matters
+** for the callers which spawn actors or use the random number generator.
+**
+*/
+
+#include "walltags.h"
+#include "gamefuncs.h"
+
+static TMap<unsigned, TArray<int>> wallTags;
+static bool wallTagsValid;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static unsigned tagKey(int tag, bool hitag)
+{
+	return (uint16_t)tag | (hitag ? 0x10000u : 0u);
+}
+
+// returns the position of the first entry that is not smaller than index.
+static unsigned lowerBound(const TArray<int>& list, int index)
+{
+	unsigned lo = 0, hi = list.Size();
+	while (lo < hi)
+	{
+		unsigned mid = (lo + hi) / 2;
+		if (list[mid] < index) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static void buildWallTagIndex()
+{
+	wallTags.Clear();
+	for (unsigned i = 0; i < wall.Size(); i++)
+	{
+		wallTags[tagKey(wall[i].lotag, false)].Push(i);
+		wallTags[tagKey(wall[i].hitag, true)].Push(i);
+	}
+	wallTagsValid = true;
+}
+
+static void addToBucket(unsigned key, int index)
+{
+	auto& list = wallTags[key];
+	unsigned pos = lowerBound(list, index);
+	if (pos == list.Size() || list[pos] != index)
+		list.Insert(pos, index);
+}
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+void clearWallTagIndex()
+{
+	wallTags.Clear();
+	wallTagsValid = false;
+}
+
+void wallTagChanged(walltype* wal)
+{
+	if (!wallTagsValid) return;
+	int index = wallindex(wal);
+	addToBucket(tagKey(wal->lotag, false), index);
+	addToBucket(tagKey(wal->hitag, true), index);
+}
+
+//==========================================================================
+//
+// The bucket gets looked up again on each step because wallTagChanged
+// may add new ones in between.
+//
+//==========================================================================
+
+WallTagIterator::WallTagIterator(int tag_, bool hitag_)
+{
+	key = tagKey(tag_, hitag_);
+	tag = tag_;
+	hitag = hitag_;
+	if (!wallTagsValid) buildWallTagIndex();
+}
+
+walltype* WallTagIterator::Next()
+{
+	auto list = wallTags.CheckKey(key);
+	if (list == nullptr) return nullptr;
+
+	for (unsigned pos = lowerBound(*list, last + 1); pos < list->Size(); pos++)
+	{
+		int index = (*list)[pos];
+		auto wal = &wall[index];
+		if ((hitag ? wal->hitag : wal->lotag) == tag)
+		{
+			last = index;
+			return wal;
+		}
+	}
+	last = INT_MAX - 1;
+	return nullptr;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "maptypes.h"
+
+// Lookup of walls by tag.
+//
+// Switches and tag triggered wall breaking need all walls with a given tag,
+// which without this means scanning the entire wall array on every use.
+// The index gets built on first use after a map was loaded. Code that
+// changes a wall's tags afterward must call wallTagChanged so that the wall
+// will also be found under its new tag. Entries for tags a wall no longer
+// has are skipped, so a change may be reported while iterating.
+
+void clearWallTagIndex();
+void wallTagChanged(walltype* wal);
+
+class WallTagIterator
+{
+	unsigned key;
+	int tag;
+	int last = -1;
+	bool hitag;
+
+public:
+	WallTagIterator(int tag, bool hitag = false);
+	walltype* Next();
+};
@@ -80,7 +80,7 @@ void InitServices();
 
 void LoadScripts()
 {
-	cycle_t timer;
+	cycle_t timer, codegentimer;
 
 	PType::StaticInit();
 	SetRazeCompileEnvironment();
@@ -92,7 +92,9 @@ void LoadScripts()
 	ParseScripts();
 	SynthesizeFlagFields();
 
+	codegentimer.Reset(); codegentimer.Clock();
 	FunctionBuildList.Build();
+	codegentimer.Unclock();
 
 	if (FScriptPosition::ErrorCounter > 0)
 	{
@@ -101,7 +103,7 @@ void LoadScripts()
 	FScriptPosition::ResetErrorCounter();
 
 	timer.Unclock();
-	if (!batchrun) Printf("script parsing took %.2f ms\n", timer.TimeMS());
+	if (!batchrun) Printf("script parsing took %.2f ms (%.2f ms for code generation)\n", timer.TimeMS(), codegentimer.TimeMS());
 
 	for (int i = PClass::AllClasses.Size() - 1; i >= 0; i--)
 	{
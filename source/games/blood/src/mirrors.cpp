@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "blood.h" 
 #include "render.h"
+#include "walltags.h"
 
 BEGIN_BLD_NS
 
@@ -71,6 +72,8 @@ void InitMirrors(void)
 							continue;
 						pWalli->hitag = j; // hitag is only used by Polymost, the new renderer uses external links.
 						pWallj->hitag = i;
+						wallTagChanged(pWalli);
+						wallTagChanged(pWallj);
 						mirror[mirrorcnt].link = j;
 						break;
 					}
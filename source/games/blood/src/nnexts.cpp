@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <random>
 #include "blood.h"
 #include "savegamehelp.h"
+#include "walltags.h"
 
 BEGIN_BLD_NS
 
@@ -2534,6 +2535,7 @@ void usePropertiesChanger(DBloodActor* sourceactor, int objType, sectortype* pSe
 				pWall->hitag |= sourceactor->xspr.data3;
 			}
 			else pWall->hitag = sourceactor->xspr.data3;
+			wallTagChanged(pWall);
 		}
 
 		// data4 = set wall cstat
@@ -1092,7 +1092,7 @@ void hitradius(DDukeActor* actor, int  r, int  hp1, int  hp2, int  hp3, int  hp4
 	auto Owner = actor->GetOwner();
 	for (int x = 0; x < 7; x++)
 	{
-		DukeStatIterator itj(statlist[x]);
+		TRadiusIterator<DDukeActor> itj(actor->spr.pos.XY(), radius, statlist[x]);
 		while (auto act2 = itj.Next())
 		{
 			if (Owner)
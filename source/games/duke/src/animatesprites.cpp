@@ -33,6 +33,10 @@ Prepared for public release: 03/21/2003 - Charlie Wiederhold, 3D Realms
 #include "models/modeldata.h"
 
 #include "buildtiles.h"
+#include "hw_spritepass.h"
+#include "vm.h"
+
+EXTERN_CVAR(Bool, r_parallelsprites)
 
 BEGIN_DUKE_NS
 
@@ -216,4 +220,51 @@ void applyanimations(tspritetype* t, DDukeActor* h, const DVector2& viewVec, DAn
 			t->cstat |= CSTAT_SPRITE_XFLIP;
 	}
 }
+
+//---------------------------------------------------------------------------
+//
+// Does the interpolation and animate() call of every tsprite in front of the
+// first effector up front, as long as its animate() may run on a worker thread.
+// results gets the return value for those and -1 for everything that still
+// needs to be done by the serial loop. Without r_parallelsprites nothing is
+// done here so that the serial loop keeps the original call order. Players
+// always stay in the serial loop because RR modifies their actor's scale.
+//
+//---------------------------------------------------------------------------
+
+void preanimatesprites(tspriteArray& tsprites, TArray<int8_t>& results, const std::function<void(tspritetype*, DDukeActor*)>& interpolate)
+{
+	unsigned count = tsprites.Size();
+	results.Resize(count);
+	for (auto& r : results) r = -1;
+	if (!r_parallelsprites) return;
+
+	TArray<VMFunction*> funcs(count, true);
+
+	unsigned end = 0;
+	for (; end < count; end++)
+	{
+		auto t = tsprites.get(end);
+		auto h = static_cast<DDukeActor*>(t->ownerActor);
+		if (iseffector(h)) break;
+		if (t->statnum == STAT_TEMP || h->isPlayer()) continue;
+
+		auto func = GetAnimateFunc(h);
+		if (func == nullptr || VMCheckThreadSafe(func))
+		{
+			funcs[end] = func;
+			results[end] = 0;
+		}
+	}
+
+	RunSpritePass(end, [&](unsigned j)
+	{
+		if (results[j] < 0) return;
+		auto t = tsprites.get(j);
+		auto h = static_cast<DDukeActor*>(t->ownerActor);
+		interpolate(t, h);
+		results[j] = CallAnimate(funcs[j], h, t);
+	});
+}
+
 END_DUKE_NS
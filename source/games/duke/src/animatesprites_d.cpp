@@ -68,6 +68,18 @@ void animatesprites_d(tspriteArray& tsprites, const DVector2& viewVec, DAngle vi
 			t->shade = clamp<int>(t->sectp->ceilingstat & CSTAT_SECTOR_SKY ? t->sectp->ceilingshade : t->sectp->floorshade, -127, 127);
 	}
 
+	auto interpolate = [=](tspritetype* t, DDukeActor* h)
+	{
+		auto pp = &ps[h->PlayerIndex()];
+		if ((h->spr.statnum != STAT_ACTOR && h->isPlayer() && pp->newOwner == nullptr && h->GetOwner()) || !(h->flags1 & SFLAG_NOINTERPOLATE))
+		{
+			t->pos = h->interpolatedpos(interpfrac);
+			t->Angles.Yaw = h->interpolatedyaw(interpfrac);
+		}
+	};
+
+	TArray<int8_t> animres;
+	preanimatesprites(tsprites, animres, interpolate);
 
 	//Between drawrooms() and drawmasks() is the perfect time to animate sprites
 	for (unsigned j = 0; j < tsprites.Size(); j++)  
@@ -90,16 +102,16 @@ void animatesprites_d(tspriteArray& tsprites, const DVector2& viewVec, DAngle vi
 		}
 
 		if (t->statnum == STAT_TEMP) continue;
-		auto pp = &ps[h->PlayerIndex()];
-		if ((h->spr.statnum != STAT_ACTOR && h->isPlayer() && pp->newOwner == nullptr && h->GetOwner()) || !(h->flags1 & SFLAG_NOINTERPOLATE))
-		{
-			t->pos = h->interpolatedpos(interpfrac);
-			t->Angles.Yaw = h->interpolatedyaw(interpfrac);
-		}
-
 
 		auto sectp = h->sector();
-		bool res = CallAnimate(h, t);
+		bool res;
+		if (j < animres.Size() && animres[j] >= 0)
+			res = animres[j];
+		else
+		{
+			interpolate(t, h);
+			res = CallAnimate(h, t);
+		}
 		// some actors have 4, some 6 rotation frames - in true Build fashion there's no pointers what to do here without flagging it.
 		if ((h->flags2 & SFLAG2_ALWAYSROTATE1) || (t->clipdist & TSPR_ROTATE8FRAMES))
 			applyRotation1(h, t, viewang);
@@ -108,6 +108,8 @@ bool CallOnUse(DDukeActor* actor, player_struct* user);
 void CallOnMotoSmash(DDukeActor* actor, player_struct* hitter);
 void CallOnRespawn(DDukeActor* actor, int low);
 bool CallAnimate(DDukeActor* actor, tspritetype* hitter);
+bool CallAnimate(VMFunction* func, DDukeActor* actor, tspritetype* tspr);
+VMFunction* GetAnimateFunc(DDukeActor* actor);
 bool CallShootThis(DDukeActor* clsdef, DDukeActor* actor, int pn, const DVector3& spos, DAngle sang);
 void CallStaticSetup(DDukeActor* actor);
 void CallPlayFTASound(DDukeActor* actor, int mode = 0);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include "screenjob.h"
 #include "constants.h"
 #include "packet.h"
@@ -244,6 +245,7 @@ bool checkhitswitch(int snum, walltype* wwal, DDukeActor* act);
 
 void drawshadows(tspriteArray& tsprites, tspritetype* t, DDukeActor* h);
 void applyanimations(tspritetype* t, DDukeActor* h, const DVector2& viewVec, DAngle viewang);
+void preanimatesprites(tspriteArray& tsprites, TArray<int8_t>& results, const std::function<void(tspritetype*, DDukeActor*)>& interpolate);
 
 int LookupAction(PClass* self, FName name);
 int LookupMove(PClass* self, FName name);
@@ -683,10 +683,20 @@ void CallOnRespawn(DDukeActor* actor, int low)
 	}
 }
 
-bool CallAnimate(DDukeActor* actor, tspritetype* tspr)
+VMFunction* GetAnimateFunc(DDukeActor* actor)
 {
-	int nval = false;
 	IFVIRTUALPTR(actor, DDukeActor, animate)
+	{
+		return func;
+	}
+	return nullptr;
+}
+
+// This version gets called from worker threads, so it may not look up the function itself.
+bool CallAnimate(VMFunction* func, DDukeActor* actor, tspritetype* tspr)
+{
+	int nval = false;
+	if (func != nullptr)
 	{
 		VMReturn ret(& nval);
 		VMValue val[2] = { actor, tspr };
@@ -695,6 +705,11 @@ bool CallAnimate(DDukeActor* actor, tspritetype* tspr)
 	return nval;
 }
 
+bool CallAnimate(DDukeActor* actor, tspritetype* tspr)
+{
+	return CallAnimate(GetAnimateFunc(actor), actor, tspr);
+}
+
 void CallStaticSetup(DDukeActor* actor)
 {
 	IFVIRTUALPTR(actor, DDukeActor, StaticSetup)
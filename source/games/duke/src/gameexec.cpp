@@ -40,6 +40,7 @@ source as it is released.
 #include "conlabel.h"
 #include "automap.h"
 #include "dukeactor.h"
+#include "walltags.h"
 
 BEGIN_DUKE_NS
 
@@ -969,11 +970,19 @@ void DoWall(bool bSet, int lVar1, int lLabelID, int lVar2, DDukeActor* sActor, i
 		else SetGameVarID(lVar2, wallp->ypan(), sActor, sPlayer);
 		break;
 	case WALL_LOTAG:
-		if (bSet) wallp->lotag = lValue;
+		if (bSet)
+		{
+			wallp->lotag = lValue;
+			wallTagChanged(wallp);
+		}
 		else SetGameVarID(lVar2, wallp->lotag, sActor, sPlayer);
 		break;
 	case WALL_HITAG:
-		if (bSet) wallp->hitag = lValue;
+		if (bSet)
+		{
+			wallp->hitag = lValue;
+			wallTagChanged(wallp);
+		}
 		else SetGameVarID(lVar2, wallp->hitag, sActor, sPlayer);
 		break;
 	case WALL_EXTRA:
@@ -38,6 +38,7 @@ source as it is released.
 #include "sounds.h"
 #include "dukeactor.h"
 #include "interpolate.h"
+#include "walltags.h"
 
 // PRIMITIVE
 BEGIN_DUKE_NS
@@ -1257,7 +1258,10 @@ void operateforcefields(DDukeActor *effector, int low)
 					wal->cstat = 0;
 
 					if (effector && iseffector(effector) && effector->spr.lotag == SE_30_TWO_WAY_TRAIN)
+					{
 						wal->lotag = 0;
+						wallTagChanged(wal);
+					}
 				}
 				else
 					wal->cstat = (CSTAT_WALL_BLOCK | CSTAT_WALL_ALIGN_BOTTOM | CSTAT_WALL_MASKED | CSTAT_WALL_BLOCK_HITSCAN);
@@ -1680,11 +1684,10 @@ void togglespriteswitches(DDukeActor* act, const TexExtInfo& ext, int lotag, int
 
 void togglewallswitches(walltype* wwal, const TexExtInfo& ext, int lotag, int& correctdips, int& numdips)
 {
-	for (auto& wal : wall)
+	WallTagIterator it(lotag);
+	while (auto wal = it.Next())
 	{
-		if (lotag != wal.lotag) continue;
-
-		auto& other_ext = GetExtInfo(wal.walltexture);
+		auto& other_ext = GetExtInfo(wal->walltexture);
 		auto& other_swdef = switches[other_ext.switchindex];
 
 		switch (other_swdef.type)
@@ -1692,25 +1695,25 @@ void togglewallswitches(walltype* wwal, const TexExtInfo& ext, int lotag, int& c
 		case SwitchDef::Combo:
 			if (other_ext.switchphase == 0)
 			{
-				if (&wal == wwal) wal.setwalltexture(other_swdef.states[1]);
-				else if (wal.hitag == 0) correctdips++;
+				if (wal == wwal) wal->setwalltexture(other_swdef.states[1]);
+				else if (wal->hitag == 0) correctdips++;
 				numdips++;
 			}
 			else
 			{
-				if (&wal == wwal) wal.setwalltexture(other_swdef.states[0]);
-				else if (wal.hitag == 1) correctdips++;
+				if (wal == wwal) wal->setwalltexture(other_swdef.states[0]);
+				else if (wal->hitag == 1) correctdips++;
 				numdips++;
 			}
 			break;
 
 		case SwitchDef::Multi:
-			wal.setwalltexture(other_swdef.states[(other_ext.switchphase + 1) & 3]);
+			wal->setwalltexture(other_swdef.states[(other_ext.switchphase + 1) & 3]);
 			break;
 
 		case SwitchDef::Access:
 		case SwitchDef::Regular:
-			wal.setwalltexture(other_swdef.states[1 - other_ext.switchphase]);
+			wal->setwalltexture(other_swdef.states[1 - other_ext.switchphase]);
 			break;
 		}
 	}
@@ -40,6 +40,7 @@ source as it is released.
 #include "dukeactor.h"
 #include "interpolate.h"
 #include "vm.h"
+#include "walltags.h"
 
 BEGIN_DUKE_NS
 
@@ -574,7 +575,11 @@ void spawneffector(DDukeActor* actor, TArray<DDukeActor*>* actors)
 			if (actor->spr.intangle != 1536) sectp->setfloorz(actor->spr.pos.Z);
 
 			for (auto& wal : sectp->walls)
-				if (wal.hitag == 0) wal.hitag = 9999;
+				if (wal.hitag == 0)
+				{
+					wal.hitag = 9999;
+					wallTagChanged(&wal);
+				}
 
 			StartInterpolation(sectp, Interp_Sect_Floorz);
 
@@ -585,7 +590,11 @@ void spawneffector(DDukeActor* actor, TArray<DDukeActor*>* actors)
 			if (actor->spr.intangle != 1536) sectp->setceilingz(actor->spr.pos.Z);
 
 			for (auto& wal : sectp->walls)
-				if (wal.hitag == 0) wal.hitag = 9999;
+				if (wal.hitag == 0)
+				{
+					wal.hitag = 9999;
+					wallTagChanged(&wal);
+				}
 
 			StartInterpolation(sectp, Interp_Sect_Ceilingz);
 
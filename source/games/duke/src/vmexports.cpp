@@ -1846,7 +1846,7 @@ void tspritetype_setWeaponOrAmmoSprite(tspritetype* targ, unsigned z)
 	}
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(_tspritetype, setWeaponOrAmmoSprite, tspritetype_setWeaponOrAmmoSprite)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(_tspritetype, setWeaponOrAmmoSprite, tspritetype_setWeaponOrAmmoSprite)
 {
 	PARAM_SELF_STRUCT_PROLOGUE(tspritetype);
 	PARAM_INT(z);
@@ -1854,7 +1854,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_tspritetype, setWeaponOrAmmoSprite, tspritetype_s
 	return 0;
 }
 
-DEFINE_ACTION_FUNCTION_NATIVE(_tspritetype, copyfloorpal, copyfloorpal)
+DEFINE_ACTION_FUNCTION_NATIVE_THREADSAFE(_tspritetype, copyfloorpal, copyfloorpal)
 {
 	PARAM_SELF_STRUCT_PROLOGUE(tspritetype);
 	PARAM_POINTER(s, sectortype);
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <string.h>
 #include "statusbar.h"
 #include "precache.h"
+#include "walltags.h"
 
 BEGIN_PS_NS
 
@@ -831,6 +832,7 @@ void LoadObjects(TArray<DExhumedActor*>& actors)
             wal.lotag = runlist_HeadRun() + 1;
             runlist_ProcessWallTag(&wal, lotag, hitag);
         }
+        wallTagChanged(&wal);
     }
 
     ExamineSprites(actors);
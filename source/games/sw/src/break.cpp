@@ -37,6 +37,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 
 #include "break.h"
 #include "buildtiles.h"
+#include "walltags.h"
 
 
 BEGIN_SW_NS
@@ -473,6 +474,7 @@ BREAK_INFO* SetupWallForBreak(walltype* wallp)
     {
         wallp->lotag = TAG_WALL_BREAK;
         wallp->extra |= (WALLFX_DONT_STICK);
+        wallTagChanged(wallp);
     }
 
     if (wallp->overtexture.isValid() && (wallp->cstat & CSTAT_WALL_MASKED))
@@ -482,6 +484,7 @@ BREAK_INFO* SetupWallForBreak(walltype* wallp)
         {
             wallp->lotag = TAG_WALL_BREAK;
             wallp->extra |= (WALLFX_DONT_STICK);
+            wallTagChanged(wallp);
         }
     }
 
@@ -560,6 +563,7 @@ int AutoBreakWall(walltype* wallp, const DVector3& hit_pos, DAngle ang, int type
     walltype* nwp;
 
     wallp->lotag = 0;
+    wallTagChanged(wallp);
     if (wallp->twoSided())
     {
         nwp = wallp->nextWall();
@@ -572,6 +576,7 @@ int AutoBreakWall(walltype* wallp, const DVector3& hit_pos, DAngle ang, int type
             (nwp->cstat & CSTAT_WALL_MASKED))
         {
             nwp->lotag = 0;
+            wallTagChanged(nwp);
         }
     }
 
@@ -668,8 +673,12 @@ bool UserBreakWall(walltype* wp)
 
         // clear tags
         wp->hitag = wp->lotag = 0;
+        wallTagChanged(wp);
         if (wp->twoSided())
+        {
             wp->nextWall()->hitag = wp->nextWall()->lotag = 0;
+            wallTagChanged(wp->nextWall());
+        }
         return true;
     }
 
@@ -687,8 +696,12 @@ bool UserBreakWall(walltype* wp)
             wp->setwalltexture(actor->texparam);
             // clear tags
             wp->hitag = wp->lotag = 0;
+            wallTagChanged(wp);
             if (wp->twoSided())
+            {
                 wp->nextWall()->hitag = wp->nextWall()->lotag = 0;
+                wallTagChanged(wp->nextWall());
+            }
             ret = false;
         }
         else if (SP_TAG8(actor) == 1)
@@ -699,8 +712,12 @@ bool UserBreakWall(walltype* wp)
                 wp->nextWall()->cstat &= ~(flags);
             // clear tags
             wp->hitag = wp->lotag = 0;
+            wallTagChanged(wp);
             if (wp->twoSided())
+            {
                 wp->nextWall()->hitag = wp->nextWall()->lotag = 0;
+                wallTagChanged(wp->nextWall());
+            }
 
             ret = true;
         }
@@ -716,8 +733,12 @@ bool UserBreakWall(walltype* wp)
 
             // clear tags
             wp->hitag = wp->lotag = 0;
+            wallTagChanged(wp);
             if (wp->twoSided())
+            {
                 wp->nextWall()->hitag = wp->nextWall()->lotag = 0;
+                wallTagChanged(wp->nextWall());
+            }
 
             ret = false;
         }
@@ -1069,15 +1090,14 @@ void DoWallBreakMatch(int match)
     DVector3 hitpos;
     DAngle wall_ang;
 
-    for(auto& wal : wall)
+    WallTagIterator it(match, true);
+    while (auto wal = it.Next())
     {
-        if (wal.hitag == match)
-        {
-            WallBreakPosition(&wal, &sect, hitpos, wall_ang);
+        WallBreakPosition(wal, &sect, hitpos, wall_ang);
 
-            wal.hitag = 0; // Reset the hitag
-            AutoBreakWall(&wal, hitpos, wall_ang, 0);
-        }
+        wal->hitag = 0; // Reset the hitag
+        wallTagChanged(wal);
+        AutoBreakWall(wal, hitpos, wall_ang, 0);
     }
 }
 
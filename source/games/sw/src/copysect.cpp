@@ -35,6 +35,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 #include "misc.h"
 #include "interpso.h"
 #include "render.h"
+#include "walltags.h"
 
 BEGIN_SW_NS
 
@@ -71,6 +72,7 @@ void CopySectorWalls(sectortype* dest_sect, sectortype* src_sect)
         dwall->hitag =         swall->hitag;
         dwall->lotag =         swall->lotag;
         dwall->extra =         swall->extra;
+        wallTagChanged(dwall);
 
         if (dwall->twoSided() && swall->twoSided())
         {
@@ -88,6 +90,7 @@ void CopySectorWalls(sectortype* dest_sect, sectortype* src_sect)
             dest_nextwall->hitag = src_nextwall->hitag;
             dest_nextwall->lotag = src_nextwall->lotag;
             dest_nextwall->extra = src_nextwall->extra;
+            wallTagChanged(dest_nextwall);
         }
 
         dwall = dwall->point2Wall();
@@ -43,6 +43,7 @@ Prepared for public release: 03/28/2005 - Charlie Wiederhold, 3D Realms
 #include "light.h"
 #include "gstrings.h"
 #include "secrets.h"
+#include "walltags.h"
 
 BEGIN_SW_NS
 
@@ -213,6 +214,7 @@ void WallSetup(void)
         {
             WallSetupLoop(&wal, TAG_WALL_LOOP_DONT_SCALE, WALLFX_DONT_SCALE);
             wal.lotag = 0;
+            wallTagChanged(&wal);
             break;
         }
 
@@ -242,6 +244,7 @@ void WallSetup(void)
                 Printf(PRINT_HIGH, "one-sided wall %d in loop setup\n", wallindex(&wal));
             }
             wal.lotag = 0;
+            wallTagChanged(&wal);
             break;
         }
 